@@ -34,6 +34,7 @@ BuildRequires:  pkgconfig(libsystemd-daemon)
 %define linear_accel_state ON
 %define motion_state OFF
 %define rv_state ON
+%define game_rv_state ON
 %define rv_raw_state OFF
 %define orientation_state ON
 %define pressure_state ON
@@ -84,7 +85,7 @@ cmake . -DCMAKE_INSTALL_PREFIX=%{_prefix} -DACCEL=%{accel_state} \
 	-DFLAT=%{flat_state} -DBIO=%{bio_state} -DBIO_HRM=%{bio_hrm_state} \
 	-DAUTO_ROTATION=%{auto_rotation_state} -DGRAVITY=%{gravity_state} \
 	-DLINEAR_ACCEL=%{linear_accel_state} -DMOTION=%{motion_state} \
-	-DRV=%{rv_state} -DPRESSURE=%{pressure_state} \
+	-DRV=%{rv_state} -DGAME_RV=%{game_rv_state} -DPRESSURE=%{pressure_state} \
 	-DORIENTATION=%{orientation_state} -DSENSOR_FUSION=%{sensor_fusion_state} \
 	-DPIR=%{pir_state} -DPIR_LONG=%{pir_long_state} \
 	-DTEMPERATURE=%{temperature_state} -DHUMIDITY=%{humidity_state} \
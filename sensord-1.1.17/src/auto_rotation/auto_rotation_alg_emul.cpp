@@ -23,6 +23,7 @@
 #include <auto_rotation_alg_emul.h>
 #include <stdlib.h>
 #include <math.h>
+#include <fast_math.h>
 
 #define ROTATION_RULE_CNT 4
 
@@ -103,10 +104,10 @@ bool auto_rotation_alg_emul::get_rotation(float acc[3],
 	y = acc[1];
 	z = acc[2];
 
-	atan_value = atan2(x, y);
+	atan_value = fast_atan2(x, y);
 	acc_theta = (int)(atan_value * (RADIAN) + 360) % 360;
-	realg = (double)sqrt((x * x) + (y * y) + (z * z));
-	acc_pitch = ROTATION_90 - abs((int) (asin(z / realg) * RADIAN));
+	realg = (double)fast_sqrt((x * x) + (y * y) + (z * z));
+	acc_pitch = ROTATION_90 - abs((int) (fast_asin(z / realg) * RADIAN));
 
 	cur_rotation = convert_rotation(prev_rotation, acc_pitch, acc_theta);
 
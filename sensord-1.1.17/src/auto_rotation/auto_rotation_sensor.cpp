@@ -49,7 +49,8 @@ auto_rotation_sensor::auto_rotation_sensor()
 {
 	m_name = string(SENSOR_NAME);
 
-	register_supported_event(AUTO_ROTATION_EVENT_CHANGE_STATE);
+	register_on_change_event(AUTO_ROTATION_EVENT_CHANGE_STATE);
+	register_input_event(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
 }
 
 auto_rotation_sensor::~auto_rotation_sensor()
@@ -32,7 +32,7 @@ bio_hrm_phy_sensor::bio_hrm_phy_sensor()
 {
 	m_name = string(SENSOR_NAME);
 
-	register_supported_event(BIO_HRM_EVENT_CHANGE_STATE);
+	register_on_change_event(BIO_HRM_EVENT_CHANGE_STATE);
 
 	physical_sensor::set_poller(bio_hrm_phy_sensor::working, this);
 }
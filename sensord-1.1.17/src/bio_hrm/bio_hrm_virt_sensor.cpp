@@ -49,7 +49,9 @@ bio_hrm_virt_sensor::bio_hrm_virt_sensor()
 {
 	m_name = string(SENSOR_NAME);
 
-	register_supported_event(BIO_HRM_EVENT_CHANGE_STATE);
+	register_on_change_event(BIO_HRM_EVENT_CHANGE_STATE);
+	register_input_event(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
+	register_input_event(BIO_EVENT_RAW_DATA_REPORT_ON_TIME);
 
 	reset();
 }
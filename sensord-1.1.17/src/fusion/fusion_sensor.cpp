@@ -0,0 +1,590 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <sys/types.h>
+#include <dlfcn.h>
+#include <common.h>
+#include <sf_common.h>
+#include <fusion_sensor.h>
+#include <sensor_plugin_loader.h>
+#include <cvirtual_sensor_config.h>
+
+#define SENSOR_NAME "FUSION_SENSOR"
+#define SENSOR_TYPE_FUSION		"FUSION"
+
+#define ACCELEROMETER_ENABLED 0x01
+#define GYROSCOPE_ENABLED 0x02
+#define GEOMAGNETIC_ENABLED 0x04
+#define FUSION_ENABLED 7
+
+#define MS_TO_US 1000
+
+#define ELEMENT_VENDOR											"VENDOR"
+#define ELEMENT_DEFAULT_SAMPLING_TIME							"DEFAULT_SAMPLING_TIME"
+#define ELEMENT_MIN_SAMPLING_TIME								"MIN_SAMPLING_TIME"
+#define ELEMENT_ACCEL_STATIC_BIAS								"ACCEL_STATIC_BIAS"
+#define ELEMENT_GYRO_STATIC_BIAS								"GYRO_STATIC_BIAS"
+#define ELEMENT_GEOMAGNETIC_STATIC_BIAS							"GEOMAGNETIC_STATIC_BIAS"
+#define ELEMENT_ACCEL_ROTATION_DIRECTION_COMPENSATION			"ACCEL_ROTATION_DIRECTION_COMPENSATION"
+#define ELEMENT_GYRO_ROTATION_DIRECTION_COMPENSATION			"GYRO_ROTATION_DIRECTION_COMPENSATION"
+#define ELEMENT_GEOMAGNETIC_ROTATION_DIRECTION_COMPENSATION		"GEOMAGNETIC_ROTATION_DIRECTION_COMPENSATION"
+#define ELEMENT_ACCEL_SCALE										"ACCEL_SCALE"
+#define ELEMENT_GYRO_SCALE										"GYRO_SCALE"
+#define ELEMENT_GEOMAGNETIC_SCALE								"GEOMAGNETIC_SCALE"
+#define ELEMENT_MAGNETIC_ALIGNMENT_FACTOR						"MAGNETIC_ALIGNMENT_FACTOR"
+#define ELEMENT_COVARIANCE_WINDOW_LENGTH						"COVARIANCE_WINDOW_LENGTH"
+#define ELEMENT_FUSION_ENGINE									"FUSION_ENGINE"
+#define ELEMENT_MAHONY_GAINS									"MAHONY_GAINS"
+#define ELEMENT_FUSION_UPDATE_MODE								"FUSION_UPDATE_MODE"
+
+#define FUSION_ENGINE_NAME_KALMAN	"KALMAN"
+#define FUSION_ENGINE_NAME_MAHONY	"MAHONY"
+#define FUSION_ENGINE_NAME_MAHONY_FIXED	"MAHONY_FIXED"
+
+#define FUSION_UPDATE_MODE_NAME_SYNC	"SYNC"
+#define FUSION_UPDATE_MODE_NAME_ASYNC	"ASYNC"
+
+void pre_process_data(sensor_data<float> &data_out, const float *data_in, float *bias, int *sign, float scale)
+{
+	data_out.m_data.m_vec[0] = sign[0] * (data_in[0] - bias[0]) / scale;
+	data_out.m_data.m_vec[1] = sign[1] * (data_in[1] - bias[1]) / scale;
+	data_out.m_data.m_vec[2] = sign[2] * (data_in[2] - bias[2]) / scale;
+}
+
+fusion_sensor::fusion_sensor()
+: m_accel_sensor(NULL)
+, m_gyro_sensor(NULL)
+, m_magnetic_sensor(NULL)
+, m_enable_fusion(0)
+, m_aiding_changed(false)
+, m_data_ready(false)
+, m_time(0)
+, m_input_interval(0)
+, m_inputs_started(false)
+, m_min_sampling_time(0)
+, m_covariance_window_length(MOVING_AVERAGE_WINDOW_LENGTH)
+, m_engine(FUSION_ENGINE_KALMAN)
+, m_update_mode(FUSION_UPDATE_SYNC)
+{
+	cvirtual_sensor_config &config = cvirtual_sensor_config::get_instance();
+	string engine;
+	string update_mode;
+	float mahony_gains[2];
+
+	m_name = string(SENSOR_NAME);
+	register_supported_event(FUSION_EVENT_AGM);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_VENDOR, m_vendor)) {
+		ERR("[VENDOR] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_vendor = %s", m_vendor.c_str());
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_DEFAULT_SAMPLING_TIME, &m_default_sampling_time)) {
+		ERR("[DEFAULT_SAMPLING_TIME] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_default_sampling_time = %d", m_default_sampling_time);
+
+	if (config.get(SENSOR_TYPE_FUSION, ELEMENT_MIN_SAMPLING_TIME, &m_min_sampling_time))
+		INFO("m_min_sampling_time = %d", m_min_sampling_time);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_ACCEL_STATIC_BIAS, m_accel_static_bias, 3)) {
+		ERR("[ACCEL_STATIC_BIAS] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_accel_static_bias = (%f, %f, %f)", m_accel_static_bias[0], m_accel_static_bias[1], m_accel_static_bias[2]);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_GYRO_STATIC_BIAS, m_gyro_static_bias, 3)) {
+		ERR("[GYRO_STATIC_BIAS] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_gyro_static_bias = (%f, %f, %f)", m_gyro_static_bias[0], m_gyro_static_bias[1], m_gyro_static_bias[2]);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_GEOMAGNETIC_STATIC_BIAS, m_geomagnetic_static_bias, 3)) {
+		ERR("[GEOMAGNETIC_STATIC_BIAS] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_geomagnetic_static_bias = (%f, %f, %f)", m_geomagnetic_static_bias[0], m_geomagnetic_static_bias[1], m_geomagnetic_static_bias[2]);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_ACCEL_ROTATION_DIRECTION_COMPENSATION, m_accel_rotation_direction_compensation, 3)) {
+		ERR("[ACCEL_ROTATION_DIRECTION_COMPENSATION] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_accel_rotation_direction_compensation = (%d, %d, %d)", m_accel_rotation_direction_compensation[0], m_accel_rotation_direction_compensation[1], m_accel_rotation_direction_compensation[2]);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_GYRO_ROTATION_DIRECTION_COMPENSATION, m_gyro_rotation_direction_compensation, 3)) {
+		ERR("[GYRO_ROTATION_DIRECTION_COMPENSATION] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_gyro_rotation_direction_compensation = (%d, %d, %d)", m_gyro_rotation_direction_compensation[0], m_gyro_rotation_direction_compensation[1], m_gyro_rotation_direction_compensation[2]);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_GEOMAGNETIC_ROTATION_DIRECTION_COMPENSATION, m_geomagnetic_rotation_direction_compensation, 3)) {
+		ERR("[GEOMAGNETIC_ROTATION_DIRECTION_COMPENSATION] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_geomagnetic_rotation_direction_compensation = (%d, %d, %d)", m_geomagnetic_rotation_direction_compensation[0], m_geomagnetic_rotation_direction_compensation[1], m_geomagnetic_rotation_direction_compensation[2]);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_ACCEL_SCALE, &m_accel_scale)) {
+		ERR("[ACCEL_SCALE] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_accel_scale = %f", m_accel_scale);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_GYRO_SCALE, &m_gyro_scale)) {
+		ERR("[GYRO_SCALE] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_gyro_scale = %f", m_gyro_scale);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_GEOMAGNETIC_SCALE, &m_geomagnetic_scale)) {
+		ERR("[GEOMAGNETIC_SCALE] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_geomagnetic_scale = %f", m_geomagnetic_scale);
+
+	if (!config.get(SENSOR_TYPE_FUSION, ELEMENT_MAGNETIC_ALIGNMENT_FACTOR, &m_magnetic_alignment_factor)) {
+		ERR("[MAGNETIC_ALIGNMENT_FACTOR] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_magnetic_alignment_factor = %d", m_magnetic_alignment_factor);
+
+	if (config.get(SENSOR_TYPE_FUSION, ELEMENT_COVARIANCE_WINDOW_LENGTH, &m_covariance_window_length)) {
+		INFO("m_covariance_window_length = %d", m_covariance_window_length);
+		m_orientation_filter.set_moving_average_window(m_covariance_window_length);
+	}
+
+	if (config.get(SENSOR_TYPE_FUSION, ELEMENT_FUSION_ENGINE, engine)) {
+		if (engine == FUSION_ENGINE_NAME_MAHONY) {
+			m_engine = FUSION_ENGINE_MAHONY;
+		} else if (engine == FUSION_ENGINE_NAME_MAHONY_FIXED) {
+			m_engine = FUSION_ENGINE_MAHONY_FIXED;
+		} else if (engine != FUSION_ENGINE_NAME_KALMAN) {
+			ERR("[FUSION_ENGINE] %s is not supported\n", engine.c_str());
+			throw ENXIO;
+		}
+	}
+
+	INFO("m_engine = %s", engine.empty() ? FUSION_ENGINE_NAME_KALMAN : engine.c_str());
+
+	if (config.get(SENSOR_TYPE_FUSION, ELEMENT_MAHONY_GAINS, mahony_gains, 2)) {
+		INFO("mahony_gains = (%f, %f)", mahony_gains[0], mahony_gains[1]);
+		m_mahony_filter.set_gains(mahony_gains[0], mahony_gains[1]);
+		m_mahony_fixed_filter.set_gains(mahony_gains[0], mahony_gains[1]);
+	}
+
+	if (config.get(SENSOR_TYPE_FUSION, ELEMENT_FUSION_UPDATE_MODE, update_mode)) {
+		if (update_mode == FUSION_UPDATE_MODE_NAME_ASYNC) {
+			m_update_mode = FUSION_UPDATE_ASYNC;
+		} else if (update_mode != FUSION_UPDATE_MODE_NAME_SYNC) {
+			ERR("[FUSION_UPDATE_MODE] %s is not supported\n", update_mode.c_str());
+			throw ENXIO;
+		}
+	}
+
+	INFO("m_update_mode = %s", m_update_mode == FUSION_UPDATE_ASYNC ? FUSION_UPDATE_MODE_NAME_ASYNC : FUSION_UPDATE_MODE_NAME_SYNC);
+
+	m_interval = m_default_sampling_time * MS_TO_US;
+
+	m_orientation_filter.m_magnetic_alignment_factor = m_magnetic_alignment_factor;
+	m_mahony_filter.m_magnetic_alignment_factor = m_magnetic_alignment_factor;
+	m_mahony_fixed_filter.m_magnetic_alignment_factor = m_magnetic_alignment_factor;
+}
+
+fusion_sensor::~fusion_sensor()
+{
+	INFO("fusion_sensor is destroyed!\n");
+}
+
+bool fusion_sensor::init(void)
+{
+	m_accel_sensor = sensor_plugin_loader::get_instance().get_sensor(ACCELEROMETER_SENSOR);
+	m_gyro_sensor = sensor_plugin_loader::get_instance().get_sensor(GYROSCOPE_SENSOR);
+	m_magnetic_sensor = sensor_plugin_loader::get_instance().get_sensor(GEOMAGNETIC_SENSOR);
+
+	if (!m_accel_sensor || !m_gyro_sensor || !m_magnetic_sensor) {
+		ERR("Failed to load sensors,  accel: 0x%x, gyro: 0x%x, mag: 0x%x",
+			m_accel_sensor, m_gyro_sensor, m_magnetic_sensor);
+		return false;
+	}
+
+	INFO("%s is created!", sensor_base::get_name());
+	return true;
+}
+
+sensor_type_t fusion_sensor::get_type(void)
+{
+	return FUSION_SENSOR;
+}
+
+bool fusion_sensor::on_start(void)
+{
+	AUTOLOCK(m_interval_mutex);
+
+	m_accel_sensor->add_client(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
+	m_gyro_sensor->add_client(GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME);
+	m_magnetic_sensor->add_client(GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME);
+
+	if (m_input_interval) {
+		m_accel_sensor->add_interval(get_id(), m_input_interval, true);
+		m_gyro_sensor->add_interval(get_id(), m_input_interval, true);
+		m_magnetic_sensor->add_interval(get_id(), m_input_interval, true);
+	}
+
+	m_accel_sensor->start();
+	m_gyro_sensor->start();
+	m_magnetic_sensor->start();
+
+	m_inputs_started = true;
+	m_enable_fusion = 0;
+	m_aiding_changed = false;
+	m_mahony_filter.m_initialized = false;
+	m_mahony_fixed_filter.m_initialized = false;
+	clear_data();
+
+	return true;
+}
+
+bool fusion_sensor::on_stop(void)
+{
+	AUTOLOCK(m_interval_mutex);
+
+	m_accel_sensor->delete_client(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
+	m_accel_sensor->delete_interval(get_id(), true);
+	m_accel_sensor->stop();
+	m_gyro_sensor->delete_client(GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME);
+	m_gyro_sensor->delete_interval(get_id(), true);
+	m_gyro_sensor->stop();
+	m_magnetic_sensor->delete_client(GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME);
+	m_magnetic_sensor->delete_interval(get_id(), true);
+	m_magnetic_sensor->stop();
+
+	m_inputs_started = false;
+	return true;
+}
+
+/*
+ * Orientation, rotation vector and the sensors built on them all request
+ * their rate from here, so accel/gyro/mag only run as fast as the fastest
+ * of them. MIN_SAMPLING_TIME caps that rate; consumers asking for more
+ * interpolate between fusion outputs instead.
+ */
+bool fusion_sensor::set_interval(unsigned long val)
+{
+	AUTOLOCK(m_interval_mutex);
+
+	if (val < (unsigned long) m_min_sampling_time)
+		val = m_min_sampling_time;
+
+	m_input_interval = val;
+
+	if (!m_inputs_started)
+		return true;
+
+	m_accel_sensor->add_interval(get_id(), val, true);
+	m_gyro_sensor->add_interval(get_id(), val, true);
+	m_magnetic_sensor->add_interval(get_id(), val, true);
+
+	return true;
+}
+
+/*
+ * The dispatcher turns a ready result into a FUSION_EVENT_AGM event for
+ * the virtual sensors that project it.
+ */
+void fusion_sensor::fuse(const sensor_event_t &event)
+{
+	if (m_update_mode == FUSION_UPDATE_ASYNC)
+		fuse_async(event);
+	else
+		fuse_sync(event);
+}
+
+/*
+ * Runs the orientation filter once per complete accel/gyro/mag set.
+ */
+void fusion_sensor::fuse_sync(const sensor_event_t &event)
+{
+	const float MIN_DELIVERY_DIFF_FACTOR = 0.75f;
+	unsigned long long diff_time;
+	quaternion<float> quat;
+
+	if (event.event_type == ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME) {
+		diff_time = event.data.timestamp - m_time;
+
+		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
+			return;
+
+		pre_process_data(m_accel, event.data.values, m_accel_static_bias, m_accel_rotation_direction_compensation, m_accel_scale);
+
+		m_accel.m_time_stamp = event.data.timestamp;
+
+		m_enable_fusion |= ACCELEROMETER_ENABLED;
+	}
+	else if (event.event_type == GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME) {
+		diff_time = event.data.timestamp - m_time;
+
+		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
+			return;
+
+		pre_process_data(m_gyro, event.data.values, m_gyro_static_bias, m_gyro_rotation_direction_compensation, m_gyro_scale);
+
+		m_gyro.m_time_stamp = event.data.timestamp;
+
+		m_enable_fusion |= GYROSCOPE_ENABLED;
+	}
+	else if (event.event_type == GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME) {
+		diff_time = event.data.timestamp - m_time;
+
+		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
+			return;
+
+		pre_process_data(m_magnetic, event.data.values, m_geomagnetic_static_bias, m_geomagnetic_rotation_direction_compensation, m_geomagnetic_scale);
+
+		m_magnetic.m_time_stamp = event.data.timestamp;
+
+		m_enable_fusion |= GEOMAGNETIC_ENABLED;
+	}
+
+	if (m_enable_fusion != FUSION_ENABLED)
+		return;
+
+	m_enable_fusion = 0;
+
+	if (m_engine == FUSION_ENGINE_MAHONY)
+		quat = m_mahony_filter.get_quaternion(m_accel, m_gyro, m_magnetic);
+	else if (m_engine == FUSION_ENGINE_MAHONY_FIXED)
+		quat = get_fixed_quaternion();
+	else
+		quat = m_orientation_filter.get_quaternion(m_accel, m_gyro, m_magnetic);
+
+	publish(quat, event.data.timestamp);
+}
+
+/*
+ * Steps the filter on every gyro sample, correcting against the latest
+ * accel/mag samples instead of waiting for a fresh one of each. Nothing
+ * is dropped on input; only the published result is throttled, to the
+ * interval the fusion clients asked for.
+ */
+void fusion_sensor::fuse_async(const sensor_event_t &event)
+{
+	const float MIN_DELIVERY_DIFF_FACTOR = 0.75f;
+	const unsigned int AIDING_ENABLED = ACCELEROMETER_ENABLED | GEOMAGNETIC_ENABLED;
+	unsigned long long diff_time;
+	unsigned long long output_interval;
+	quaternion<float> quat;
+
+	if (event.event_type == ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME) {
+		pre_process_data(m_accel, event.data.values, m_accel_static_bias, m_accel_rotation_direction_compensation, m_accel_scale);
+		m_accel.m_time_stamp = event.data.timestamp;
+
+		m_enable_fusion |= ACCELEROMETER_ENABLED;
+		m_aiding_changed = true;
+		return;
+	}
+
+	if (event.event_type == GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME) {
+		pre_process_data(m_magnetic, event.data.values, m_geomagnetic_static_bias, m_geomagnetic_rotation_direction_compensation, m_geomagnetic_scale);
+		m_magnetic.m_time_stamp = event.data.timestamp;
+
+		m_enable_fusion |= GEOMAGNETIC_ENABLED;
+		m_aiding_changed = true;
+		return;
+	}
+
+	if (event.event_type != GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME)
+		return;
+
+	if ((m_enable_fusion & AIDING_ENABLED) != AIDING_ENABLED)
+		return;
+
+	pre_process_data(m_gyro, event.data.values, m_gyro_static_bias, m_gyro_rotation_direction_compensation, m_gyro_scale);
+	m_gyro.m_time_stamp = event.data.timestamp;
+
+	if (m_engine == FUSION_ENGINE_MAHONY) {
+		quat = m_mahony_filter.get_quaternion(m_accel, m_gyro, m_magnetic);
+	} else if (m_engine == FUSION_ENGINE_MAHONY_FIXED) {
+		quat = get_fixed_quaternion();
+	} else {
+		if (m_aiding_changed)
+			m_orientation_filter.update_aiding(m_accel, m_magnetic);
+
+		m_orientation_filter.update_gyro(m_gyro);
+		quat = m_orientation_filter.m_quaternion;
+	}
+
+	m_aiding_changed = false;
+
+	{
+		AUTOLOCK(m_interval_mutex);
+		output_interval = m_input_interval ? m_input_interval * MS_TO_US : m_interval;
+	}
+
+	diff_time = event.data.timestamp - m_time;
+
+	if (m_time && (diff_time < output_interval * MIN_DELIVERY_DIFF_FACTOR))
+		return;
+
+	publish(quat, event.data.timestamp);
+}
+
+static sensor_data<fixed_q16_t> to_fixed(const sensor_data<float> &data)
+{
+	sensor_data<fixed_q16_t> fixed(data.m_data.m_vec[0], data.m_data.m_vec[1],
+			data.m_data.m_vec[2], data.m_time_stamp);
+
+	return fixed;
+}
+
+/*
+ * Runs the Q16.16 instantiation of the Mahony filter. Only the inputs and
+ * the resulting quaternion cross the float boundary; the filter step itself
+ * is integer arithmetic, for cores where the FPU is the costlier unit to
+ * keep awake at low always-on rates.
+ */
+quaternion<float> fusion_sensor::get_fixed_quaternion(void)
+{
+	quaternion<fixed_q16_t> quat;
+
+	quat = m_mahony_fixed_filter.get_quaternion(to_fixed(m_accel), to_fixed(m_gyro), to_fixed(m_magnetic));
+
+	return quaternion<float>(quat.m_quat.m_vec[0].to_float(), quat.m_quat.m_vec[1].to_float(),
+			quat.m_quat.m_vec[2].to_float(), quat.m_quat.m_vec[3].to_float());
+}
+
+/*
+ * Results carry the timestamp of the input sample that completed them, so
+ * the virtual sensors downstream resample on sensor time and a replayed
+ * trace produces the same output on every run.
+ */
+void fusion_sensor::publish(const quaternion<float> &quat, const unsigned long long timestamp)
+{
+	AUTOLOCK(m_value_mutex);
+	m_quaternion = quat;
+	m_orientation = quat2euler(m_quaternion);
+	m_time = timestamp;
+	m_data_ready = true;
+}
+
+bool fusion_sensor::is_data_ready(void)
+{
+	AUTOLOCK(m_value_mutex);
+	return m_data_ready;
+}
+
+void fusion_sensor::clear_data(void)
+{
+	AUTOLOCK(m_value_mutex);
+	m_data_ready = false;
+}
+
+unsigned long long fusion_sensor::get_data_timestamp(void)
+{
+	AUTOLOCK(m_value_mutex);
+	return m_time;
+}
+
+bool fusion_sensor::get_attitude(float &x, float &y, float &z, float &w)
+{
+	AUTOLOCK(m_value_mutex);
+
+	if (!m_time)
+		return false;
+
+	w = m_quaternion.m_quat.m_vec[0];
+	x = m_quaternion.m_quat.m_vec[1];
+	y = m_quaternion.m_quat.m_vec[2];
+	z = m_quaternion.m_quat.m_vec[3];
+
+	return true;
+}
+
+bool fusion_sensor::get_rotation_vector(float &x, float &y, float &z, float &w, float &heading_accuracy, int &accuracy)
+{
+	heading_accuracy = 0;
+	accuracy = SENSOR_ACCURACY_GOOD;
+
+	return get_attitude(x, y, z, w);
+}
+
+bool fusion_sensor::get_orientation(float &azimuth, float &pitch, float &roll, int &accuracy)
+{
+	AUTOLOCK(m_value_mutex);
+
+	if (!m_time)
+		return false;
+
+	pitch = m_orientation.m_ang.m_vec[0];
+	roll = m_orientation.m_ang.m_vec[1];
+	azimuth = m_orientation.m_ang.m_vec[2];
+	accuracy = SENSOR_ACCURACY_GOOD;
+
+	return true;
+}
+
+bool fusion_sensor::get_properties(sensor_properties_t &properties)
+{
+	properties.vendor = m_vendor;
+	properties.name = SENSOR_NAME;
+	properties.min_range = 0;
+	properties.max_range = 1;
+	properties.resolution = 0.000001;
+	properties.fifo_count = 0;
+	properties.max_batch_count = 0;
+	properties.min_interval = 1;
+
+	return true;
+}
+
+extern "C" sensor_module* create(void)
+{
+	fusion_sensor *sensor;
+
+	try {
+		sensor = new(std::nothrow) fusion_sensor;
+	} catch (int err) {
+		ERR("Failed to create module, err: %d, cause: %s", err, strerror(err));
+		return NULL;
+	}
+
+	sensor_module *module = new(std::nothrow) sensor_module;
+	retvm_if(!module || !sensor, NULL, "Failed to allocate memory");
+
+	module->sensors.push_back(sensor);
+	return module;
+}
@@ -0,0 +1,112 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _FUSION_SENSOR_H_
+#define _FUSION_SENSOR_H_
+
+#include <sensor_internal.h>
+#include <sensor_fusion.h>
+#include <orientation_filter.h>
+#include <mahony_filter.h>
+#include <fixed_point.h>
+
+enum fusion_engine_t {
+	FUSION_ENGINE_KALMAN = 0,
+	FUSION_ENGINE_MAHONY,
+	FUSION_ENGINE_MAHONY_FIXED,
+};
+
+enum fusion_update_mode_t {
+	FUSION_UPDATE_SYNC = 0,
+	FUSION_UPDATE_ASYNC,
+};
+
+class fusion_sensor : public sensor_fusion {
+public:
+	fusion_sensor();
+	virtual ~fusion_sensor();
+
+	bool init(void);
+	sensor_type_t get_type(void);
+
+	void fuse(const sensor_event_t &event);
+	bool is_data_ready(void);
+	void clear_data(void);
+	unsigned long long get_data_timestamp(void);
+
+	bool get_attitude(float &x, float &y, float &z, float &w);
+	bool get_rotation_vector(float &x, float &y, float &z, float &w, float &heading_accuracy, int &accuracy);
+	bool get_orientation(float &azimuth, float &pitch, float &roll, int &accuracy);
+	bool get_properties(sensor_properties_t &properties);
+
+private:
+	sensor_base *m_accel_sensor;
+	sensor_base *m_gyro_sensor;
+	sensor_base *m_magnetic_sensor;
+
+	sensor_data<float> m_accel;
+	sensor_data<float> m_gyro;
+	sensor_data<float> m_magnetic;
+
+	cmutex m_value_mutex;
+	cmutex m_interval_mutex;
+
+	orientation_filter<float> m_orientation_filter;
+	mahony_filter<float> m_mahony_filter;
+	mahony_filter<fixed_q16_t> m_mahony_fixed_filter;
+
+	unsigned int m_enable_fusion;
+	bool m_aiding_changed;
+	bool m_data_ready;
+
+	quaternion<float> m_quaternion;
+	euler_angles<float> m_orientation;
+	unsigned long long m_time;
+	unsigned int m_interval;
+	unsigned long m_input_interval;
+	bool m_inputs_started;
+
+	string m_vendor;
+	int m_default_sampling_time;
+	int m_min_sampling_time;
+	float m_accel_static_bias[3];
+	float m_gyro_static_bias[3];
+	float m_geomagnetic_static_bias[3];
+	int m_accel_rotation_direction_compensation[3];
+	int m_gyro_rotation_direction_compensation[3];
+	int m_geomagnetic_rotation_direction_compensation[3];
+	float m_accel_scale;
+	float m_gyro_scale;
+	float m_geomagnetic_scale;
+	int m_magnetic_alignment_factor;
+	int m_covariance_window_length;
+	fusion_engine_t m_engine;
+	fusion_update_mode_t m_update_mode;
+
+	bool on_start(void);
+	bool on_stop(void);
+	bool set_interval(unsigned long val);
+
+	void fuse_sync(const sensor_event_t &event);
+	void fuse_async(const sensor_event_t &event);
+	quaternion<float> get_fixed_quaternion(void);
+	void publish(const quaternion<float> &quat, const unsigned long long timestamp);
+};
+
+#endif
@@ -34,12 +34,8 @@
 #define INITIAL_VALUE -1
 #define GRAVITY 9.80665
 
-#define DEG2RAD (M_PI/180)
-#define DEVIATION 0.1
-
 #define SENSOR_NAME "GRAVITY_SENSOR"
 #define SENSOR_TYPE_GRAVITY		"GRAVITY"
-#define SENSOR_TYPE_ORIENTATION		"ORIENTATION"
 
 #define MS_TO_US 1000
 
@@ -48,10 +44,9 @@
 #define ELEMENT_RAW_DATA_UNIT									"RAW_DATA_UNIT"
 #define ELEMENT_DEFAULT_SAMPLING_TIME							"DEFAULT_SAMPLING_TIME"
 #define ELEMENT_GRAVITY_SIGN_COMPENSATION						"GRAVITY_SIGN_COMPENSATION"
-#define ELEMENT_ORIENTATION_DATA_UNIT							"RAW_DATA_UNIT"
 
 gravity_sensor::gravity_sensor()
-: m_orientation_sensor(NULL)
+: m_fusion(NULL)
 , m_x(INITIAL_VALUE)
 , m_y(INITIAL_VALUE)
 , m_z(INITIAL_VALUE)
@@ -70,13 +65,6 @@ gravity_sensor::gravity_sensor()
 
 	INFO("m_vendor = %s", m_vendor.c_str());
 
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_ORIENTATION_DATA_UNIT, m_orientation_data_unit)) {
-		ERR("[ORIENTATION_DATA_UNIT] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_orientation_data_unit = %s", m_orientation_data_unit.c_str());
-
 	if (!config.get(SENSOR_TYPE_GRAVITY, ELEMENT_RAW_DATA_UNIT, m_raw_data_unit)) {
 		ERR("[RAW_DATA_UNIT] is empty\n");
 		throw ENXIO;
@@ -108,10 +96,13 @@ gravity_sensor::~gravity_sensor()
 
 bool gravity_sensor::init()
 {
-	m_orientation_sensor = sensor_plugin_loader::get_instance().get_sensor(ORIENTATION_SENSOR);
+	if (!load_input_sensors(SENSOR_TYPE_GRAVITY))
+		return false;
 
-	if (!m_orientation_sensor) {
-		ERR("Failed to load orientation sensor: 0x%x", m_orientation_sensor);
+	m_fusion = static_cast<sensor_fusion *>(get_input_sensor(FUSION_SENSOR));
+
+	if (!m_fusion) {
+		ERR("Fusion sensor is not an input of %s", sensor_base::get_name());
 		return false;
 	}
 
@@ -127,9 +118,9 @@ sensor_type_t gravity_sensor::get_type(void)
 bool gravity_sensor::on_start(void)
 {
 	AUTOLOCK(m_mutex);
+	start_input_sensors();
 
-	m_orientation_sensor->add_client(ORIENTATION_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_orientation_sensor->start();
+	m_resampler.reset();
 
 	activate();
 	return true;
@@ -138,84 +129,53 @@ bool gravity_sensor::on_start(void)
 bool gravity_sensor::on_stop(void)
 {
 	AUTOLOCK(m_mutex);
-
-	m_orientation_sensor->delete_client(ORIENTATION_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_orientation_sensor->stop();
+	stop_input_sensors();
 
 	deactivate();
 	return true;
 }
 
-bool gravity_sensor::add_interval(int client_id, unsigned int interval, bool is_processor)
-{
-	AUTOLOCK(m_mutex);
-	m_orientation_sensor->add_interval(client_id, interval, true);
-
-	return sensor_base::add_interval(client_id, interval, true);
-}
-
-bool gravity_sensor::delete_interval(int client_id, bool is_processor)
-{
-	AUTOLOCK(m_mutex);
-	m_orientation_sensor->delete_interval(client_id, true);
-
-	return sensor_base::delete_interval(client_id, true);
-}
-
 void gravity_sensor::synthesize(const sensor_event_t &event, vector<sensor_event_t> &outs)
 {
 	sensor_event_t gravity_event;
-	float pitch, roll, azimuth;
-
-	azimuth = event.data.values[0];
-	pitch = event.data.values[1];
-	roll = event.data.values[2];
-
-	const float MIN_DELIVERY_DIFF_FACTOR = 0.75f;
-	unsigned long long diff_time;
+	float x, y, z, w;
+	vect<float, 3> gravity;
+	vect<float, 3> gravities[RESAMPLER_MAX_OUTPUTS];
+	unsigned long long times[RESAMPLER_MAX_OUTPUTS];
+	int count;
+
+	if (event.event_type == FUSION_EVENT_AGM) {
+		if (!m_fusion->get_attitude(x, y, z, w))
+			return;
 
-	if(m_orientation_data_unit == "DEGREES") {
-		azimuth *= DEG2RAD;
-		pitch *= DEG2RAD;
-		roll *= DEG2RAD;
-	}
+		gravity = quat2gravity(quaternion<float>(w, x, y, z), (float)GRAVITY);
 
-	if (event.event_type == ORIENTATION_EVENT_RAW_DATA_REPORT_ON_TIME) {
-		diff_time = event.data.timestamp - m_time;
+		for (int i = 0; i < 3; i++)
+			gravity.m_vec[i] *= m_gravity_sign_compensation[i];
 
-		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
-			return;
+		count = m_resampler.resample(gravity, event.data.timestamp,
+			get_output_interval(m_interval), gravities, times, RESAMPLER_MAX_OUTPUTS);
 
-		gravity_event.sensor_id = get_id();
-		gravity_event.event_type = GRAVITY_EVENT_RAW_DATA_REPORT_ON_TIME;
-		if ((roll >= (M_PI/2)-DEVIATION && roll <= (M_PI/2)+DEVIATION) ||
-				(roll >= -(M_PI/2)-DEVIATION && roll <= -(M_PI/2)+DEVIATION)) {
-			gravity_event.data.values[0] = m_gravity_sign_compensation[0] * GRAVITY * sin(roll) * cos(azimuth);
-			gravity_event.data.values[1] = m_gravity_sign_compensation[1] * GRAVITY * sin(azimuth);
-			gravity_event.data.values[2] = m_gravity_sign_compensation[2] * GRAVITY * cos(roll);
-		} else if ((pitch >= (M_PI/2)-DEVIATION && pitch <= (M_PI/2)+DEVIATION) ||
-				(pitch >= -(M_PI/2)-DEVIATION && pitch <= -(M_PI/2)+DEVIATION)) {
-			gravity_event.data.values[0] = m_gravity_sign_compensation[0] * GRAVITY * sin(azimuth);
-			gravity_event.data.values[1] = m_gravity_sign_compensation[1] * GRAVITY * sin(pitch) * cos(azimuth);
-			gravity_event.data.values[2] = m_gravity_sign_compensation[2] * GRAVITY * cos(pitch);
-		} else {
-			gravity_event.data.values[0] = m_gravity_sign_compensation[0] * GRAVITY * sin(roll);
-			gravity_event.data.values[1] = m_gravity_sign_compensation[1] * GRAVITY * sin(pitch);
-			gravity_event.data.values[2] = m_gravity_sign_compensation[2] * GRAVITY * cos(roll) * cos(pitch);
-		}
-		gravity_event.data.value_count = 3;
-		gravity_event.data.timestamp = get_timestamp();
-		gravity_event.data.accuracy = SENSOR_ACCURACY_GOOD;
+		for (int i = 0; i < count; i++) {
+			gravity_event.sensor_id = get_id();
+			gravity_event.event_type = GRAVITY_EVENT_RAW_DATA_REPORT_ON_TIME;
+			gravity_event.data.values[0] = gravities[i].m_vec[0];
+			gravity_event.data.values[1] = gravities[i].m_vec[1];
+			gravity_event.data.values[2] = gravities[i].m_vec[2];
+			gravity_event.data.value_count = 3;
+			gravity_event.data.timestamp = times[i];
+			gravity_event.data.accuracy = SENSOR_ACCURACY_GOOD;
 
-		push(gravity_event);
+			outs.push_back(gravity_event);
 
-		{
-			AUTOLOCK(m_value_mutex);
+			{
+				AUTOLOCK(m_value_mutex);
 
-			m_time = gravity_event.data.timestamp;
-			m_x = gravity_event.data.values[0];
-			m_y = gravity_event.data.values[1];
-			m_z = gravity_event.data.values[2];
+				m_time = gravity_event.data.timestamp;
+				m_x = gravity_event.data.values[0];
+				m_y = gravity_event.data.values[1];
+				m_z = gravity_event.data.values[2];
+			}
 		}
 	}
 }
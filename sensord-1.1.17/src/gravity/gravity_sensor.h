@@ -22,6 +22,8 @@
 
 #include <sensor_internal.h>
 #include <virtual_sensor.h>
+#include <sensor_fusion.h>
+#include <resampler.h>
 
 class gravity_sensor : public virtual_sensor {
 public:
@@ -33,13 +35,12 @@ public:
 
 	void synthesize(const sensor_event_t &event, vector<sensor_event_t> &outs);
 
-	bool add_interval(int client_id, unsigned int interval, bool is_processor);
-	bool delete_interval(int client_id, bool is_processor);
-
 	int get_sensor_data(unsigned int data_id, sensor_data_t &data);
 	bool get_properties(sensor_properties_t &properties);
 private:
-	sensor_base *m_orientation_sensor;
+	sensor_fusion *m_fusion;
+	resampler<float, vect<float, 3> > m_resampler;
+
 	cmutex m_value_mutex;
 
 	float m_x;
@@ -51,7 +52,6 @@ private:
 
 	string m_vendor;
 	string m_raw_data_unit;
-	string m_orientation_data_unit;
 	int m_default_sampling_time;
 	int m_gravity_sign_compensation[3];
 
@@ -27,6 +27,9 @@
 #include <common.h>
 #include <sensor_info.h>
 #include <sensor_info_manager.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #ifndef API
 #define API __attribute__((visibility("default")))
@@ -183,7 +186,7 @@ static void restore_session(void)
 		cmd_channel = new(std::nothrow) command_channel();
 		retm_if (!cmd_channel, "Failed to allocate memory");
 
-		if (!cmd_channel->create_channel()) {
+		if (!event_listener.attach_command_channel(cmd_channel)) {
 			_E("%s failed to create command channel for %s", get_client_name(), get_sensor_name(*it_sensor));
 			delete cmd_channel;
 			goto FAILED;
@@ -249,6 +252,7 @@ static bool change_sensor_rep(sensor_id_t sensor_id, sensor_rep &prev_rep, senso
 	int client_id;
 	command_channel *cmd_channel;
 	event_type_vector add_event_types, del_event_types;
+	bool ret = false;
 
 	if (!event_listener.get_command_channel(sensor_id, &cmd_channel)) {
 		ERR("client %s failed to get command channel for %s", get_client_name(), get_sensor_name(sensor_id));
@@ -260,11 +264,13 @@ static bool change_sensor_rep(sensor_id_t sensor_id, sensor_rep &prev_rep, senso
 
 	get_events_diff(prev_rep.event_types, cur_rep.event_types, add_event_types, del_event_types);
 
+	cmd_channel->begin_batch();
+
 	if (cur_rep.active) {
 		if (prev_rep.option != cur_rep.option) {
 			if (!cmd_channel->cmd_set_option(cur_rep.option)) {
 				ERR("Sending cmd_set_option(%d, %s, %d) failed for %s", client_id, get_sensor_name(sensor_id), cur_rep.option, get_client_name());
-				return false;
+				goto out;
 			}
 		}
 
@@ -281,14 +287,14 @@ static bool change_sensor_rep(sensor_id_t sensor_id, sensor_rep &prev_rep, senso
 
 			if (!cmd_channel->cmd_set_interval(min_interval)) {
 				ERR("Sending cmd_set_interval(%d, %s, %d) failed for %s", client_id, get_sensor_name(sensor_id), min_interval, get_client_name());
-				return false;
+				goto out;
 			}
 		}
 
 		if (!add_event_types.empty()) {
 			if (!cmd_channel->cmd_register_events(add_event_types)) {
 				ERR("Sending cmd_register_events(%d, add_event_types) failed for %s", client_id, get_client_name());
-				return false;
+				goto out;
 			}
 		}
 
@@ -297,7 +303,7 @@ static bool change_sensor_rep(sensor_id_t sensor_id, sensor_rep &prev_rep, senso
 	if (prev_rep.active && !del_event_types.empty()) {
 		if (!cmd_channel->cmd_unregister_events(del_event_types)) {
 			ERR("Sending cmd_unregister_events(%d, del_event_types) failed for %s", client_id, get_client_name());
-			return false;
+			goto out;
 		}
 	}
 
@@ -305,21 +311,34 @@ static bool change_sensor_rep(sensor_id_t sensor_id, sensor_rep &prev_rep, senso
 		if (cur_rep.active) {
 			if (!cmd_channel->cmd_start()) {
 				ERR("Sending cmd_start(%d, %s) failed for %s", client_id, get_sensor_name(sensor_id), get_client_name());
-				return false;
+				goto out;
 			}
 		} else {
 			if (!cmd_channel->cmd_unset_interval()) {
 				ERR("Sending cmd_unset_interval(%d, %s) failed for %s", client_id, get_sensor_name(sensor_id), get_client_name());
-				return false;
+				goto out;
 			}
 
 			if (!cmd_channel->cmd_stop()) {
 				ERR("Sending cmd_stop(%d, %s) failed for %s", client_id, get_sensor_name(sensor_id), get_client_name());
-				return false;
+				goto out;
 			}
 		}
 	}
 
+	ret = true;
+
+out:
+	if (!ret) {
+		cmd_channel->cancel_batch();
+		return false;
+	}
+
+	if (!cmd_channel->end_batch()) {
+		ERR("Sending batched commands(%d, %s) failed for %s", client_id, get_sensor_name(sensor_id), get_client_name());
+		return false;
+	}
+
 	return true;
 }
 
@@ -392,6 +411,48 @@ API int sf_get_data(int handle, unsigned int data_id, sensor_data_t* sensor_data
 	return sensord_get_data(handle, data_id, sensor_data) ? OP_SUCCESS : OP_ERROR;
 }
 
+/*
+ * Reads the sensor list the server publishes for every client, which saves
+ * a connection and a round trip, unless it leaves out sensors this client
+ * might be allowed to see
+ */
+static bool get_published_sensor_list(void)
+{
+	struct stat list_stat, socket_stat;
+	const sensor_list_file_t *list_file;
+	void *map;
+	int fd;
+	bool ret = false;
+
+	fd = open(SENSOR_LIST_PATH, O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+		return false;
+
+	if ((fstat(fd, &list_stat) < 0) || (stat(COMMAND_CHANNEL_PATH, &socket_stat) < 0) ||
+		(list_stat.st_uid != socket_stat.st_uid) ||
+		((size_t) list_stat.st_size < sizeof(sensor_list_file_t))) {
+		close(fd);
+		return false;
+	}
+
+	map = mmap(NULL, list_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED)
+		return false;
+
+	list_file = (const sensor_list_file_t *)map;
+
+	if ((list_file->magic == SENSOR_LIST_MAGIC) && (list_file->hidden_cnt == 0) &&
+		(list_file->size <= list_stat.st_size - sizeof(sensor_list_file_t)))
+		ret = sensor_info_manager::get_instance().add_infos(list_file->list, list_file->size);
+
+	munmap(map, list_stat.st_size);
+
+	return ret;
+}
+
 static bool get_sensor_list(void)
 {
 	static cmutex l;
@@ -399,6 +460,11 @@ static bool get_sensor_list(void)
 
 	AUTOLOCK(l);
 
+	if (!init && get_published_sensor_list()) {
+		INFO("%s got sensor list from %s", get_client_name(), SENSOR_LIST_PATH);
+		init = true;
+	}
+
 	if (!init) {
 		command_channel cmd_channel;
 
@@ -622,7 +688,7 @@ API int sensord_connect(sensor_t sensor)
 		cmd_channel = new(std::nothrow) command_channel();
 		retvm_if (!cmd_channel, OP_ERROR, "Failed to allocate memory");
 
-		if (!cmd_channel->create_channel()) {
+		if (!event_listener.attach_command_channel(cmd_channel)) {
 			ERR("%s failed to create command channel for %s", get_client_name(), get_sensor_name(sensor_id));
 			event_listener.delete_handle(handle);
 			delete cmd_channel;
@@ -55,6 +55,7 @@ log_element g_log_elements[] = {
 	FILL_LOG_ELEMENT(LOG_ID_SENSOR_TYPE, ULTRAVIOLET_SENSOR, 0, 1),
 	FILL_LOG_ELEMENT(LOG_ID_SENSOR_TYPE, DUST_SENSOR, 0, 1),
 	FILL_LOG_ELEMENT(LOG_ID_SENSOR_TYPE, ROTATION_VECTOR_SENSOR, 0, 1),
+	FILL_LOG_ELEMENT(LOG_ID_SENSOR_TYPE, GAME_ROTATION_VECTOR_SENSOR, 0, 1),
 
 	FILL_LOG_ELEMENT(LOG_ID_EVENT, GEOMAGNETIC_EVENT_CALIBRATION_NEEDED, 0, 1),
 	FILL_LOG_ELEMENT(LOG_ID_EVENT, PROXIMITY_EVENT_CHANGE_STATE, 0,1),
@@ -101,6 +102,7 @@ log_element g_log_elements[] = {
 	FILL_LOG_ELEMENT(LOG_ID_EVENT, ULTRAVIOLET_EVENT_RAW_DATA_REPORT_ON_TIME, 0, 10),
 	FILL_LOG_ELEMENT(LOG_ID_EVENT, DUST_EVENT_RAW_DATA_REPORT_ON_TIME, 0, 10),
 	FILL_LOG_ELEMENT(LOG_ID_EVENT, ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME, 0, 10),
+	FILL_LOG_ELEMENT(LOG_ID_EVENT, GAME_ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME, 0, 10),
 
 	FILL_LOG_ELEMENT(LOG_ID_DATA, ACCELEROMETER_BASE_DATA_SET, 0, 25),
 	FILL_LOG_ELEMENT(LOG_ID_DATA, GYRO_BASE_DATA_SET, 0, 25),
@@ -129,6 +131,7 @@ log_element g_log_elements[] = {
 	FILL_LOG_ELEMENT(LOG_ID_DATA, ULTRAVIOLET_BASE_DATA_SET, 0, 25),
 	FILL_LOG_ELEMENT(LOG_ID_DATA, DUST_BASE_DATA_SET, 0, 25),
 	FILL_LOG_ELEMENT(LOG_ID_DATA, ROTATION_VECTOR_BASE_DATA_SET, 0, 25),
+	FILL_LOG_ELEMENT(LOG_ID_DATA, GAME_ROTATION_VECTOR_BASE_DATA_SET, 0, 25),
 };
 
 typedef unordered_map<unsigned int, log_attr* > log_map;
@@ -224,6 +227,7 @@ bool is_ontime_event(unsigned int event_type)
 	case LINEAR_ACCEL_EVENT_RAW_DATA_REPORT_ON_TIME:
 	case ORIENTATION_EVENT_RAW_DATA_REPORT_ON_TIME:
 	case PRESSURE_EVENT_RAW_DATA_REPORT_ON_TIME:
+	case GAME_ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME:
 		return true;
 		break;
 	}
@@ -24,8 +24,11 @@
 #include <sensor_info_manager.h>
 
 command_channel::command_channel()
-: m_client_id(CLIENT_ID_INVALID)
+: m_mux_channel(NULL)
+, m_client_id(CLIENT_ID_INVALID)
 , m_sensor_id(UNKNOWN_SENSOR)
+, m_batching(false)
+, m_batch_cnt(0)
 {
 
 }
@@ -35,8 +38,32 @@ command_channel::~command_channel()
 		m_command_socket.close();
 }
 
+/*
+ * A channel attached to a multiplexed one sends through its connection,
+ * naming its sensor in each packet so the server can tell them apart
+ */
 bool command_channel::command_handler(cpacket *packet, void **return_payload)
 {
+	if (m_mux_channel && !packet->set_sensor(m_sensor_id))
+		return false;
+
+	if (m_batching)
+		return queue_command(packet, return_payload);
+
+	if (m_mux_channel)
+		return m_mux_channel->transact(packet, return_payload);
+
+	return transact(packet, return_payload);
+}
+
+/*
+ * The reply is left in m_reply, whose storage is reused by every command
+ * on the channel, so it is only valid until the next one
+ */
+bool command_channel::transact(cpacket *packet, void **return_payload)
+{
+	AUTOLOCK(m_mutex);
+
 	if (!m_command_socket.is_valid()) {
 		ERR("Command socket(%d) is not valid for client %s", m_command_socket.get_socket_fd(), get_client_name());
 		return false;
@@ -61,17 +88,36 @@ bool command_channel::command_handler(cpacket *packet, void **return_payload)
 		return false;
 	}
 
-	char *buffer = new(std::nothrow) char[header.size];
-	retvm_if(!buffer, false, "Failed to allocate memory");
+	if (!m_reply.set_payload_size(header.size))
+		return false;
 
-	if (m_command_socket.recv(buffer, header.size) <= 0) {
+	if ((header.size > 0) && (m_command_socket.recv(m_reply.data(), header.size) <= 0)) {
 		m_command_socket.close();
 		ERR("Failed to receive reply packet in client %s", get_client_name());
-		delete[] buffer;
 		return false;
 	}
 
-	*return_payload = buffer;
+	*return_payload = m_reply.data();
+
+	return true;
+}
+
+/*
+ * While batching, a command is only appended to the batch and acknowledged
+ * as queued; its real result comes back from end_batch()
+ */
+bool command_channel::queue_command(cpacket *packet, void **return_payload)
+{
+	char *raw_packet;
+
+	raw_packet = (char *)packet->packet();
+
+	m_batch.insert(m_batch.end(), raw_packet, raw_packet + packet->size());
+	m_batch.resize(CMD_BATCH_ALIGN(m_batch.size()), 0);
+	++m_batch_cnt;
+
+	m_queued_done.value = 0;
+	*return_payload = &m_queued_done;
 
 	return true;
 }
@@ -91,6 +137,77 @@ bool command_channel::create_channel(void)
 	return true;
 }
 
+void command_channel::attach_channel(command_channel *mux_channel)
+{
+	m_mux_channel = mux_channel;
+}
+
+void command_channel::begin_batch(void)
+{
+	m_batch.clear();
+	m_batch_cnt = 0;
+	m_batching = true;
+}
+
+void command_channel::cancel_batch(void)
+{
+	m_batch.clear();
+	m_batch_cnt = 0;
+	m_batching = false;
+}
+
+bool command_channel::end_batch(void)
+{
+	cpacket packet;
+	cmd_batch_t *cmd_batch;
+	cmd_batch_done_t *cmd_batch_done;
+	int cmd_cnt = m_batch_cnt;
+
+	m_batching = false;
+
+	if (!cmd_cnt)
+		return true;
+
+	if (!packet.set_payload_size(sizeof(cmd_batch_t) + m_batch.size())) {
+		cancel_batch();
+		return false;
+	}
+
+	packet.set_cmd(CMD_BATCH);
+
+	cmd_batch = (cmd_batch_t*)packet.data();
+	cmd_batch->cmd_cnt = cmd_cnt;
+	copy(m_batch.begin(), m_batch.end(), cmd_batch->data);
+
+	cancel_batch();
+
+	INFO("%s send cmd_batch(client_id=%d, %s, cmd_cnt=%d)",
+		get_client_name(), m_client_id, get_sensor_name(m_sensor_id), cmd_cnt);
+
+	if (!command_handler(&packet, (void **)&cmd_batch_done)) {
+		ERR("Client %s failed to send/receive command for sensor[%s] with client_id [%d]",
+			get_client_name(), get_sensor_name(m_sensor_id), m_client_id);
+		return false;
+	}
+
+	for (int i = 0; i < cmd_batch_done->cmd_cnt; ++i) {
+		if (cmd_batch_done->value[i] < 0) {
+			ERR("Client %s got error[%ld] from server for sub-command #%d of %d for sensor[%s] with client_id [%d]",
+				get_client_name(), cmd_batch_done->value[i], i, cmd_cnt, get_sensor_name(m_sensor_id), m_client_id);
+
+			return false;
+		}
+	}
+
+	if (cmd_batch_done->cmd_cnt != cmd_cnt) {
+		ERR("Client %s got %d results from server for %d sub-commands for sensor[%s] with client_id [%d]",
+			get_client_name(), cmd_batch_done->cmd_cnt, cmd_cnt, get_sensor_name(m_sensor_id), m_client_id);
+		return false;
+	}
+
+	return true;
+}
+
 void command_channel::set_client_id(int client_id)
 {
 	m_client_id = client_id;
@@ -98,39 +215,30 @@ void command_channel::set_client_id(int client_id)
 
 bool command_channel::cmd_get_id(int &client_id)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_get_id_t));
 	cmd_get_id_t *cmd_get_id;
 	cmd_get_id_done_t *cmd_get_id_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_get_id_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_GET_ID);
+	packet.set_cmd(CMD_GET_ID);
 
-	cmd_get_id = (cmd_get_id_t *)packet->data();
+	cmd_get_id = (cmd_get_id_t *)packet.data();
 	cmd_get_id->pid = getpid();
 
 	INFO("%s send cmd_get_id()", get_client_name());
 
-	if (!command_handler(packet, (void **)&cmd_get_id_done)) {
+	if (!command_handler(&packet, (void **)&cmd_get_id_done)) {
 		ERR("Client %s failed to send/receive command", get_client_name());
-		delete packet;
 		return false;
 	}
 
 	if (cmd_get_id_done->client_id < 0) {
 		ERR("Client %s failed to get client_id[%d] from server",
 			get_client_name(), cmd_get_id_done->client_id);
-		delete[] (char *)cmd_get_id_done;
-		delete packet;
 		return false;
 	}
 
 	client_id = cmd_get_id_done->client_id;
 
-	delete[] (char *)cmd_get_id_done;
-	delete packet;
-
 	return true;
 }
 
@@ -149,73 +257,37 @@ bool command_channel::cmd_get_sensor_list(void)
 		return false;
 	}
 
-	int sensor_cnt;
-	const size_t *size_field;
-	const char *raw_data_field;
-
-	sensor_cnt = cmd_get_sensor_list_done->sensor_cnt;
-	size_field = (const size_t *)cmd_get_sensor_list_done->data;
-	raw_data_field = (const char *)size_field + (sizeof(size_t) * sensor_cnt);
-
-	sensor_info *info;
-
-	int idx = 0;
-	for (int i = 0; i < sensor_cnt; ++i) {
-		info = new(std::nothrow) sensor_info;
-
-		if (!info) {
-			ERR("Failed to allocate memory");
-			delete[] (char *)cmd_get_sensor_list_done;
-			return false;
-		}
-
-		info->set_raw_data(raw_data_field + idx, size_field[i]);
-		sensor_info_manager::get_instance().add_info(info);
-		idx += size_field[i];
-	}
-
-	delete[] (char *)cmd_get_sensor_list_done;
-	return true;
+	return sensor_info_manager::get_instance().add_infos((const char *)cmd_get_sensor_list_done,
+		m_reply.payload_size());
 }
 
-
 bool command_channel::cmd_hello(sensor_id_t sensor)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_hello_t));
 	cmd_hello_t *cmd_hello;
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_hello_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_HELLO);
+	packet.set_cmd(CMD_HELLO);
 
-	cmd_hello = (cmd_hello_t*)packet->data();
+	cmd_hello = (cmd_hello_t*)packet.data();
 	cmd_hello->client_id = m_client_id;
 	cmd_hello->sensor = sensor;
 
 	INFO("%s send cmd_hello(client_id=%d, %s)",
 		get_client_name(), m_client_id, get_sensor_name(sensor));
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command for sensor[%s]",
 			get_client_name(), get_sensor_name(sensor));
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("client %s got error[%d] from server with sensor [%s]",
 			get_client_name(), cmd_done->value, get_sensor_name(sensor));
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	m_sensor_id = sensor;
 
 	return true;
@@ -223,40 +295,29 @@ bool command_channel::cmd_hello(sensor_id_t sensor)
 
 bool command_channel::cmd_byebye(void)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_byebye_t));
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_byebye_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_BYEBYE);
+	packet.set_cmd(CMD_BYEBYE);
 
 	INFO("%s send cmd_byebye(client_id=%d, %s)",
 		get_client_name(), m_client_id, get_sensor_name(m_sensor_id));
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command for sensor[%s] with client_id [%d]",
 			get_client_name(), get_sensor_name(m_sensor_id), m_client_id);
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("Client %s got error[%d] from server for sensor[%s] with client_id [%d]",
 			get_client_name(), cmd_done->value, get_sensor_name(m_sensor_id), m_client_id);
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	if (m_command_socket.is_valid())
 		m_command_socket.close();
 
-
 	m_client_id = CLIENT_ID_INVALID;
 	m_sensor_id = UNKNOWN_SENSOR;
 
@@ -265,149 +326,109 @@ bool command_channel::cmd_byebye(void)
 
 bool command_channel::cmd_start(void)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_start_t));
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_start_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_START);
+	packet.set_cmd(CMD_START);
 
 	INFO("%s send cmd_start(client_id=%d, %s)",
 		get_client_name(), m_client_id, get_sensor_name(m_sensor_id));
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command for sensor[%s] with client_id [%d]",
 			get_client_name(), get_sensor_name(m_sensor_id), m_client_id);
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("Client %s got error[%d] from server for sensor[%s] with client_id [%d]",
 			get_client_name(), cmd_done->value, get_sensor_name(m_sensor_id), m_client_id);
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	return true;
 }
 
 bool command_channel::cmd_stop(void)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_stop_t));
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_stop_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_STOP);
+	packet.set_cmd(CMD_STOP);
 
 	INFO("%s send cmd_stop(client_id=%d, %s)",
 		get_client_name(), m_client_id, get_sensor_name(m_sensor_id));
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command for sensor[%s] with client_id [%d]",
 			get_client_name(), get_sensor_name(m_sensor_id), m_client_id);
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("Client %s got error[%d] from server for sensor[%s] with client_id [%d]",
 			get_client_name(), cmd_done->value, get_sensor_name(m_sensor_id), m_client_id);
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	return true;
 }
 
 bool command_channel::cmd_set_option(int option)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_set_option_t));
 	cmd_set_option_t *cmd_set_option;
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_set_option_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_SET_OPTION);
+	packet.set_cmd(CMD_SET_OPTION);
 
-	cmd_set_option = (cmd_set_option_t*)packet->data();
+	cmd_set_option = (cmd_set_option_t*)packet.data();
 	cmd_set_option->option = option;
 
 	INFO("%s send cmd_set_option(client_id=%d, %s, option=%d)",
 		get_client_name(), m_client_id, get_sensor_name(m_sensor_id), option);
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command for sensor[%s] with client_id [%d], option[%d]",
 			get_client_name(), get_sensor_name(m_sensor_id), m_client_id, option);
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("Client %s got error[%d] from server for sensor[%s] with client_id [%d], option[%d]",
 			get_client_name(), cmd_done->value, get_sensor_name(m_sensor_id), m_client_id, option);
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	return true;
 }
 
 bool command_channel::cmd_register_event(unsigned int event_type)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_reg_t));
 	cmd_reg_t *cmd_reg;
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_reg_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_REG);
+	packet.set_cmd(CMD_REG);
 
-	cmd_reg = (cmd_reg_t*)packet->data();
+	cmd_reg = (cmd_reg_t*)packet.data();
 	cmd_reg->event_type = event_type;
 
 	INFO("%s send cmd_register_event(client_id=%d, %s)",
 		get_client_name(), m_client_id, get_event_name(event_type));
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command with client_id [%d], event_type[%s]",
 			get_client_name(), m_client_id, get_event_name(event_type));
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("Client %s got error[%d] from server with client_id [%d], event_type[%s]",
 			get_client_name(), cmd_done->value, m_client_id, get_event_name(event_type));
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	return true;
 }
 
@@ -428,40 +449,30 @@ bool command_channel::cmd_register_events(event_type_vector &event_vec)
 
 bool command_channel::cmd_unregister_event(unsigned int event_type)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_unreg_t));
 	cmd_unreg_t *cmd_unreg;
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_unreg_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_UNREG);
+	packet.set_cmd(CMD_UNREG);
 
-	cmd_unreg = (cmd_unreg_t*)packet->data();
+	cmd_unreg = (cmd_unreg_t*)packet.data();
 	cmd_unreg->event_type = event_type;
 
 	INFO("%s send cmd_unregister_event(client_id=%d, %s)",
 		get_client_name(), m_client_id, get_event_name(event_type));
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command with client_id [%d], event_type[%s]",
 			get_client_name(), m_client_id, get_event_name(event_type));
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("Client %s got error[%d] from server with client_id [%d], event_type[%s]",
 			get_client_name(), cmd_done->value, m_client_id, get_event_name(event_type));
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	return true;
 }
 
@@ -482,90 +493,67 @@ bool command_channel::cmd_unregister_events(event_type_vector &event_vec)
 
 bool command_channel::cmd_set_interval(unsigned int interval)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_set_interval_t));
 	cmd_set_interval_t *cmd_set_interval;
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_set_interval_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_SET_INTERVAL);
+	packet.set_cmd(CMD_SET_INTERVAL);
 
-	cmd_set_interval = (cmd_set_interval_t*)packet->data();
+	cmd_set_interval = (cmd_set_interval_t*)packet.data();
 	cmd_set_interval->interval = interval;
 
 	INFO("%s send cmd_set_interval(client_id=%d, %s, interval=%d)",
 		get_client_name(), m_client_id, get_sensor_name(m_sensor_id), interval);
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("%s failed to send/receive command for sensor[%s] with client_id [%d], interval[%d]",
 			get_client_name(), get_sensor_name(m_sensor_id), m_client_id, interval);
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("%s got error[%d] from server for sensor[%s] with client_id [%d], interval[%d]",
 			get_client_name(), cmd_done->value, get_sensor_name(m_sensor_id), m_client_id, interval);
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	return true;
 }
 
 bool command_channel::cmd_unset_interval(void)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_unset_interval_t));
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_unset_interval_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
-
-	packet->set_cmd(CMD_UNSET_INTERVAL);
+	packet.set_cmd(CMD_UNSET_INTERVAL);
 
 	INFO("%s send cmd_unset_interval(client_id=%d, %s)",
 		get_client_name(), m_client_id, get_sensor_name(m_sensor_id));
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command for sensor[%s] with client_id [%d]",
 			get_client_name(), get_sensor_name(m_sensor_id), m_client_id);
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("Client %s got error[%d] from server for sensor[%s] with client_id [%d]",
 			get_client_name(), cmd_done->value, get_sensor_name(m_sensor_id), m_client_id);
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	return true;
 }
 
 bool command_channel::cmd_set_command(unsigned int cmd, long value)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_set_command_t));
 	cmd_set_command_t *cmd_set_command;
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_set_command_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
+	packet.set_cmd(CMD_SET_COMMAND);
 
-	packet->set_cmd(CMD_SET_COMMAND);
-
-	cmd_set_command = (cmd_set_command_t*)packet->data();
+	cmd_set_command = (cmd_set_command_t*)packet.data();
 	cmd_set_command->cmd = cmd;
 	cmd_set_command->value = value;
 
@@ -573,46 +561,35 @@ bool command_channel::cmd_set_command(unsigned int cmd, long value)
 	INFO("%s send cmd_set_command(client_id=%d, %s, 0x%x, %ld)",
 		get_client_name(), m_client_id, get_sensor_name(m_sensor_id), cmd, value);
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("Client %s failed to send/receive command for sensor[%s] with client_id [%d], property[0x%x], value[%d]",
 			get_client_name(), get_sensor_name(m_sensor_id), m_client_id, cmd, value);
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("Client %s got error[%d] from server for sensor[%s] with property[0x%x], value[%d]",
 			get_client_name(), cmd_done->value, get_sensor_name(m_sensor_id), cmd, value);
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
-
 	return true;
 }
 
 bool command_channel::cmd_get_data(unsigned int type, sensor_data_t* sensor_data)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_get_data_t));
 	cmd_get_data_t *cmd_get_data;
 	cmd_get_data_done_t *cmd_get_data_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_get_data_done_t));
-	retvm_if(!packet, false, "Failed to allocate memory");
+	packet.set_cmd(CMD_GET_DATA);
 
-	packet->set_cmd(CMD_GET_DATA);
-
-	cmd_get_data = (cmd_get_data_t*)packet->data();
+	cmd_get_data = (cmd_get_data_t*)packet.data();
 	cmd_get_data->type = type;
 
-	if (!command_handler(packet, (void **)&cmd_get_data_done)) {
+	if (!command_handler(&packet, (void **)&cmd_get_data_done)) {
 		ERR("Client %s failed to send/receive command with client_id [%d], data_id[%s]",
 			get_client_name(), m_client_id, get_data_name(type));
-		delete packet;
 		return false;
 	}
 
@@ -622,8 +599,6 @@ bool command_channel::cmd_get_data(unsigned int type, sensor_data_t* sensor_data
 		sensor_data->accuracy = SENSOR_ACCURACY_UNDEFINED;
 		sensor_data->timestamp = 0;
 		sensor_data->value_count = 0;
-		delete[] (char *)cmd_get_data_done;
-		delete packet;
 		return false;
 	}
 
@@ -637,24 +612,20 @@ bool command_channel::cmd_get_data(unsigned int type, sensor_data_t* sensor_data
 	memcpy(sensor_data->values, base_data->values,
 		sizeof(sensor_data->values[0]) * base_data->value_count);
 
-	delete[] (char *)cmd_get_data_done;
-	delete packet;
-
 	return true;
 }
 
 bool command_channel::cmd_send_sensorhub_data(const char* buffer, int data_len)
 {
-	cpacket *packet;
+	cpacket packet(sizeof(cmd_send_sensorhub_data_t) + data_len);
 	cmd_send_sensorhub_data_t *cmd_send_sensorhub_data;
 	cmd_done_t *cmd_done;
 
-	packet = new(std::nothrow) cpacket(sizeof(cmd_send_sensorhub_data_t) + data_len);
-	retvm_if(!packet, false, "Failed to allocate memory");
+	retvm_if(!packet.data(), false, "Failed to allocate memory");
 
-	packet->set_cmd(CMD_SEND_SENSORHUB_DATA);
+	packet.set_cmd(CMD_SEND_SENSORHUB_DATA);
 
-	cmd_send_sensorhub_data = (cmd_send_sensorhub_data_t*)packet->data();
+	cmd_send_sensorhub_data = (cmd_send_sensorhub_data_t*)packet.data();
 	cmd_send_sensorhub_data->data_len = data_len;
 	memcpy(cmd_send_sensorhub_data->data, buffer, data_len);
 
@@ -662,24 +633,18 @@ bool command_channel::cmd_send_sensorhub_data(const char* buffer, int data_len)
 	INFO("%s send cmd_send_sensorhub_data(client_id=%d, data_len = %d, buffer = 0x%x)",
 		get_client_name(), m_client_id, data_len, buffer);
 
-	if (!command_handler(packet, (void **)&cmd_done)) {
+	if (!command_handler(&packet, (void **)&cmd_done)) {
 		ERR("%s failed to send/receive command with client_id [%d]",
 			get_client_name(), m_client_id);
-		delete packet;
 		return false;
 	}
 
 	if (cmd_done->value < 0) {
 		ERR("%s got error[%d] from server with client_id [%d]",
 			get_client_name(), cmd_done->value, m_client_id);
-
-		delete[] (char *)cmd_done;
-		delete packet;
 		return false;
 	}
 
-	delete[] (char *)cmd_done;
-	delete packet;
 
 	return true;
 
@@ -23,6 +23,7 @@
 #include <sensor_internal.h>
 #include <cpacket.h>
 #include <csocket.h>
+#include <cmutex.h>
 #include <vector>
 
 using std::vector;
@@ -35,6 +36,11 @@ public:
 	~command_channel();
 
 	bool create_channel(void);
+	void attach_channel(command_channel *mux_channel);
+
+	void begin_batch(void);
+	bool end_batch(void);
+	void cancel_batch(void);
 	void set_client_id(int client_id);
 
 	bool cmd_get_id(int &client_id);
@@ -55,9 +61,18 @@ public:
 	bool cmd_send_sensorhub_data(const char* buffer, int data_len);
 private:
 	csocket m_command_socket;
+	cmutex m_mutex;
+	cpacket m_reply;
+	command_channel *m_mux_channel;
 	int m_client_id;
 	sensor_id_t m_sensor_id;
+	bool m_batching;
+	int m_batch_cnt;
+	vector<char> m_batch;
+	cmd_done_t m_queued_done;
 	bool command_handler(cpacket *packet, void **return_payload);
+	bool queue_command(cpacket *packet, void **return_payload);
+	bool transact(cpacket *packet, void **return_payload);
 };
 
 #endif /* COMMAND_CHANNEL_H_ */
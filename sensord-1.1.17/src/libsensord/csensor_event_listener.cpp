@@ -29,7 +29,8 @@ using std::thread;
 using std::pair;
 
 csensor_event_listener::csensor_event_listener()
-: m_client_id(CLIENT_ID_INVALID)
+: m_mux_channel(NULL)
+, m_client_id(CLIENT_ID_INVALID)
 , m_thread_state(THREAD_STATE_TERMINATE)
 , m_poller(NULL)
 , m_hup_observer(NULL)
@@ -365,6 +366,29 @@ void csensor_event_listener::operate_sensor(sensor_id_t sensor, int power_save_s
 	}
 }
 
+/*
+ * All sensors of a process share one connection to the server, opened with
+ * the first of them, instead of a connection and a command worker each
+ */
+bool csensor_event_listener::attach_command_channel(command_channel *cmd_channel)
+{
+	if (!m_mux_channel) {
+		m_mux_channel = new(std::nothrow) command_channel();
+		retvm_if(!m_mux_channel, false, "Failed to allocate memory");
+
+		if (!m_mux_channel->create_channel()) {
+			ERR("%s failed to create multiplexed command channel", get_client_name());
+			delete m_mux_channel;
+			m_mux_channel = NULL;
+			return false;
+		}
+	}
+
+	cmd_channel->attach_channel(m_mux_channel);
+
+	return true;
+}
+
 bool csensor_event_listener::add_command_channel(sensor_id_t sensor, command_channel *cmd_channel)
 {
 	auto it_channel = m_command_channels.find(sensor);
@@ -398,13 +422,16 @@ bool csensor_event_listener::close_command_channel(void)
 {
 	auto it_channel = m_command_channels.begin();
 
-	if (it_channel != m_command_channels.end()) {
+	while (it_channel != m_command_channels.end()) {
 		delete it_channel->second;
 		++it_channel;
 	}
 
 	m_command_channels.clear();
 
+	delete m_mux_channel;
+	m_mux_channel = NULL;
+
 	return true;
 }
 
@@ -421,6 +448,11 @@ bool csensor_event_listener::close_command_channel(sensor_id_t sensor_id)
 
 	m_command_channels.erase(it_channel);
 
+	if (m_command_channels.empty()) {
+		delete m_mux_channel;
+		m_mux_channel = NULL;
+	}
+
 	return true;
 }
 
@@ -660,6 +692,7 @@ void csensor_event_listener::handle_events(void* event)
 
 	sensor_panning_data_t panning_data;
 	int single_state_event_data = 0;
+	sensorhub_event_t hub_event;
 
 	int accuracy = SENSOR_ACCURACY_GOOD;
 
@@ -670,7 +703,8 @@ void csensor_event_listener::handle_events(void* event)
 	vector<client_callback_info *> client_callback_infos;
 
 	if (is_hub_event) {
-		sensorhub_event_t *sensor_hub_event = (sensorhub_event_t *)event;
+		sensorhub_event_t *sensor_hub_event = &hub_event;
+		expand_sensorhub_event(sensor_hub_event, (compact_sensorhub_event_t *)event);
 		sensor_id = sensor_hub_event->sensor_id;
 		sensor_data = &(sensor_hub_event->data);
 		cur_time = sensor_hub_event->data.timestamp;
@@ -928,7 +962,12 @@ bool csensor_event_listener::sensor_event_poll(void* buffer, int buffer_len, int
 
 void csensor_event_listener::listen_events(void)
 {
-	sensorhub_event_t buffer;
+	/* Received events are read in place, so keep the buffer aligned for both event layouts */
+	union {
+		sensor_event_t sensor_event;
+		compact_sensorhub_event_t sensorhub_event;
+		char bytes[sizeof(compact_sensorhub_event_t) + SENSOR_HUB_DATA_SIZE];
+	} buffer;
 	int event;
 
 	do {
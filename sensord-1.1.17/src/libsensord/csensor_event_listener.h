@@ -117,6 +117,7 @@ public:
 	bool is_sensor_registered(sensor_id_t sensor_id);
 	bool is_sensor_active(sensor_id_t sensor_id);
 
+	bool attach_command_channel(command_channel *cmd_channel);
 	bool add_command_channel(sensor_id_t sensor_id, command_channel *cmd_channel);
 	bool get_command_channel(sensor_id_t sensor_id, command_channel **cmd_channel);
 	bool close_command_channel(void);
@@ -140,6 +141,7 @@ private:
 
 	sensor_handle_info_map m_sensor_handle_infos;
 	sensor_command_channel_map m_command_channels;
+	command_channel *m_mux_channel;
 
 	int m_client_id;
 
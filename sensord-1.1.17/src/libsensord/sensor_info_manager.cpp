@@ -18,6 +18,7 @@
  */
 
 #include <sensor_info_manager.h>
+#include <common.h>
 #include <utility>
 
 using std::pair;
@@ -61,6 +62,53 @@ void sensor_info_manager::add_info(sensor_info* info)
 	m_info_set.insert(info);
 }
 
+/*
+ * Adds every sensor of a serialized list, laid out as
+ * cmd_get_sensor_list_done_t. The sizes are checked against size before
+ * anything is added, since the list may come from the published file
+ */
+bool sensor_info_manager::add_infos(const char *list, size_t size)
+{
+	const cmd_get_sensor_list_done_t *sensor_list;
+	const size_t *size_field;
+	const char *raw_data_field;
+	size_t raw_data_size;
+	size_t idx = 0;
+	int sensor_cnt;
+	sensor_info *info;
+
+	retvm_if(size < sizeof(cmd_get_sensor_list_done_t), false, "Invalid sensor list size : %d", size);
+
+	sensor_list = (const cmd_get_sensor_list_done_t *)list;
+	sensor_cnt = sensor_list->sensor_cnt;
+	size -= sizeof(cmd_get_sensor_list_done_t);
+
+	retvm_if((sensor_cnt < 0) || ((size / sizeof(size_t)) < (size_t) sensor_cnt), false,
+		"Invalid sensor count : %d", sensor_cnt);
+
+	size_field = (const size_t *)sensor_list->data;
+	raw_data_field = (const char *)(size_field + sensor_cnt);
+	raw_data_size = size - (sizeof(size_t) * sensor_cnt);
+
+	for (int i = 0; i < sensor_cnt; ++i) {
+		retvm_if(size_field[i] > raw_data_size - idx, false, "Invalid size of sensor #%d : %d", i, size_field[i]);
+		idx += size_field[i];
+	}
+
+	idx = 0;
+
+	for (int i = 0; i < sensor_cnt; ++i) {
+		info = new(std::nothrow) sensor_info;
+		retvm_if(!info, false, "Failed to allocate memory");
+
+		info->set_raw_data(raw_data_field + idx, size_field[i]);
+		add_info(info);
+		idx += size_field[i];
+	}
+
+	return true;
+}
+
 vector<sensor_info *> sensor_info_manager::get_infos(sensor_type_t type)
 {
 	vector<sensor_info *> sensor_infos;
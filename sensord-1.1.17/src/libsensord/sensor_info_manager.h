@@ -38,6 +38,7 @@ public:
 	const sensor_info* get_info(sensor_id_t id);
 	bool is_valid(sensor_info* info);
 	void add_info(sensor_info* info);
+	bool add_infos(const char *list, size_t size);
 
 private:
 	typedef multimap<sensor_type_t, sensor_info*> sensor_infos;
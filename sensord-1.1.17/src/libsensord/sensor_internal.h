@@ -59,6 +59,7 @@ extern "C"
 #include <sensor_orientation.h>
 #include <sensor_rv.h>
 #include <sensor_rv_raw.h>
+#include <sensor_game_rv.h>
 #include <sensor_pir.h>
 #include <sensor_pir_long.h>
 #include <sensor_temperature.h>
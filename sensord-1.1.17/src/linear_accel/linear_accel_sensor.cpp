@@ -54,7 +54,6 @@
 
 linear_accel_sensor::linear_accel_sensor()
 : m_accel_sensor(NULL)
-, m_gravity_sensor(NULL)
 , m_x(INITIAL_VALUE)
 , m_y(INITIAL_VALUE)
 , m_z(INITIAL_VALUE)
@@ -127,12 +126,13 @@ linear_accel_sensor::~linear_accel_sensor()
 
 bool linear_accel_sensor::init()
 {
-	m_gravity_sensor = sensor_plugin_loader::get_instance().get_sensor(GRAVITY_SENSOR);
-	m_accel_sensor = sensor_plugin_loader::get_instance().get_sensor(ACCELEROMETER_SENSOR);
+	if (!load_input_sensors(SENSOR_TYPE_LINEAR_ACCEL))
+		return false;
+
+	m_accel_sensor = get_input_sensor(ACCELEROMETER_SENSOR);
 
-	if (!m_accel_sensor || !m_gravity_sensor) {
-		ERR("Failed to load sensors,  accel: 0x%x, gravity: 0x%x",
-			m_accel_sensor, m_gravity_sensor);
+	if (!m_accel_sensor) {
+		ERR("Accelerometer is not an input of %s", sensor_base::get_name());
 		return false;
 	}
 
@@ -148,11 +148,9 @@ sensor_type_t linear_accel_sensor::get_type(void)
 bool linear_accel_sensor::on_start(void)
 {
 	AUTOLOCK(m_mutex);
-	m_gravity_sensor->add_client(GRAVITY_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_gravity_sensor->start();
+	start_input_sensors();
 
-	m_accel_sensor->add_client(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_accel_sensor->start();
+	m_resampler.reset();
 
 	activate();
 	return true;
@@ -161,47 +159,20 @@ bool linear_accel_sensor::on_start(void)
 bool linear_accel_sensor::on_stop(void)
 {
 	AUTOLOCK(m_mutex);
-	m_gravity_sensor->delete_client(GRAVITY_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_gravity_sensor->stop();
-
-	m_accel_sensor->delete_client(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_accel_sensor->stop();
+	stop_input_sensors();
 
 	deactivate();
 	return true;
 }
 
-bool linear_accel_sensor::add_interval(int client_id, unsigned int interval, bool is_processor)
-{
-	AUTOLOCK(m_mutex);
-	m_gravity_sensor->add_interval(client_id, interval, true);
-	m_accel_sensor->add_interval(client_id, interval, true);
-
-	return sensor_base::add_interval(client_id, interval, true);
-}
-
-bool linear_accel_sensor::delete_interval(int client_id, bool is_processor)
-{
-	AUTOLOCK(m_mutex);
-	m_gravity_sensor->delete_interval(client_id, true);
-	m_accel_sensor->delete_interval(client_id, true);
-
-	return sensor_base::delete_interval(client_id, true);
-}
-
 void linear_accel_sensor::synthesize(const sensor_event_t &event, vector<sensor_event_t> &outs)
 {
 	sensor_event_t lin_accel_event;
-
-	const float MIN_DELIVERY_DIFF_FACTOR = 0.75f;
-	unsigned long long diff_time;
+	vect<float, 3> lin_accels[RESAMPLER_MAX_OUTPUTS];
+	unsigned long long times[RESAMPLER_MAX_OUTPUTS];
+	int count;
 
 	if (event.event_type == ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME) {
-		diff_time = event.data.timestamp - m_time;
-
-		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
-			return;
-
 		m_accel.m_data.m_vec[0] = m_accel_rotation_direction_compensation[0] * (event.data.values[0] - m_accel_static_bias[0]) / m_accel_scale;
 		m_accel.m_data.m_vec[1] = m_accel_rotation_direction_compensation[1] * (event.data.values[1] - m_accel_static_bias[1]) / m_accel_scale;
 		m_accel.m_data.m_vec[2] = m_accel_rotation_direction_compensation[2] * (event.data.values[2] - m_accel_static_bias[2]) / m_accel_scale;
@@ -211,11 +182,6 @@ void linear_accel_sensor::synthesize(const sensor_event_t &event, vector<sensor_
 		m_enable_linear_accel |= ACCELEROMETER_ENABLED;
 	}
 	else if (event.event_type == GRAVITY_EVENT_RAW_DATA_REPORT_ON_TIME) {
-		diff_time = event.data.timestamp - m_time;
-
-		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
-			return;
-
 		m_gravity.m_data.m_vec[0] = event.data.values[0];
 		m_gravity.m_data.m_vec[1] = event.data.values[1];
 		m_gravity.m_data.m_vec[2] = event.data.values[2];
@@ -228,22 +194,32 @@ void linear_accel_sensor::synthesize(const sensor_event_t &event, vector<sensor_
 	if (m_enable_linear_accel == LINEAR_ACCEL_ENABLED) {
 		m_enable_linear_accel = 0;
 
-		lin_accel_event.sensor_id = get_id();
-		lin_accel_event.event_type = LINEAR_ACCEL_EVENT_RAW_DATA_REPORT_ON_TIME;
-		lin_accel_event.data.value_count = 3;
-		lin_accel_event.data.timestamp = get_timestamp();
-		lin_accel_event.data.accuracy = SENSOR_ACCURACY_GOOD;
-		lin_accel_event.data.values[0] = m_linear_accel_sign_compensation[0] * (m_accel.m_data.m_vec[0] - m_gravity.m_data.m_vec[0]);
-		lin_accel_event.data.values[1] = m_linear_accel_sign_compensation[1] * (m_accel.m_data.m_vec[1] - m_gravity.m_data.m_vec[1]);
-		lin_accel_event.data.values[2] = m_linear_accel_sign_compensation[2] * (m_accel.m_data.m_vec[2] - m_gravity.m_data.m_vec[2]);
-		push(lin_accel_event);
-
-		{
-			AUTOLOCK(m_value_mutex);
-			m_time = lin_accel_event.data.timestamp;
-			m_x = lin_accel_event.data.values[0];
-			m_y = lin_accel_event.data.values[1];
-			m_z = lin_accel_event.data.values[2];
+		vect<float, 3> lin_accel;
+
+		for (int i = 0; i < 3; i++)
+			lin_accel.m_vec[i] = m_linear_accel_sign_compensation[i] * (m_accel.m_data.m_vec[i] - m_gravity.m_data.m_vec[i]);
+
+		count = m_resampler.resample(lin_accel, event.data.timestamp,
+			get_output_interval(m_interval), lin_accels, times, RESAMPLER_MAX_OUTPUTS);
+
+		for (int i = 0; i < count; i++) {
+			lin_accel_event.sensor_id = get_id();
+			lin_accel_event.event_type = LINEAR_ACCEL_EVENT_RAW_DATA_REPORT_ON_TIME;
+			lin_accel_event.data.value_count = 3;
+			lin_accel_event.data.timestamp = times[i];
+			lin_accel_event.data.accuracy = SENSOR_ACCURACY_GOOD;
+			lin_accel_event.data.values[0] = lin_accels[i].m_vec[0];
+			lin_accel_event.data.values[1] = lin_accels[i].m_vec[1];
+			lin_accel_event.data.values[2] = lin_accels[i].m_vec[2];
+			outs.push_back(lin_accel_event);
+
+			{
+				AUTOLOCK(m_value_mutex);
+				m_time = lin_accel_event.data.timestamp;
+				m_x = lin_accel_event.data.values[0];
+				m_y = lin_accel_event.data.values[1];
+				m_z = lin_accel_event.data.values[2];
+			}
 		}
 	}
 
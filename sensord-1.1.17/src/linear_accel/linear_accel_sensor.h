@@ -23,6 +23,7 @@
 #include <sensor_internal.h>
 #include <virtual_sensor.h>
 #include <orientation_filter.h>
+#include <resampler.h>
 
 class linear_accel_sensor : public virtual_sensor {
 public:
@@ -34,18 +35,15 @@ public:
 
 	void synthesize(const sensor_event_t &event, vector<sensor_event_t> &outs);
 
-	bool add_interval(int client_id, unsigned int interval, bool is_processor);
-	bool delete_interval(int client_id, bool is_processor);
-
 	int get_sensor_data(const unsigned int event_type, sensor_data_t &data);
 	bool get_properties(sensor_properties_t &properties);
 private:
 	sensor_base *m_accel_sensor;
-	sensor_base *m_gravity_sensor;
 	cmutex m_value_mutex;
 
 	sensor_data<float> m_accel;
 	sensor_data<float> m_gravity;
+	resampler<float, vect<float, 3> > m_resampler;
 
 	float m_x;
 	float m_y;
@@ -413,6 +413,10 @@ bool motion_sensor::init()
 		++it_motion_event_info;
 	}
 
+	register_input_event(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
+	register_input_event(GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME);
+	register_input_event(PROXIMITY_EVENT_CHANGE_STATE);
+
 	get_motion_setting();
 
 	vconf_notify_key_changed(VCONFKEY_SETAPPL_USE_PICK_UP_CALL, motion_enable_cb, this);
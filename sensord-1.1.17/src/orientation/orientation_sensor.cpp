@@ -29,17 +29,11 @@
 #include <sf_common.h>
 #include <orientation_sensor.h>
 #include <sensor_plugin_loader.h>
-#include <orientation_filter.h>
 #include <cvirtual_sensor_config.h>
 
 #define SENSOR_NAME "ORIENTATION_SENSOR"
 #define SENSOR_TYPE_ORIENTATION		"ORIENTATION"
 
-#define ACCELEROMETER_ENABLED 0x01
-#define GYROSCOPE_ENABLED 0x02
-#define GEOMAGNETIC_ENABLED 0x04
-#define ORIENTATION_ENABLED 7
-
 #define INITIAL_VALUE -1
 
 #define MS_TO_US 1000
@@ -52,31 +46,12 @@
 #define ELEMENT_VENDOR											"VENDOR"
 #define ELEMENT_RAW_DATA_UNIT									"RAW_DATA_UNIT"
 #define ELEMENT_DEFAULT_SAMPLING_TIME							"DEFAULT_SAMPLING_TIME"
-#define ELEMENT_ACCEL_STATIC_BIAS								"ACCEL_STATIC_BIAS"
-#define ELEMENT_GYRO_STATIC_BIAS								"GYRO_STATIC_BIAS"
-#define ELEMENT_GEOMAGNETIC_STATIC_BIAS							"GEOMAGNETIC_STATIC_BIAS"
-#define ELEMENT_ACCEL_ROTATION_DIRECTION_COMPENSATION			"ACCEL_ROTATION_DIRECTION_COMPENSATION"
-#define ELEMENT_GYRO_ROTATION_DIRECTION_COMPENSATION			"GYRO_ROTATION_DIRECTION_COMPENSATION"
-#define ELEMENT_GEOMAGNETIC_ROTATION_DIRECTION_COMPENSATION		"GEOMAGNETIC_ROTATION_DIRECTION_COMPENSATION"
-#define ELEMENT_ACCEL_SCALE										"ACCEL_SCALE"
-#define ELEMENT_GYRO_SCALE										"GYRO_SCALE"
-#define ELEMENT_GEOMAGNETIC_SCALE								"GEOMAGNETIC_SCALE"
-#define ELEMENT_MAGNETIC_ALIGNMENT_FACTOR						"MAGNETIC_ALIGNMENT_FACTOR"
 #define ELEMENT_PITCH_ROTATION_COMPENSATION						"PITCH_ROTATION_COMPENSATION"
 #define ELEMENT_ROLL_ROTATION_COMPENSATION						"ROLL_ROTATION_COMPENSATION"
 #define ELEMENT_AZIMUTH_ROTATION_COMPENSATION					"AZIMUTH_ROTATION_COMPENSATION"
 
-void pre_process_data(sensor_data<float> &data_out, const float *data_in, float *bias, int *sign, float scale)
-{
-	data_out.m_data.m_vec[0] = sign[0] * (data_in[0] - bias[0]) / scale;
-	data_out.m_data.m_vec[1] = sign[1] * (data_in[1] - bias[1]) / scale;
-	data_out.m_data.m_vec[2] = sign[2] * (data_in[2] - bias[2]) / scale;
-}
-
 orientation_sensor::orientation_sensor()
-: m_accel_sensor(NULL)
-, m_gyro_sensor(NULL)
-, m_magnetic_sensor(NULL)
+: m_fusion(NULL)
 , m_roll(INITIAL_VALUE)
 , m_pitch(INITIAL_VALUE)
 , m_azimuth(INITIAL_VALUE)
@@ -86,7 +61,6 @@ orientation_sensor::orientation_sensor()
 
 	m_name = string(SENSOR_NAME);
 	register_supported_event(ORIENTATION_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_enable_orientation = 0;
 	m_time = get_timestamp();
 
 	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_VENDOR, m_vendor)) {
@@ -110,76 +84,6 @@ orientation_sensor::orientation_sensor()
 
 	INFO("m_default_sampling_time = %d", m_default_sampling_time);
 
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_ACCEL_STATIC_BIAS, m_accel_static_bias, 3)) {
-		ERR("[ACCEL_STATIC_BIAS] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_accel_static_bias = (%f, %f, %f)", m_accel_static_bias[0], m_accel_static_bias[1], m_accel_static_bias[2]);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_GYRO_STATIC_BIAS, m_gyro_static_bias,3)) {
-		ERR("[GYRO_STATIC_BIAS] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_gyro_static_bias = (%f, %f, %f)", m_gyro_static_bias[0], m_gyro_static_bias[1], m_gyro_static_bias[2]);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_GEOMAGNETIC_STATIC_BIAS, m_geomagnetic_static_bias, 3)) {
-		ERR("[GEOMAGNETIC_STATIC_BIAS] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_geomagnetic_static_bias = (%f, %f, %f)", m_geomagnetic_static_bias[0], m_geomagnetic_static_bias[1], m_geomagnetic_static_bias[2]);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_ACCEL_ROTATION_DIRECTION_COMPENSATION, m_accel_rotation_direction_compensation, 3)) {
-		ERR("[ACCEL_ROTATION_DIRECTION_COMPENSATION] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_accel_rotation_direction_compensation = (%d, %d, %d)", m_accel_rotation_direction_compensation[0], m_accel_rotation_direction_compensation[1], m_accel_rotation_direction_compensation[2]);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_GYRO_ROTATION_DIRECTION_COMPENSATION, m_gyro_rotation_direction_compensation, 3)) {
-		ERR("[GYRO_ROTATION_DIRECTION_COMPENSATION] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_gyro_rotation_direction_compensation = (%d, %d, %d)", m_gyro_rotation_direction_compensation[0], m_gyro_rotation_direction_compensation[1], m_gyro_rotation_direction_compensation[2]);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_GEOMAGNETIC_ROTATION_DIRECTION_COMPENSATION, m_geomagnetic_rotation_direction_compensation, 3)) {
-		ERR("[GEOMAGNETIC_ROTATION_DIRECTION_COMPENSATION] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_geomagnetic_rotation_direction_compensation = (%d, %d, %d)", m_geomagnetic_rotation_direction_compensation[0], m_geomagnetic_rotation_direction_compensation[1], m_geomagnetic_rotation_direction_compensation[2]);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_ACCEL_SCALE, &m_accel_scale)) {
-		ERR("[ACCEL_SCALE] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_accel_scale = %f", m_accel_scale);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_GYRO_SCALE, &m_gyro_scale)) {
-		ERR("[GYRO_SCALE] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_gyro_scale = %f", m_gyro_scale);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_GEOMAGNETIC_SCALE, &m_geomagnetic_scale)) {
-		ERR("[GEOMAGNETIC_SCALE] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_geomagnetic_scale = %f", m_geomagnetic_scale);
-
-	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_MAGNETIC_ALIGNMENT_FACTOR, &m_magnetic_alignment_factor)) {
-		ERR("[MAGNETIC_ALIGNMENT_FACTOR] is empty\n");
-		throw ENXIO;
-	}
-
-	INFO("m_magnetic_alignment_factor = %d", m_magnetic_alignment_factor);
-
 	if (!config.get(SENSOR_TYPE_ORIENTATION, ELEMENT_AZIMUTH_ROTATION_COMPENSATION, &m_azimuth_rotation_compensation)) {
 		ERR("[AZIMUTH_ROTATION_COMPENSATION] is empty\n");
 		throw ENXIO;
@@ -212,13 +116,13 @@ orientation_sensor::~orientation_sensor()
 
 bool orientation_sensor::init(void)
 {
-	m_accel_sensor = sensor_plugin_loader::get_instance().get_sensor(ACCELEROMETER_SENSOR);
-	m_gyro_sensor = sensor_plugin_loader::get_instance().get_sensor(GYROSCOPE_SENSOR);
-	m_magnetic_sensor = sensor_plugin_loader::get_instance().get_sensor(GEOMAGNETIC_SENSOR);
+	if (!load_input_sensors(SENSOR_TYPE_ORIENTATION))
+		return false;
+
+	m_fusion = static_cast<sensor_fusion *>(get_input_sensor(FUSION_SENSOR));
 
-	if (!m_accel_sensor || !m_gyro_sensor || !m_magnetic_sensor) {
-		ERR("Failed to load sensors,  accel: 0x%x, gyro: 0x%x, mag: 0x%x",
-			m_accel_sensor, m_gyro_sensor, m_magnetic_sensor);
+	if (!m_fusion) {
+		ERR("Fusion sensor is not an input of %s", sensor_base::get_name());
 		return false;
 	}
 
@@ -234,12 +138,9 @@ sensor_type_t orientation_sensor::get_type(void)
 bool orientation_sensor::on_start(void)
 {
 	AUTOLOCK(m_mutex);
-	m_accel_sensor->add_client(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_accel_sensor->start();
-	m_gyro_sensor->add_client(GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_gyro_sensor->start();
-	m_magnetic_sensor->add_client(GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_magnetic_sensor->start();
+	start_input_sensors();
+
+	m_resampler.reset();
 
 	activate();
 	return true;
@@ -248,108 +149,53 @@ bool orientation_sensor::on_start(void)
 bool orientation_sensor::on_stop(void)
 {
 	AUTOLOCK(m_mutex);
-	m_accel_sensor->delete_client(ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_accel_sensor->stop();
-	m_gyro_sensor->delete_client(GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_gyro_sensor->stop();
-	m_magnetic_sensor->delete_client(GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME);
-	m_magnetic_sensor->stop();
+	stop_input_sensors();
 
 	deactivate();
 	return true;
 }
 
-bool orientation_sensor::add_interval(int client_id, unsigned int interval, bool is_processor)
-{
-	AUTOLOCK(m_mutex);
-	m_accel_sensor->add_interval(client_id, interval, true);
-	m_gyro_sensor->add_interval(client_id, interval, true);
-	m_magnetic_sensor->add_interval(client_id, interval, true);
-
-	return sensor_base::add_interval(client_id, interval, true);
-}
-
-bool orientation_sensor::delete_interval(int client_id, bool is_processor)
-{
-	AUTOLOCK(m_mutex);
-	m_accel_sensor->delete_interval(client_id, true);
-	m_gyro_sensor->delete_interval(client_id, true);
-	m_magnetic_sensor->delete_interval(client_id, true);
-
-	return sensor_base::delete_interval(client_id, true);
-}
-
+/*
+ * The fusion attitude is resampled onto this sensor's requested interval
+ * with slerp before it is turned into Euler angles, so the fusion sensor
+ * only has to run as fast as its fastest consumer needs.
+ */
 void orientation_sensor::synthesize(const sensor_event_t &event, vector<sensor_event_t> &outs)
 {
-	const float MIN_DELIVERY_DIFF_FACTOR = 0.75f;
-	unsigned long long diff_time;
-
 	sensor_event_t orientation_event;
-	euler_angles<float> euler_orientation;
+	quaternion<float> quats[RESAMPLER_MAX_OUTPUTS];
+	unsigned long long times[RESAMPLER_MAX_OUTPUTS];
+	float x, y, z, w;
 	float azimuth_offset;
+	int count;
 
-	if (event.event_type == ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME) {
-		diff_time = event.data.timestamp - m_time;
-
-		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
-			return;
-
-		pre_process_data(m_accel, event.data.values, m_accel_static_bias, m_accel_rotation_direction_compensation, m_accel_scale);
-
-		m_accel.m_time_stamp = event.data.timestamp;
-
-		m_enable_orientation |= ACCELEROMETER_ENABLED;
-	}
-	else if (event.event_type == GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME) {
-		diff_time = event.data.timestamp - m_time;
-
-		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
-			return;
+	if (event.event_type != FUSION_EVENT_AGM)
+		return;
 
-		pre_process_data(m_gyro, event.data.values, m_gyro_static_bias, m_gyro_rotation_direction_compensation, m_gyro_scale);
+	if (!m_fusion->get_attitude(x, y, z, w))
+		return;
 
-		m_gyro.m_time_stamp = event.data.timestamp;
+	count = m_resampler.resample(quaternion<float>(w, x, y, z), event.data.timestamp,
+		get_output_interval(m_interval), quats, times, RESAMPLER_MAX_OUTPUTS);
 
-		m_enable_orientation |= GYROSCOPE_ENABLED;
-	}
-	else if (event.event_type == GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME) {
-		diff_time = event.data.timestamp - m_time;
+	if(m_raw_data_unit == "DEGREES")
+		azimuth_offset = AZIMUTH_OFFSET_DEGREES;
+	else
+		azimuth_offset = AZIMUTH_OFFSET_RADIANS;
 
-		if (m_time && (diff_time < m_interval * MIN_DELIVERY_DIFF_FACTOR))
-			return;
+	for (int i = 0; i < count; i++) {
+		euler_angles<float> euler = quat2euler(quats[i]);
 
-		pre_process_data(m_magnetic, event.data.values, m_geomagnetic_static_bias, m_geomagnetic_rotation_direction_compensation, m_geomagnetic_scale);
+		euler_angles<float> euler_orientation(euler.m_ang.m_vec[0] * m_pitch_rotation_compensation,
+			euler.m_ang.m_vec[1] * m_roll_rotation_compensation, euler.m_ang.m_vec[2] * m_azimuth_rotation_compensation);
 
-		m_magnetic.m_time_stamp = event.data.timestamp;
-
-		m_enable_orientation |= GEOMAGNETIC_ENABLED;
-	}
-
-	if (m_enable_orientation == ORIENTATION_ENABLED) {
-		m_enable_orientation = 0;
-
-		m_orientation.m_pitch_phase_compensation = m_pitch_rotation_compensation;
-		m_orientation.m_roll_phase_compensation = m_roll_rotation_compensation;
-		m_orientation.m_azimuth_phase_compensation = m_azimuth_rotation_compensation;
-		m_orientation.m_magnetic_alignment_factor = m_magnetic_alignment_factor;
-
-		{
-			AUTOLOCK(m_fusion_mutex);
-			euler_orientation = m_orientation.get_orientation(m_accel, m_gyro, m_magnetic);
-		}
-
-		if(m_raw_data_unit == "DEGREES") {
+		if(m_raw_data_unit == "DEGREES")
 			euler_orientation = rad2deg(euler_orientation);
-			azimuth_offset = AZIMUTH_OFFSET_DEGREES;
-		}
-		else {
-			azimuth_offset = AZIMUTH_OFFSET_RADIANS;
-		}
 
 		orientation_event.sensor_id = get_id();
 		orientation_event.event_type = ORIENTATION_EVENT_RAW_DATA_REPORT_ON_TIME;
 		orientation_event.data.accuracy = SENSOR_ACCURACY_GOOD;
-		orientation_event.data.timestamp = get_timestamp();
+		orientation_event.data.timestamp = times[i];
 		orientation_event.data.value_count = 3;
 		orientation_event.data.values[1] = euler_orientation.m_ang.m_vec[0];
 		orientation_event.data.values[2] = euler_orientation.m_ang.m_vec[1];
@@ -366,10 +212,8 @@ void orientation_sensor::synthesize(const sensor_event_t &event, vector<sensor_e
 			m_roll = orientation_event.data.values[2];
 		}
 
-		push(orientation_event);
+		outs.push_back(orientation_event);
 	}
-
-	return;
 }
 
 int orientation_sensor::get_sensor_data(const unsigned int event_type, sensor_data_t &data)
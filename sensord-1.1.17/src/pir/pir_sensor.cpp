@@ -31,7 +31,7 @@ pir_sensor::pir_sensor()
 {
 	m_name = string(SENSOR_NAME);
 
-	register_supported_event(PIR_EVENT_CHANGE_STATE);
+	register_on_change_event(PIR_EVENT_CHANGE_STATE);
 
 	physical_sensor::set_poller(pir_sensor::working, this);
 }
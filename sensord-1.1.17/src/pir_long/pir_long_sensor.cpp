@@ -31,7 +31,7 @@ pir_long_sensor::pir_long_sensor()
 {
 	m_name = string(SENSOR_NAME);
 
-	register_supported_event(PIR_LONG_EVENT_CHANGE_STATE);
+	register_on_change_event(PIR_LONG_EVENT_CHANGE_STATE);
 
 	physical_sensor::set_poller(pir_long_sensor::working, this);
 }
@@ -32,7 +32,7 @@ proxi_sensor::proxi_sensor()
 {
 	m_name = string(SENSOR_NAME);
 
-	register_supported_event(PROXIMITY_EVENT_CHANGE_STATE);
+	register_on_change_event(PROXIMITY_EVENT_CHANGE_STATE);
 	register_supported_event(PROXIMITY_EVENT_STATE_REPORT_ON_TIME);
 	register_supported_event(PROXIMITY_EVENT_DISTANCE_DATA_REPORT_ON_TIME);
 
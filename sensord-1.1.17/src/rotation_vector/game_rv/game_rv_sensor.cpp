@@ -0,0 +1,288 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <sys/types.h>
+#include <dlfcn.h>
+#include <common.h>
+#include <sf_common.h>
+#include <game_rv_sensor.h>
+#include <sensor_plugin_loader.h>
+#include <cvirtual_sensor_config.h>
+
+#define SENSOR_NAME "GAME_RV_SENSOR"
+#define SENSOR_TYPE_GAME_RV		"GAME_ROTATION_VECTOR"
+
+#define MS_TO_US 1000
+
+#define ELEMENT_VENDOR											"VENDOR"
+#define ELEMENT_RAW_DATA_UNIT									"RAW_DATA_UNIT"
+#define ELEMENT_DEFAULT_SAMPLING_TIME							"DEFAULT_SAMPLING_TIME"
+#define ELEMENT_ACCEL_STATIC_BIAS								"ACCEL_STATIC_BIAS"
+#define ELEMENT_GYRO_STATIC_BIAS								"GYRO_STATIC_BIAS"
+#define ELEMENT_ACCEL_ROTATION_DIRECTION_COMPENSATION			"ACCEL_ROTATION_DIRECTION_COMPENSATION"
+#define ELEMENT_GYRO_ROTATION_DIRECTION_COMPENSATION			"GYRO_ROTATION_DIRECTION_COMPENSATION"
+#define ELEMENT_ACCEL_SCALE										"ACCEL_SCALE"
+#define ELEMENT_GYRO_SCALE										"GYRO_SCALE"
+#define ELEMENT_MAHONY_GAINS									"MAHONY_GAINS"
+
+void pre_process_data(sensor_data<float> &data_out, const float *data_in, float *bias, int *sign, float scale)
+{
+	data_out.m_data.m_vec[0] = sign[0] * (data_in[0] - bias[0]) / scale;
+	data_out.m_data.m_vec[1] = sign[1] * (data_in[1] - bias[1]) / scale;
+	data_out.m_data.m_vec[2] = sign[2] * (data_in[2] - bias[2]) / scale;
+}
+
+game_rv_sensor::game_rv_sensor()
+: m_accel_ready(false)
+, m_x(-1)
+, m_y(-1)
+, m_z(-1)
+, m_w(-1)
+, m_time(0)
+{
+	cvirtual_sensor_config &config = cvirtual_sensor_config::get_instance();
+	float mahony_gains[2];
+
+	m_name = string(SENSOR_NAME);
+	register_supported_event(GAME_ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME);
+
+	if (!config.get(SENSOR_TYPE_GAME_RV, ELEMENT_VENDOR, m_vendor)) {
+		ERR("[VENDOR] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_vendor = %s", m_vendor.c_str());
+
+	if (!config.get(SENSOR_TYPE_GAME_RV, ELEMENT_DEFAULT_SAMPLING_TIME, &m_default_sampling_time)) {
+		ERR("[DEFAULT_SAMPLING_TIME] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_default_sampling_time = %d", m_default_sampling_time);
+
+	if (!config.get(SENSOR_TYPE_GAME_RV, ELEMENT_ACCEL_STATIC_BIAS, m_accel_static_bias, 3)) {
+		ERR("[ACCEL_STATIC_BIAS] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_accel_static_bias = (%f, %f, %f)", m_accel_static_bias[0], m_accel_static_bias[1], m_accel_static_bias[2]);
+
+	if (!config.get(SENSOR_TYPE_GAME_RV, ELEMENT_GYRO_STATIC_BIAS, m_gyro_static_bias, 3)) {
+		ERR("[GYRO_STATIC_BIAS] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_gyro_static_bias = (%f, %f, %f)", m_gyro_static_bias[0], m_gyro_static_bias[1], m_gyro_static_bias[2]);
+
+	if (!config.get(SENSOR_TYPE_GAME_RV, ELEMENT_ACCEL_ROTATION_DIRECTION_COMPENSATION, m_accel_rotation_direction_compensation, 3)) {
+		ERR("[ACCEL_ROTATION_DIRECTION_COMPENSATION] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_accel_rotation_direction_compensation = (%d, %d, %d)", m_accel_rotation_direction_compensation[0], m_accel_rotation_direction_compensation[1], m_accel_rotation_direction_compensation[2]);
+
+	if (!config.get(SENSOR_TYPE_GAME_RV, ELEMENT_GYRO_ROTATION_DIRECTION_COMPENSATION, m_gyro_rotation_direction_compensation, 3)) {
+		ERR("[GYRO_ROTATION_DIRECTION_COMPENSATION] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_gyro_rotation_direction_compensation = (%d, %d, %d)", m_gyro_rotation_direction_compensation[0], m_gyro_rotation_direction_compensation[1], m_gyro_rotation_direction_compensation[2]);
+
+	if (!config.get(SENSOR_TYPE_GAME_RV, ELEMENT_ACCEL_SCALE, &m_accel_scale)) {
+		ERR("[ACCEL_SCALE] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_accel_scale = %f", m_accel_scale);
+
+	if (!config.get(SENSOR_TYPE_GAME_RV, ELEMENT_GYRO_SCALE, &m_gyro_scale)) {
+		ERR("[GYRO_SCALE] is empty\n");
+		throw ENXIO;
+	}
+
+	INFO("m_gyro_scale = %f", m_gyro_scale);
+
+	if (config.get(SENSOR_TYPE_GAME_RV, ELEMENT_MAHONY_GAINS, mahony_gains, 2)) {
+		INFO("mahony_gains = (%f, %f)", mahony_gains[0], mahony_gains[1]);
+		m_filter.set_gains(mahony_gains[0], mahony_gains[1]);
+	}
+
+	m_interval = m_default_sampling_time * MS_TO_US;
+}
+
+game_rv_sensor::~game_rv_sensor()
+{
+	INFO("game_rv_sensor is destroyed!\n");
+}
+
+bool game_rv_sensor::init()
+{
+	if (!load_input_sensors(SENSOR_TYPE_GAME_RV))
+		return false;
+
+	if (!get_input_sensor(ACCELEROMETER_SENSOR) || !get_input_sensor(GYROSCOPE_SENSOR)) {
+		ERR("Accelerometer and gyroscope must both be inputs of %s", sensor_base::get_name());
+		return false;
+	}
+
+	INFO("%s is created!\n", sensor_base::get_name());
+
+	return true;
+}
+
+sensor_type_t game_rv_sensor::get_type(void)
+{
+	return GAME_ROTATION_VECTOR_SENSOR;
+}
+
+bool game_rv_sensor::on_start(void)
+{
+	AUTOLOCK(m_mutex);
+	start_input_sensors();
+
+	m_accel_ready = false;
+	m_filter.m_initialized = false;
+	m_resampler.reset();
+
+	activate();
+	return true;
+}
+
+bool game_rv_sensor::on_stop(void)
+{
+	AUTOLOCK(m_mutex);
+	stop_input_sensors();
+
+	deactivate();
+	return true;
+}
+
+/*
+ * Accelerometer events only refresh the gravity reference; every gyroscope
+ * event steps the filter, and the result is resampled onto the requested
+ * interval without ever waiting on a magnetometer sample.
+ */
+void game_rv_sensor::synthesize(const sensor_event_t& event, vector<sensor_event_t> &outs)
+{
+	sensor_event_t rv_event;
+	quaternion<float> quat;
+	quaternion<float> quats[RESAMPLER_MAX_OUTPUTS];
+	unsigned long long times[RESAMPLER_MAX_OUTPUTS];
+	int count;
+
+	if (event.event_type == ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME) {
+		pre_process_data(m_accel, event.data.values, m_accel_static_bias, m_accel_rotation_direction_compensation, m_accel_scale);
+		m_accel.m_time_stamp = event.data.timestamp;
+		m_accel_ready = true;
+		return;
+	}
+
+	if (event.event_type != GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME)
+		return;
+
+	if (!m_accel_ready)
+		return;
+
+	pre_process_data(m_gyro, event.data.values, m_gyro_static_bias, m_gyro_rotation_direction_compensation, m_gyro_scale);
+	m_gyro.m_time_stamp = event.data.timestamp;
+
+	quat = m_filter.get_quaternion(m_accel, m_gyro);
+
+	count = m_resampler.resample(quat, event.data.timestamp,
+		get_output_interval(m_interval), quats, times, RESAMPLER_MAX_OUTPUTS);
+
+	for (int i = 0; i < count; i++) {
+		rv_event.sensor_id = get_id();
+		rv_event.event_type = GAME_ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME;
+		rv_event.data.accuracy = SENSOR_ACCURACY_GOOD;
+		rv_event.data.timestamp = times[i];
+		rv_event.data.value_count = 4;
+		rv_event.data.values[0] = quats[i].m_quat.m_vec[1];
+		rv_event.data.values[1] = quats[i].m_quat.m_vec[2];
+		rv_event.data.values[2] = quats[i].m_quat.m_vec[3];
+		rv_event.data.values[3] = quats[i].m_quat.m_vec[0];
+
+		outs.push_back(rv_event);
+
+		{
+			AUTOLOCK(m_value_mutex);
+			m_time = rv_event.data.timestamp;
+			m_x = rv_event.data.values[0];
+			m_y = rv_event.data.values[1];
+			m_z = rv_event.data.values[2];
+			m_w = rv_event.data.values[3];
+		}
+	}
+}
+
+int game_rv_sensor::get_sensor_data(unsigned int data_id, sensor_data_t &data)
+{
+	if (data_id != GAME_ROTATION_VECTOR_BASE_DATA_SET)
+		return -1;
+
+	data.accuracy = SENSOR_ACCURACY_GOOD;
+
+	AUTOLOCK(m_value_mutex);
+	data.timestamp = m_time;
+	data.values[0] = m_x;
+	data.values[1] = m_y;
+	data.values[2] = m_z;
+	data.values[3] = m_w;
+	data.value_count = 4;
+
+	return 0;
+}
+
+bool game_rv_sensor::get_properties(sensor_properties_t &properties)
+{
+	properties.vendor = m_vendor;
+	properties.name = SENSOR_NAME;
+	properties.min_range = 0;
+	properties.max_range = 1;
+	properties.resolution = 0.000001;
+	properties.fifo_count = 0;
+	properties.max_batch_count = 0;
+	properties.min_interval = 1;
+
+	return true;
+}
+
+extern "C" sensor_module* create(void)
+{
+	game_rv_sensor *sensor;
+
+	try {
+		sensor = new(std::nothrow) game_rv_sensor;
+	} catch (int err) {
+		ERR("Failed to create module, err: %d, cause: %s", err, strerror(err));
+		return NULL;
+	}
+
+	sensor_module *module = new(std::nothrow) sensor_module;
+	retvm_if(!module || !sensor, NULL, "Failed to allocate memory");
+
+	module->sensors.push_back(sensor);
+	return module;
+}
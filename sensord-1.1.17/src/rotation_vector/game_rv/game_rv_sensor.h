@@ -0,0 +1,74 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _GAME_RV_SENSOR_H_
+#define _GAME_RV_SENSOR_H_
+
+#include <sensor_internal.h>
+#include <virtual_sensor.h>
+#include <mahony_filter.h>
+#include <resampler.h>
+
+class game_rv_sensor : public virtual_sensor {
+public:
+	game_rv_sensor();
+	virtual ~game_rv_sensor();
+
+	bool init(void);
+
+	void synthesize(const sensor_event_t &event, vector<sensor_event_t> &outs);
+
+	bool get_properties(sensor_properties_t &properties);
+	sensor_type_t get_type(void);
+
+	int get_sensor_data(const unsigned int data_id, sensor_data_t &data);
+
+private:
+	sensor_data<float> m_accel;
+	sensor_data<float> m_gyro;
+
+	mahony_filter<float> m_filter;
+	resampler<float, quaternion<float> > m_resampler;
+
+	cmutex m_value_mutex;
+
+	bool m_accel_ready;
+
+	float m_x;
+	float m_y;
+	float m_z;
+	float m_w;
+	unsigned long long m_time;
+	unsigned int m_interval;
+
+	string m_vendor;
+	string m_raw_data_unit;
+	int m_default_sampling_time;
+	float m_accel_static_bias[3];
+	float m_gyro_static_bias[3];
+	int m_accel_rotation_direction_compensation[3];
+	int m_gyro_rotation_direction_compensation[3];
+	float m_accel_scale;
+	float m_gyro_scale;
+
+	bool on_start(void);
+	bool on_stop(void);
+};
+
+#endif /*_GAME_RV_SENSOR_H_*/
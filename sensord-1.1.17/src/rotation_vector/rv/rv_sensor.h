@@ -22,7 +22,8 @@
 
 #include <sensor_internal.h>
 #include <virtual_sensor.h>
-#include <orientation_filter.h>
+#include <sensor_fusion.h>
+#include <resampler.h>
 
 class rv_sensor : public virtual_sensor {
 public:
@@ -33,28 +34,17 @@ public:
 
 	void synthesize(const sensor_event_t &event, vector<sensor_event_t> &outs);
 
-	bool add_interval(int client_id, unsigned int interval, bool is_processor);
-	bool delete_interval(int client_id, bool is_processor);
 	bool get_properties(sensor_properties_t &properties);
 	sensor_type_t get_type(void);
 
 	int get_sensor_data(const unsigned int data_id, sensor_data_t &data);
 
 private:
-	sensor_base *m_accel_sensor;
-	sensor_base *m_gyro_sensor;
-	sensor_base *m_magnetic_sensor;
-
-	sensor_data<float> m_accel;
-	sensor_data<float> m_gyro;
-	sensor_data<float> m_magnetic;
+	sensor_fusion *m_fusion;
+	resampler<float, quaternion<float> > m_resampler;
 
 	cmutex m_value_mutex;
 
-	orientation_filter<float> m_orientation;
-
-	unsigned int m_enable_orientation;
-
 	float m_x;
 	float m_y;
 	float m_z;
@@ -66,19 +56,6 @@ private:
 	string m_vendor;
 	string m_raw_data_unit;
 	int m_default_sampling_time;
-	float m_accel_static_bias[3];
-	float m_gyro_static_bias[3];
-	float m_geomagnetic_static_bias[3];
-	int m_accel_rotation_direction_compensation[3];
-	int m_gyro_rotation_direction_compensation[3];
-	int m_geomagnetic_rotation_direction_compensation[3];
-	float m_accel_scale;
-	float m_gyro_scale;
-	float m_geomagnetic_scale;
-	int m_magnetic_alignment_factor;
-	int m_azimuth_rotation_compensation;
-	int m_pitch_rotation_compensation;
-	int m_roll_rotation_compensation;
 
 	bool on_start(void);
 	bool on_stop(void);
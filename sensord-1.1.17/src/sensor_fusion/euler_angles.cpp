@@ -20,26 +20,24 @@
 
 #include <math.h>
 
-#define EULER_SIZE 3
 #define RAD2DEG 57.2957795
 #define DEG2RAD 0.0174532925
 
 template <typename TYPE>
-euler_angles<TYPE>::euler_angles() : m_ang(EULER_SIZE)
+euler_angles<TYPE>::euler_angles()
 {
 }
 
 template <typename TYPE>
 euler_angles<TYPE>::euler_angles(const TYPE roll, const TYPE pitch, const TYPE azimuth)
 {
-	TYPE euler_data[EULER_SIZE] = {roll, pitch, azimuth};
-
-	vect<TYPE> v(EULER_SIZE, euler_data);
-	m_ang = v;
+	m_ang.m_vec[0] = roll;
+	m_ang.m_vec[1] = pitch;
+	m_ang.m_vec[2] = azimuth;
 }
 
 template <typename TYPE>
-euler_angles<TYPE>::euler_angles(const vect<TYPE> v)
+euler_angles<TYPE>::euler_angles(const vect<TYPE, EULER_SIZE>& v)
 {
 	m_ang = v;
 }
@@ -82,9 +80,9 @@ euler_angles<T> quat2euler(const quaternion<T> q)
 	R32 = 2 * ((y * z) - (w * x));
 	R33 = 2 * (w * w) - 1 + 2 * (z * z);
 
-	phi = atan2(R32, R33);
-	theta = atan2(-R31 , sqrt((R32 * R32) + (R33 * R33)));
-	psi = atan2(R21, R11);
+	phi = fast_atan2(R32, R33);
+	theta = fast_atan2(-R31 , fast_sqrt((R32 * R32) + (R33 * R33)));
+	psi = fast_atan2(R21, R11);
 
 	euler_angles<T> e(phi, theta, psi);
 
@@ -0,0 +1,152 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef _FAST_MATH_H_
+
+template <typename T>
+inline T fast_rsqrt(const T x)
+{
+	return (T) 1 / sqrt(x);
+}
+
+#if defined (FAST_MATH_NEON)
+// Estimate plus two Newton-Raphson steps; VRSQRTS does the (3 - x*e*e) / 2.
+template <>
+inline float fast_rsqrt<float>(const float x)
+{
+	float32x2_t v = vdup_n_f32(x);
+	float32x2_t e = vrsqrte_f32(v);
+
+	e = vmul_f32(e, vrsqrts_f32(vmul_f32(v, e), e));
+	e = vmul_f32(e, vrsqrts_f32(vmul_f32(v, e), e));
+
+	return vget_lane_f32(e, 0);
+}
+#elif defined (FAST_MATH_SSE)
+// The 12-bit hardware estimate plus one Newton-Raphson step.
+template <>
+inline float fast_rsqrt<float>(const float x)
+{
+	float e = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+
+	return e * (1.5f - 0.5f * x * e * e);
+}
+#endif
+
+template <typename T>
+inline T fast_sqrt(const T x)
+{
+	if (x <= 0)
+		return 0;
+
+	return x * fast_rsqrt(x);
+}
+
+// atan() on [-1, 1], Abramowitz & Stegun 4.4.49.
+template <typename T>
+constexpr T fast_atan_poly(const T x, const T x2)
+{
+	return x * ((T) 0.9998660 + x2 * ((T) -0.3302995 + x2 * ((T) 0.1801410 +
+			x2 * ((T) -0.0851330 + x2 * (T) 0.0208351))));
+}
+
+template <typename T>
+constexpr T fast_atan(const T x)
+{
+	return fast_atan_poly(x, x * x);
+}
+
+template <typename T>
+inline T fast_atan2(const T y, const T x)
+{
+	T ax = fabs(x);
+	T ay = fabs(y);
+	T r;
+
+	if (ax == 0 && ay == 0)
+		return 0;
+
+	if (ay <= ax)
+		r = fast_atan(ay / ax);
+	else
+		r = (T) FAST_MATH_PI_2 - fast_atan(ax / ay);
+
+	if (x < 0)
+		r = (T) FAST_MATH_PI - r;
+
+	if (y < 0)
+		r = -r;
+
+	return r;
+}
+
+// Abramowitz & Stegun 4.4.45, mirrored for negative x.
+template <typename T>
+inline T fast_asin(const T x)
+{
+	T ax = fabs(x);
+	T r;
+
+	if (ax >= 1)
+		r = (T) FAST_MATH_PI_2;
+	else
+		r = (T) FAST_MATH_PI_2 - fast_sqrt(1 - ax) * ((T) 1.5707288 +
+				ax * ((T) -0.2121144 + ax * ((T) 0.0742610 + ax * (T) -0.0187293)));
+
+	return (x < 0) ? -r : r;
+}
+
+// The odd Taylor polynomial of sin() to the x^9 term, for |r| <= PI/2.
+template <typename T>
+constexpr T fast_sin_poly(const T r, const T r2)
+{
+	return r * (1 + r2 * ((T) (-1.0 / 6) + r2 * ((T) (1.0 / 120) +
+			r2 * ((T) (-1.0 / 5040) + r2 * (T) (1.0 / 362880)))));
+}
+
+// Folds r from [-PI, PI] into [-PI/2, PI/2], where sin() takes the same value.
+template <typename T>
+constexpr T fast_sin_fold(const T r)
+{
+	return (r > (T) FAST_MATH_PI_2) ? (T) FAST_MATH_PI - r :
+		(r < (T) -FAST_MATH_PI_2) ? (T) -FAST_MATH_PI - r : r;
+}
+
+template <typename T>
+constexpr T fast_sin_reduced(const T r)
+{
+	return fast_sin_poly(r, r * r);
+}
+
+// Wraps x into [-PI, PI], then folds it into the range of the polynomial.
+template <typename T>
+constexpr T fast_sin(const T x)
+{
+	return fast_sin_reduced(fast_sin_fold(
+		(x > (T) FAST_MATH_PI) ? x - (T) (2 * FAST_MATH_PI) :
+		(x < (T) -FAST_MATH_PI) ? x + (T) (2 * FAST_MATH_PI) : x));
+}
+
+template <typename T>
+constexpr T fast_cos(const T x)
+{
+	return fast_sin(x + (T) FAST_MATH_PI_2);
+}
+
+#endif /* _FAST_MATH_H_ */
@@ -0,0 +1,57 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _FAST_MATH_H_
+#define _FAST_MATH_H_
+
+#include <math.h>
+
+// Polynomial stand-ins for the libm calls on the per-sample conversion
+// paths. Worst-case absolute errors over the documented input ranges:
+//   fast_atan2   1.2e-5 rad
+//   fast_asin    6.8e-5 rad   (|x| <= 1)
+//   fast_sin/cos 3.7e-6       (|x| <= 2 * PI)
+//   fast_rsqrt   2.5e-7 relative for float, exact (libm) otherwise
+// They are free of state and side effects, so they inline down to a few
+// multiply-adds each. fast_atan and fast_sin/cos are pure polynomials and
+// constexpr; the rest go through sqrt() or SIMD intrinsics and are not.
+#if !defined(SENSOR_FUSION_NO_SIMD)
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define FAST_MATH_NEON
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#define FAST_MATH_SSE
+#include <xmmintrin.h>
+#endif
+#endif
+
+#define FAST_MATH_PI		3.14159265358979323846
+#define FAST_MATH_PI_2		1.57079632679489661923
+
+template <typename T> inline T fast_rsqrt(const T x);
+template <typename T> inline T fast_sqrt(const T x);
+template <typename T> constexpr T fast_atan(const T x);
+template <typename T> inline T fast_atan2(const T y, const T x);
+template <typename T> inline T fast_asin(const T x);
+template <typename T> constexpr T fast_sin(const T x);
+template <typename T> constexpr T fast_cos(const T x);
+
+#include "fast_math.cpp"
+
+#endif /* _FAST_MATH_H_ */
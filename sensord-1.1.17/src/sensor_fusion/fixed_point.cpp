@@ -0,0 +1,203 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef _FIXED_POINT_H_
+
+#define FIXED_POINT_RAW_MAX	((int64_t) 0x7fffffff)
+#define FIXED_POINT_RAW_MIN	(-FIXED_POINT_RAW_MAX - 1)
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS>::fixed_point() : m_raw(0)
+{
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS>::fixed_point(const int val)
+{
+	*this = from_raw((int64_t) val << FRAC_BITS);
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS>::fixed_point(const float val)
+{
+	*this = fixed_point<FRAC_BITS>((double) val);
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS>::fixed_point(const double val)
+{
+	double scaled = val * (double) ((int64_t) 1 << FRAC_BITS);
+
+	if (scaled >= (double) FIXED_POINT_RAW_MAX)
+		m_raw = (int32_t) FIXED_POINT_RAW_MAX;
+	else if (scaled <= (double) FIXED_POINT_RAW_MIN)
+		m_raw = (int32_t) FIXED_POINT_RAW_MIN;
+	else
+		m_raw = (int32_t) (scaled >= 0 ? scaled + 0.5 : scaled - 0.5);
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS>::fixed_point(const fixed_point<FRAC_BITS>& f)
+: m_raw(f.m_raw)
+{
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::operator =(const fixed_point<FRAC_BITS>& f)
+{
+	m_raw = f.m_raw;
+
+	return *this;
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::operator +=(const fixed_point<FRAC_BITS>& f)
+{
+	*this = add(*this, f);
+
+	return *this;
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::operator -=(const fixed_point<FRAC_BITS>& f)
+{
+	*this = sub(*this, f);
+
+	return *this;
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::operator *=(const fixed_point<FRAC_BITS>& f)
+{
+	*this = mul(*this, f);
+
+	return *this;
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::operator /=(const fixed_point<FRAC_BITS>& f)
+{
+	*this = div(*this, f);
+
+	return *this;
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::operator -() const
+{
+	return from_raw(-(int64_t) m_raw);
+}
+
+template <int FRAC_BITS>
+float fixed_point<FRAC_BITS>::to_float() const
+{
+	return (float) m_raw / (float) ((int64_t) 1 << FRAC_BITS);
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::from_raw(const int64_t raw)
+{
+	fixed_point<FRAC_BITS> f;
+
+	if (raw > FIXED_POINT_RAW_MAX)
+		f.m_raw = (int32_t) FIXED_POINT_RAW_MAX;
+	else if (raw < FIXED_POINT_RAW_MIN)
+		f.m_raw = (int32_t) FIXED_POINT_RAW_MIN;
+	else
+		f.m_raw = (int32_t) raw;
+
+	return f;
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::add(const fixed_point<FRAC_BITS> f1,
+		const fixed_point<FRAC_BITS> f2)
+{
+	return from_raw((int64_t) f1.m_raw + f2.m_raw);
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::sub(const fixed_point<FRAC_BITS> f1,
+		const fixed_point<FRAC_BITS> f2)
+{
+	return from_raw((int64_t) f1.m_raw - f2.m_raw);
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::mul(const fixed_point<FRAC_BITS> f1,
+		const fixed_point<FRAC_BITS> f2)
+{
+	int64_t prod = (int64_t) f1.m_raw * f2.m_raw;
+
+	return from_raw((prod + ((int64_t) 1 << (FRAC_BITS - 1))) >> FRAC_BITS);
+}
+
+template <int FRAC_BITS>
+fixed_point<FRAC_BITS> fixed_point<FRAC_BITS>::div(const fixed_point<FRAC_BITS> f1,
+		const fixed_point<FRAC_BITS> f2)
+{
+	int64_t num = (int64_t) f1.m_raw << FRAC_BITS;
+	int64_t den = f2.m_raw;
+
+	if (den == 0)
+		return from_raw(num >= 0 ? FIXED_POINT_RAW_MAX : FIXED_POINT_RAW_MIN);
+
+	if ((num < 0) == (den < 0))
+		num += (den < 0 ? -den : den) / 2;
+	else
+		num -= (den < 0 ? -den : den) / 2;
+
+	return from_raw(num / den);
+}
+
+// Bit-by-bit integer square root of the raw value scaled up by FRAC_BITS,
+// so the result keeps the same Q format. Negative input gives 0.
+template <int F>
+fixed_point<F> sqrt(const fixed_point<F> f)
+{
+	uint64_t num;
+	uint64_t res = 0;
+	uint64_t bit;
+
+	if (f.m_raw <= 0)
+		return fixed_point<F>();
+
+	num = (uint64_t) f.m_raw << F;
+	bit = (uint64_t) 1 << ((63 - __builtin_clzll(num)) & ~1);
+
+	while (bit != 0) {
+		if (num >= res + bit) {
+			num -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return fixed_point<F>::from_raw((int64_t) res);
+}
+
+template <int F>
+fixed_point<F> fabs(const fixed_point<F> f)
+{
+	return (f.m_raw < 0) ? -f : f;
+}
+
+#endif /* _FIXED_POINT_H_ */
@@ -0,0 +1,239 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef _KALMAN_KERNELS_H_
+
+template <typename T, int N>
+void predict_covariance(matrix<T, N, N>& pred_cov, const matrix<T, N, N>& tran_mat,
+		const matrix<T, N, N>& driv_cov)
+{
+	pred_cov = (tran_mat * pred_cov * tran(tran_mat)) + driv_cov;
+}
+
+template <typename T, int N>
+void update_covariance(matrix<T, N, N>& pred_cov, vect<T, N>& state,
+		const vect<T, N>& state_error, const matrix<T, N, N>& aid_cov,
+		const matrix<T, N, N>& measure_mat, const T negligible)
+{
+	T gain;
+	T iden = 0;
+
+	for (int j = 0; j < N; ++j) {
+		for (int i = 0; i < N; ++i) {
+			gain = pred_cov.m_mat[j][i] / (pred_cov.m_mat[j][j] + aid_cov.m_mat[j][j]);
+
+			state.m_vec[i] = state.m_vec[i] + gain * state_error.m_vec[j];
+
+			if (i == j)
+				iden = 1;
+			else
+				iden = 0;
+
+			pred_cov.m_mat[j][i] = (iden - (gain * measure_mat.m_mat[j][i])) *
+					pred_cov.m_mat[j][i];
+
+			if (((pred_cov.m_mat[j][i] < 0) ? -pred_cov.m_mat[j][i] : pred_cov.m_mat[j][i]) < negligible)
+				pred_cov.m_mat[j][i] = negligible;
+		}
+	}
+}
+
+#if defined (KALMAN_KERNELS_NEON) || defined (KALMAN_KERNELS_SSE)
+
+// A 6-wide row is handled as a full 4-lane vector plus a second vector
+// whose upper two lanes are don't-care. Row stride is 6 floats, so rows
+// are not 16-byte aligned and every access is an unaligned load/store.
+#if defined (KALMAN_KERNELS_NEON)
+typedef float32x4_t kalman_vec;
+
+static inline kalman_vec kv_load(const float *p) { return vld1q_f32(p); }
+static inline kalman_vec kv_load2(const float *p) { return vcombine_f32(vld1_f32(p), vdup_n_f32(0.0f)); }
+static inline void kv_store(float *p, kalman_vec v) { vst1q_f32(p, v); }
+static inline void kv_store2(float *p, kalman_vec v) { vst1_f32(p, vget_low_f32(v)); }
+static inline kalman_vec kv_splat(float val) { return vdupq_n_f32(val); }
+static inline kalman_vec kv_add(kalman_vec a, kalman_vec b) { return vaddq_f32(a, b); }
+static inline kalman_vec kv_sub(kalman_vec a, kalman_vec b) { return vsubq_f32(a, b); }
+static inline kalman_vec kv_mul(kalman_vec a, kalman_vec b) { return vmulq_f32(a, b); }
+
+static inline kalman_vec kv_div(kalman_vec a, kalman_vec b)
+{
+#if defined (__aarch64__)
+	return vdivq_f32(a, b);
+#else
+	// ARMv7 NEON only has a reciprocal estimate; divide per lane so the
+	// gain stays bit-identical to the scalar path.
+	float na[4], nb[4];
+
+	vst1q_f32(na, a);
+	vst1q_f32(nb, b);
+
+	for (int i = 0; i < 4; i++)
+		na[i] /= nb[i];
+
+	return vld1q_f32(na);
+#endif
+}
+
+static inline kalman_vec kv_floor_abs(kalman_vec v, kalman_vec floor_val)
+{
+	uint32x4_t small = vcltq_f32(vabsq_f32(v), floor_val);
+
+	return vbslq_f32(small, floor_val, v);
+}
+
+static inline kalman_vec kv_pick_le(kalman_vec lane, kalman_vec pos, kalman_vec a, kalman_vec b)
+{
+	return vbslq_f32(vcleq_f32(lane, pos), a, b);
+}
+
+static inline kalman_vec kv_pick_eq(kalman_vec lane, kalman_vec pos, kalman_vec a, kalman_vec b)
+{
+	return vbslq_f32(vceqq_f32(lane, pos), a, b);
+}
+#else
+typedef __m128 kalman_vec;
+
+static inline kalman_vec kv_load(const float *p) { return _mm_loadu_ps(p); }
+static inline kalman_vec kv_load2(const float *p) { return _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) p); }
+static inline void kv_store(float *p, kalman_vec v) { _mm_storeu_ps(p, v); }
+static inline void kv_store2(float *p, kalman_vec v) { _mm_storel_pi((__m64 *) p, v); }
+static inline kalman_vec kv_splat(float val) { return _mm_set1_ps(val); }
+static inline kalman_vec kv_add(kalman_vec a, kalman_vec b) { return _mm_add_ps(a, b); }
+static inline kalman_vec kv_sub(kalman_vec a, kalman_vec b) { return _mm_sub_ps(a, b); }
+static inline kalman_vec kv_mul(kalman_vec a, kalman_vec b) { return _mm_mul_ps(a, b); }
+static inline kalman_vec kv_div(kalman_vec a, kalman_vec b) { return _mm_div_ps(a, b); }
+
+static inline kalman_vec kv_floor_abs(kalman_vec v, kalman_vec floor_val)
+{
+	kalman_vec abs_v = _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+	kalman_vec small = _mm_cmplt_ps(abs_v, floor_val);
+
+	return _mm_or_ps(_mm_and_ps(small, floor_val), _mm_andnot_ps(small, v));
+}
+
+static inline kalman_vec kv_pick_le(kalman_vec lane, kalman_vec pos, kalman_vec a, kalman_vec b)
+{
+	kalman_vec mask = _mm_cmple_ps(lane, pos);
+
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline kalman_vec kv_pick_eq(kalman_vec lane, kalman_vec pos, kalman_vec a, kalman_vec b)
+{
+	kalman_vec mask = _mm_cmpeq_ps(lane, pos);
+
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#endif
+
+// out = a * b (+ addend). Each output row is accumulated as a sum of rows of
+// b scaled by a[i][k], in the same k order as the scalar operator *.
+static inline void kalman_mul6x6(const float (*a)[6], const float (*b)[6],
+		const float (*addend)[6], float (*out)[6])
+{
+	for (int i = 0; i < 6; i++) {
+		kalman_vec lo = kv_splat(0.0f);
+		kalman_vec hi = kv_splat(0.0f);
+
+		for (int k = 0; k < 6; k++) {
+			kalman_vec aik = kv_splat(a[i][k]);
+
+			lo = kv_add(lo, kv_mul(aik, kv_load(&b[k][0])));
+			hi = kv_add(hi, kv_mul(aik, kv_load2(&b[k][4])));
+		}
+
+		if (addend) {
+			lo = kv_add(lo, kv_load(&addend[i][0]));
+			hi = kv_add(hi, kv_load2(&addend[i][4]));
+		}
+
+		kv_store(&out[i][0], lo);
+		kv_store2(&out[i][4], hi);
+	}
+}
+
+template <>
+inline void predict_covariance<float, 6>(matrix<float, 6, 6>& pred_cov,
+		const matrix<float, 6, 6>& tran_mat, const matrix<float, 6, 6>& driv_cov)
+{
+	matrix<float, 6, 6> tran_mat_t = tran(tran_mat);
+	matrix<float, 6, 6> fp;
+
+	kalman_mul6x6(tran_mat.m_mat, pred_cov.m_mat, NULL, fp.m_mat);
+	kalman_mul6x6(fp.m_mat, tran_mat_t.m_mat, driv_cov.m_mat, pred_cov.m_mat);
+}
+
+template <>
+inline void update_covariance<float, 6>(matrix<float, 6, 6>& pred_cov,
+		vect<float, 6>& state, const vect<float, 6>& state_error,
+		const matrix<float, 6, 6>& aid_cov, const matrix<float, 6, 6>& measure_mat,
+		const float negligible)
+{
+	kalman_vec state_lo = kv_load(&state.m_vec[0]);
+	kalman_vec state_hi = kv_load2(&state.m_vec[4]);
+	kalman_vec floor_val = kv_splat(negligible);
+	const float lane_idx[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+	kalman_vec lane_lo = kv_load(&lane_idx[0]);
+	kalman_vec lane_hi = kv_load(&lane_idx[4]);
+	kalman_vec one = kv_splat(1.0f);
+	kalman_vec zero = kv_splat(0.0f);
+
+	for (int j = 0; j < 6; ++j) {
+		float *row = pred_cov.m_mat[j];
+		float aid = aid_cov.m_mat[j][j];
+		kalman_vec pos = kv_splat((float) j);
+
+		// The scalar loop overwrites P[j][j] halfway through row j, so the
+		// gains right of the diagonal see the updated value. Resolve the
+		// diagonal first and give each lane the denominator it would see.
+		float den_pre = row[j] + aid;
+		float gain_jj = row[j] / den_pre;
+		float cov_jj = (1.0f - gain_jj * measure_mat.m_mat[j][j]) * row[j];
+
+		if (((cov_jj < 0) ? -cov_jj : cov_jj) < negligible)
+			cov_jj = negligible;
+
+		kalman_vec den_pre_v = kv_splat(den_pre);
+		kalman_vec den_post_v = kv_splat(cov_jj + aid);
+
+		kalman_vec row_lo = kv_load(&row[0]);
+		kalman_vec row_hi = kv_load2(&row[4]);
+		kalman_vec gain_lo = kv_div(row_lo, kv_pick_le(lane_lo, pos, den_pre_v, den_post_v));
+		kalman_vec gain_hi = kv_div(row_hi, kv_pick_le(lane_hi, pos, den_pre_v, den_post_v));
+		kalman_vec iden_lo = kv_pick_eq(lane_lo, pos, one, zero);
+		kalman_vec iden_hi = kv_pick_eq(lane_hi, pos, one, zero);
+		kalman_vec error = kv_splat(state_error.m_vec[j]);
+
+		state_lo = kv_add(state_lo, kv_mul(gain_lo, error));
+		state_hi = kv_add(state_hi, kv_mul(gain_hi, error));
+
+		row_lo = kv_mul(kv_sub(iden_lo, kv_mul(gain_lo, kv_load(&measure_mat.m_mat[j][0]))), row_lo);
+		row_hi = kv_mul(kv_sub(iden_hi, kv_mul(gain_hi, kv_load2(&measure_mat.m_mat[j][4]))), row_hi);
+
+		kv_store(&row[0], kv_floor_abs(row_lo, floor_val));
+		kv_store2(&row[4], kv_floor_abs(row_hi, floor_val));
+	}
+
+	kv_store(&state.m_vec[0], state_lo);
+	kv_store2(&state.m_vec[4], state_hi);
+}
+
+#endif
+
+#endif /* _KALMAN_KERNELS_H_ */
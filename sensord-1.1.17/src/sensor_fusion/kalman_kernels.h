@@ -0,0 +1,53 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _KALMAN_KERNELS_H_
+#define _KALMAN_KERNELS_H_
+
+#include "matrix.h"
+#include "vector.h"
+
+// The float 6x6 filter steps get NEON or SSE kernels when the compiler
+// targets them. Everything else, and any build defining
+// SENSOR_FUSION_NO_SIMD, uses the scalar templates.
+#if !defined(SENSOR_FUSION_NO_SIMD)
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define KALMAN_KERNELS_NEON
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#define KALMAN_KERNELS_SSE
+#include <xmmintrin.h>
+#endif
+#endif
+
+// P = F * P * F' + Q
+template <typename T, int N>
+void predict_covariance(matrix<T, N, N>& pred_cov, const matrix<T, N, N>& tran_mat,
+		const matrix<T, N, N>& driv_cov);
+
+// Diagonal-gain measurement update of the state and the predicted
+// covariance. Covariance entries smaller than negligible are clamped to it.
+template <typename T, int N>
+void update_covariance(matrix<T, N, N>& pred_cov, vect<T, N>& state,
+		const vect<T, N>& state_error, const matrix<T, N, N>& aid_cov,
+		const matrix<T, N, N>& measure_mat, const T negligible);
+
+#include "kalman_kernels.cpp"
+
+#endif /* _KALMAN_KERNELS_H_ */
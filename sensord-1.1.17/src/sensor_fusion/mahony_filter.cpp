@@ -0,0 +1,286 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef _MAHONY_FILTER_H_
+
+#define MAHONY_PI		3.141593
+#define MAHONY_US2S		(1.0 / 1000000.0)
+#define MAHONY_SAMPLE_INTV	100000
+#define MAHONY_DEFAULT_KP	0.5
+#define MAHONY_DEFAULT_KI	0.0
+
+template <typename TYPE>
+mahony_filter<TYPE>::mahony_filter()
+: m_gyro_dt(0)
+, m_kp((TYPE) MAHONY_DEFAULT_KP)
+, m_ki((TYPE) MAHONY_DEFAULT_KI)
+, m_initialized(false)
+, m_magnetic_alignment_factor(1)
+{
+	m_gyro.m_time_stamp = 0;
+}
+
+template <typename TYPE>
+mahony_filter<TYPE>::~mahony_filter()
+{
+}
+
+template <typename TYPE>
+void mahony_filter<TYPE>::set_gains(const TYPE kp, const TYPE ki)
+{
+	m_kp = kp;
+	m_ki = ki;
+}
+
+template <typename TYPE>
+inline void mahony_filter<TYPE>::initialize_sensor_data(const sensor_data<TYPE> &accel,
+		const sensor_data<TYPE> &gyro, const sensor_data<TYPE> &magnetic)
+{
+	initialize_sensor_data(accel, gyro);
+
+	m_magnetic = magnetic;
+	normalize(m_magnetic);
+}
+
+template <typename TYPE>
+inline void mahony_filter<TYPE>::initialize_sensor_data(const sensor_data<TYPE> &accel,
+		const sensor_data<TYPE> &gyro)
+{
+	unsigned long long sample_interval_gyro = MAHONY_SAMPLE_INTV;
+
+	if (m_gyro.m_time_stamp != 0 && gyro.m_time_stamp != 0)
+		sample_interval_gyro = gyro.m_time_stamp - m_gyro.m_time_stamp;
+
+	m_gyro_dt = sample_interval_gyro * MAHONY_US2S;
+
+	m_accel = accel;
+	m_gyro = gyro;
+
+	normalize(m_accel);
+
+	// Same effective rate scaling as orientation_filter, which multiplies
+	// the rate by PI and the integration step by PI again, so a device's
+	// GYRO_SCALE means the same thing for either engine.
+	m_gyro.m_data = m_gyro.m_data * (TYPE) (MAHONY_PI * MAHONY_PI);
+}
+
+// Seeds the attitude from one accel/mag pair (TRIAD), so the filter does
+// not have to converge from identity on the first samples.
+template <typename TYPE>
+inline void mahony_filter<TYPE>::initialize_quaternion()
+{
+	TYPE arr_acc_e[3] = {0.0, 0.0, 1.0};
+	TYPE arr_mag_e[3] = {0.0, (TYPE) m_magnetic_alignment_factor, 0.0};
+
+	vect<TYPE, 3> acc_e(arr_acc_e);
+	vect<TYPE, 3> mag_e(arr_mag_e);
+
+	vect<TYPE, 3> acc_b_x_mag_b = cross(m_accel.m_data, m_magnetic.m_data);
+	vect<TYPE, 3> acc_e_x_mag_e = cross(acc_e, mag_e);
+
+	// Unlike the Kalman filter's aiding step, normalise the body triad so
+	// the matrix below is a proper rotation.
+	TYPE norm = sqrt(acc_b_x_mag_b.m_vec[0] * acc_b_x_mag_b.m_vec[0] +
+			acc_b_x_mag_b.m_vec[1] * acc_b_x_mag_b.m_vec[1] +
+			acc_b_x_mag_b.m_vec[2] * acc_b_x_mag_b.m_vec[2]);
+
+	if (norm > 0)
+		acc_b_x_mag_b = acc_b_x_mag_b / norm;
+
+	vect<TYPE, 3> cross1 = cross(acc_b_x_mag_b, m_accel.m_data);
+	vect<TYPE, 3> cross2 = cross(acc_e_x_mag_e, acc_e);
+
+	matrix<TYPE, 3, 3> mat_b;
+	matrix<TYPE, 3, 3> mat_e;
+
+	for (int i = 0; i < 3; i++) {
+		mat_b.m_mat[i][0] = m_accel.m_data.m_vec[i];
+		mat_b.m_mat[i][1] = acc_b_x_mag_b.m_vec[i];
+		mat_b.m_mat[i][2] = cross1.m_vec[i];
+		mat_e.m_mat[i][0] = acc_e.m_vec[i];
+		mat_e.m_mat[i][1] = acc_e_x_mag_e.m_vec[i];
+		mat_e.m_mat[i][2] = cross2.m_vec[i];
+	}
+
+	rotation_matrix<TYPE> rot_mat(mat_e * tran(mat_b));
+
+	m_quaternion = rot_mat2quat(rot_mat);
+	m_integral_error = vect<TYPE, 3>();
+	m_initialized = true;
+}
+
+// Levels the attitude from gravity alone, with zero heading: the shortest
+// rotation taking the body-frame gravity direction onto earth z.
+template <typename TYPE>
+inline void mahony_filter<TYPE>::initialize_quaternion_from_gravity()
+{
+	TYPE ax = m_accel.m_data.m_vec[0];
+	TYPE ay = m_accel.m_data.m_vec[1];
+	TYPE az = m_accel.m_data.m_vec[2];
+
+	if (az < (TYPE) -0.999999) {
+		quaternion<TYPE> flip(0, 1, 0, 0);
+		m_quaternion = flip;
+	} else {
+		quaternion<TYPE> arc(1 + az, ay, -ax, 0);
+		m_quaternion = arc;
+		m_quaternion.quat_normalize();
+	}
+
+	m_integral_error = vect<TYPE, 3>();
+	m_initialized = true;
+}
+
+template <typename TYPE>
+inline void mahony_filter<TYPE>::update(const bool use_magnetic)
+{
+	TYPE w = m_quaternion.m_quat.m_vec[0];
+	TYPE x = m_quaternion.m_quat.m_vec[1];
+	TYPE y = m_quaternion.m_quat.m_vec[2];
+	TYPE z = m_quaternion.m_quat.m_vec[3];
+
+	TYPE ax = m_accel.m_data.m_vec[0];
+	TYPE ay = m_accel.m_data.m_vec[1];
+	TYPE az = m_accel.m_data.m_vec[2];
+	TYPE mx = m_magnetic.m_data.m_vec[0];
+	TYPE my = m_magnetic.m_data.m_vec[1];
+	TYPE mz = m_magnetic.m_data.m_vec[2];
+
+	// Body-to-earth rotation rows
+	TYPE r00 = 1 - 2 * (y * y + z * z), r01 = 2 * (x * y - w * z), r02 = 2 * (x * z + w * y);
+	TYPE r10 = 2 * (x * y + w * z), r11 = 1 - 2 * (x * x + z * z), r12 = 2 * (y * z - w * x);
+	TYPE r20 = 2 * (x * z - w * y), r21 = 2 * (y * z + w * x), r22 = 1 - 2 * (x * x + y * y);
+
+	// Expected gravity direction in the body frame
+	TYPE vx = r20, vy = r21, vz = r22;
+
+	TYPE ex = (ay * vz - az * vy);
+	TYPE ey = (az * vx - ax * vz);
+	TYPE ez = (ax * vy - ay * vx);
+
+	if (use_magnetic) {
+		// Magnetic field in the earth frame, with its horizontal part
+		// folded onto the y (north) axis
+		TYPE hx = r00 * mx + r01 * my + r02 * mz;
+		TYPE hy = r10 * mx + r11 * my + r12 * mz;
+		TYPE bz = r20 * mx + r21 * my + r22 * mz;
+		TYPE by = sqrt(hx * hx + hy * hy) * m_magnetic_alignment_factor;
+
+		// Expected field direction in the body frame
+		TYPE wx = by * r10 + bz * r20;
+		TYPE wy = by * r11 + bz * r21;
+		TYPE wz = by * r12 + bz * r22;
+
+		ex += (my * wz - mz * wy);
+		ey += (mz * wx - mx * wz);
+		ez += (mx * wy - my * wx);
+	}
+
+	TYPE gx = m_gyro.m_data.m_vec[0];
+	TYPE gy = m_gyro.m_data.m_vec[1];
+	TYPE gz = m_gyro.m_data.m_vec[2];
+
+	if (m_ki > 0) {
+		m_integral_error.m_vec[0] += m_ki * ex * m_gyro_dt;
+		m_integral_error.m_vec[1] += m_ki * ey * m_gyro_dt;
+		m_integral_error.m_vec[2] += m_ki * ez * m_gyro_dt;
+
+		gx += m_integral_error.m_vec[0];
+		gy += m_integral_error.m_vec[1];
+		gz += m_integral_error.m_vec[2];
+	}
+
+	gx += m_kp * ex;
+	gy += m_kp * ey;
+	gz += m_kp * ez;
+
+	quaternion<TYPE> quat_rot_inc(0, gx, gy, gz);
+	quaternion<TYPE> quat_diff = (m_quaternion * quat_rot_inc) * (TYPE) (0.5 * m_gyro_dt);
+
+	m_quaternion = m_quaternion + quat_diff;
+	m_quaternion.quat_normalize();
+}
+
+template <typename TYPE>
+euler_angles<TYPE> mahony_filter<TYPE>::get_orientation(const sensor_data<TYPE> accel,
+		const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic)
+{
+	initialize_sensor_data(accel, gyro, magnetic);
+
+	if (!m_initialized)
+		initialize_quaternion();
+	else
+		update(true);
+
+	m_orientation = quat2euler(m_quaternion);
+
+	return m_orientation;
+}
+
+template <typename TYPE>
+quaternion<TYPE> mahony_filter<TYPE>::get_quaternion(const sensor_data<TYPE> accel,
+		const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic)
+{
+	get_orientation(accel, gyro, magnetic);
+
+	return m_quaternion;
+}
+
+template <typename TYPE>
+quaternion<TYPE> mahony_filter<TYPE>::get_quaternion(const sensor_data<TYPE> accel,
+		const sensor_data<TYPE> gyro)
+{
+	initialize_sensor_data(accel, gyro);
+
+	if (!m_initialized)
+		initialize_quaternion_from_gravity();
+	else
+		update(false);
+
+	m_orientation = quat2euler(m_quaternion);
+
+	return m_quaternion;
+}
+
+// Batch form of get_orientation() over parallel arrays. The Euler
+// conversion is only paid for when orientations is not NULL.
+template <typename TYPE>
+void mahony_filter<TYPE>::get_orientation_batch(const sensor_data<TYPE> *accel,
+		const sensor_data<TYPE> *gyro, const sensor_data<TYPE> *magnetic,
+		const int count, quaternion<TYPE> *quaternions,
+		euler_angles<TYPE> *orientations)
+{
+	for (int i = 0; i < count; i++) {
+		initialize_sensor_data(accel[i], gyro[i], magnetic[i]);
+
+		if (!m_initialized)
+			initialize_quaternion();
+		else
+			update(true);
+
+		if (quaternions)
+			quaternions[i] = m_quaternion;
+		if (orientations) {
+			m_orientation = quat2euler(m_quaternion);
+			orientations[i] = m_orientation;
+		}
+	}
+}
+
+#endif /* _MAHONY_FILTER_H_ */
@@ -0,0 +1,79 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _MAHONY_FILTER_H_
+#define _MAHONY_FILTER_H_
+
+#include "vector.h"
+#include "sensor_data.h"
+#include "quaternion.h"
+#include "euler_angles.h"
+#include "rotation_matrix.h"
+
+// Complementary (Mahony) attitude filter. It produces the same quaternion
+// convention as orientation_filter: body to an east/north/up earth frame,
+// with the magnetic reference on the y axis scaled by
+// m_magnetic_alignment_factor. It costs a small fraction of the Kalman
+// filter's arithmetic per sample, at the price of fixed gains. Without a
+// magnetometer it runs as a 6-axis filter whose heading is only relative
+// to where it started.
+template <typename TYPE>
+class mahony_filter {
+public:
+	sensor_data<TYPE> m_accel;
+	sensor_data<TYPE> m_gyro;
+	sensor_data<TYPE> m_magnetic;
+	vect<TYPE, 3> m_integral_error;
+	quaternion<TYPE> m_quaternion;
+	euler_angles<TYPE> m_orientation;
+	TYPE m_gyro_dt;
+	TYPE m_kp;
+	TYPE m_ki;
+	bool m_initialized;
+
+	int m_magnetic_alignment_factor;
+
+	mahony_filter();
+	~mahony_filter();
+
+	void set_gains(const TYPE kp, const TYPE ki);
+
+	inline void initialize_sensor_data(const sensor_data<TYPE> &accel,
+			const sensor_data<TYPE> &gyro);
+	inline void initialize_sensor_data(const sensor_data<TYPE> &accel,
+			const sensor_data<TYPE> &gyro, const sensor_data<TYPE> &magnetic);
+	inline void initialize_quaternion();
+	inline void initialize_quaternion_from_gravity();
+	inline void update(const bool use_magnetic);
+
+	euler_angles<TYPE> get_orientation(const sensor_data<TYPE> accel,
+			const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic);
+	quaternion<TYPE> get_quaternion(const sensor_data<TYPE> accel,
+			const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic);
+	quaternion<TYPE> get_quaternion(const sensor_data<TYPE> accel,
+			const sensor_data<TYPE> gyro);
+	void get_orientation_batch(const sensor_data<TYPE> *accel,
+			const sensor_data<TYPE> *gyro, const sensor_data<TYPE> *magnetic,
+			const int count, quaternion<TYPE> *quaternions,
+			euler_angles<TYPE> *orientations);
+};
+
+#include "mahony_filter.cpp"
+
+#endif /* _MAHONY_FILTER_H_ */
@@ -24,45 +24,43 @@
 #include <iostream>
 using namespace std;
 
-template <typename TYPE>
+// Dimensions are template parameters and the elements live inline, so a
+// matrix is a plain value: copying, returning or passing one never touches
+// the heap, and a dimension mismatch fails to compile instead of asserting.
+template <typename TYPE, int ROWS, int COLS>
 class matrix {
 public:
-	int m_rows;
-	int m_cols;
-	TYPE **m_mat;
+	static const int m_rows = ROWS;
+	static const int m_cols = COLS;
+	TYPE m_mat[ROWS][COLS];
 
 	matrix(void);
-	matrix(const int rows, const int cols);
-	matrix(const int rows, const int cols, TYPE *mat_data);
-	matrix(const matrix<TYPE>& m);
-	~matrix();
+	explicit matrix(const TYPE *mat_data);
 
-	matrix<TYPE> operator =(const matrix<TYPE>& m);
-
-	template<typename T> friend ostream& operator << (ostream& dout,
-			matrix<T>& m);
-	template<typename T> friend matrix<T> operator +(const matrix<T> m1,
-			const matrix<T> m2);
-	template<typename T> friend matrix<T> operator +(const matrix<T> m,
+	template<typename T, int R, int C> friend ostream& operator << (ostream& dout,
+			const matrix<T, R, C>& m);
+	template<typename T, int R, int C> friend matrix<T, R, C> operator +(const matrix<T, R, C>& m1,
+			const matrix<T, R, C>& m2);
+	template<typename T, int R, int C> friend matrix<T, R, C> operator +(const matrix<T, R, C>& m,
 			const T val);
-	template<typename T> friend matrix<T> operator -(const matrix<T> m1,
-			const matrix<T> m2);
-	template<typename T> friend matrix<T> operator -(const matrix<T> m,
+	template<typename T, int R, int C> friend matrix<T, R, C> operator -(const matrix<T, R, C>& m1,
+			const matrix<T, R, C>& m2);
+	template<typename T, int R, int C> friend matrix<T, R, C> operator -(const matrix<T, R, C>& m,
 			const T val);
-	template<typename T> friend matrix<T> operator *(const matrix<T> m1,
-			const matrix<T> m2);
-	template<typename T> friend matrix<T> operator *(const matrix<T> m,
+	template<typename T, int R, int K, int C> friend matrix<T, R, C> operator *(const matrix<T, R, K>& m1,
+			const matrix<T, K, C>& m2);
+	template<typename T, int R, int C> friend matrix<T, R, C> operator *(const matrix<T, R, C>& m,
 			const T val);
-	template<typename T> friend matrix<T> operator /(const matrix<T> m1,
+	template<typename T, int R, int C> friend matrix<T, R, C> operator /(const matrix<T, R, C>& m1,
 			 const T val);
-	template<typename T> friend bool operator ==(const matrix<T> m1,
-			const matrix<T> m2);
-	template<typename T> friend bool operator !=(const matrix<T> m1,
-			const matrix<T> m2);
+	template<typename T, int R, int C> friend bool operator ==(const matrix<T, R, C>& m1,
+			const matrix<T, R, C>& m2);
+	template<typename T, int R, int C> friend bool operator !=(const matrix<T, R, C>& m1,
+			const matrix<T, R, C>& m2);
 
-	template<typename T> friend matrix<T> tran(const matrix<T> m);
-	template <typename T> friend matrix<T> mul(const matrix<T> m1,
-			const matrix<T> m2);
+	template<typename T, int R, int C> friend matrix<T, C, R> tran(const matrix<T, R, C>& m);
+	template <typename T, int R, int K> friend matrix<T, R, 1> mul(const matrix<T, R, K>& m1,
+			const matrix<T, K, 1>& m2);
 };
 
 #include "matrix.cpp"
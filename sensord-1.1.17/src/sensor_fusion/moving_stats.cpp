@@ -0,0 +1,102 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef _MOVING_STATS_H_
+
+#define MOVING_STATS_MIN_LENGTH	2
+
+template <typename TYPE, int CAPACITY>
+moving_stats<TYPE, CAPACITY>::moving_stats()
+{
+	reset(CAPACITY, 0);
+}
+
+template <typename TYPE, int CAPACITY>
+void moving_stats<TYPE, CAPACITY>::reset(const int length, const TYPE fill_val)
+{
+	m_length = length;
+
+	if (m_length < MOVING_STATS_MIN_LENGTH)
+		m_length = MOVING_STATS_MIN_LENGTH;
+	else if (m_length > CAPACITY)
+		m_length = CAPACITY;
+
+	for (int i = 0; i < m_length; i++)
+		m_window[i] = fill_val;
+
+	m_head = 0;
+	resync();
+}
+
+template <typename TYPE, int CAPACITY>
+void moving_stats<TYPE, CAPACITY>::insert(const TYPE val)
+{
+	double old_val = m_window[m_head];
+	double new_val = val;
+	double delta, mean;
+
+	m_window[m_head] = val;
+
+	if (++m_head == m_length) {
+		m_head = 0;
+		resync();
+		return;
+	}
+
+	delta = new_val - old_val;
+	mean = m_mean + delta / m_length;
+
+	m_m2 += delta * ((new_val - mean) + (old_val - m_mean));
+	m_mean = mean;
+
+	if (m_m2 < 0)
+		m_m2 = 0;
+}
+
+template <typename TYPE, int CAPACITY>
+void moving_stats<TYPE, CAPACITY>::resync(void)
+{
+	double sum = 0;
+	double diff;
+
+	for (int i = 0; i < m_length; i++)
+		sum += m_window[i];
+
+	m_mean = sum / m_length;
+
+	m_m2 = 0;
+	for (int i = 0; i < m_length; i++) {
+		diff = m_window[i] - m_mean;
+		m_m2 += diff * diff;
+	}
+}
+
+template <typename TYPE, int CAPACITY>
+TYPE moving_stats<TYPE, CAPACITY>::get_mean(void) const
+{
+	return (TYPE) m_mean;
+}
+
+template <typename TYPE, int CAPACITY>
+TYPE moving_stats<TYPE, CAPACITY>::get_var(void) const
+{
+	return (TYPE) (m_m2 / (m_length - 1));
+}
+
+#endif /* _MOVING_STATS_H_ */
@@ -0,0 +1,48 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _MOVING_STATS_H_
+#define _MOVING_STATS_H_
+
+// Mean and sample variance of the last m_length samples, kept in a ring of
+// up to CAPACITY entries. insert() is O(1): it folds the new sample in and
+// the evicted one out of running Welford sums, and recomputes the sums
+// exactly once per trip around the ring so rounding error cannot build up.
+template <typename TYPE, int CAPACITY>
+class moving_stats {
+public:
+	TYPE m_window[CAPACITY];
+	int m_length;
+	int m_head;
+	double m_mean;
+	double m_m2;
+
+	moving_stats();
+
+	void reset(const int length, const TYPE fill_val);
+	void insert(const TYPE val);
+	void resync(void);
+
+	TYPE get_mean(void) const;
+	TYPE get_var(void) const;
+};
+
+#include "moving_stats.cpp"
+
+#endif /* _MOVING_STATS_H_ */
@@ -22,8 +22,6 @@
 
 #include "orientation_filter.h"
 
-//Windowing is used for buffering of previous samples for statistical analysis
-#define MOVING_AVERAGE_WINDOW_LENGTH	20
 //Earth's Gravity
 #define GRAVITY		9.80665
 #define PI		3.141593
@@ -42,46 +40,10 @@
 
 #define NEGLIGIBLE_VAL 0.0000001
 
-#define ABS(val) (((val) < 0) ? -(val) : (val))
-
-// M-matrix, V-vector, MxN=> matrix dimension, R-RowCount, C-Column count
-#define M3X3R	3
-#define M3X3C	3
-#define M6X6R	6
-#define M6X6C	6
-#define V1x3S	3
-#define V1x4S	4
-#define V1x6S	6
-
 template <typename TYPE>
 orientation_filter<TYPE>::orientation_filter()
 {
-	TYPE arr[MOVING_AVERAGE_WINDOW_LENGTH];
-
-	std::fill_n(arr, MOVING_AVERAGE_WINDOW_LENGTH, NON_ZERO_VAL);
-
-	vect<TYPE> vec(MOVING_AVERAGE_WINDOW_LENGTH, arr);
-	vect<TYPE> vec1x3(V1x3S);
-	vect<TYPE> vec1x6(V1x6S);
-	matrix<TYPE> mat6x6(M6X6R, M6X6C);
-
-	m_var_gyr_x = vec;
-	m_var_gyr_y = vec;
-	m_var_gyr_z = vec;
-	m_var_roll = vec;
-	m_var_pitch = vec;
-	m_var_azimuth = vec;
-
-	m_tran_mat = mat6x6;
-	m_measure_mat = mat6x6;
-	m_pred_cov = mat6x6;
-	m_driv_cov = mat6x6;
-	m_aid_cov = mat6x6;
-
-	m_bias_correction = vec1x3;
-	m_state_new = vec1x6;
-	m_state_old = vec1x6;
-	m_state_error = vec1x6;
+	set_moving_average_window(MOVING_AVERAGE_WINDOW_LENGTH);
 
 	m_pitch_phase_compensation = 1;
 	m_roll_phase_compensation = 1;
@@ -97,23 +59,40 @@ orientation_filter<TYPE>::~orientation_filter()
 }
 
 template <typename TYPE>
-inline void orientation_filter<TYPE>::initialize_sensor_data(const sensor_data<TYPE> accel,
-		const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic)
+void orientation_filter<TYPE>::set_moving_average_window(const int length)
 {
-	unsigned long long sample_interval_gyro = SAMPLE_INTV;
+	m_var_gyr_x.reset(length, (TYPE) NON_ZERO_VAL);
+	m_var_gyr_y.reset(length, (TYPE) NON_ZERO_VAL);
+	m_var_gyr_z.reset(length, (TYPE) NON_ZERO_VAL);
+	m_var_roll.reset(length, (TYPE) NON_ZERO_VAL);
+	m_var_pitch.reset(length, (TYPE) NON_ZERO_VAL);
+	m_var_azimuth.reset(length, (TYPE) NON_ZERO_VAL);
+}
 
+template <typename TYPE>
+inline void orientation_filter<TYPE>::initialize_aiding_data(const sensor_data<TYPE> &accel,
+		const sensor_data<TYPE> &magnetic)
+{
 	m_accel.m_data = accel.m_data;
-	m_gyro.m_data = gyro.m_data;
 	m_magnetic.m_data = magnetic.m_data;
 
+	m_accel.m_time_stamp = accel.m_time_stamp;
+	m_magnetic.m_time_stamp = magnetic.m_time_stamp;
+}
+
+template <typename TYPE>
+inline void orientation_filter<TYPE>::initialize_gyro_data(const sensor_data<TYPE> &gyro)
+{
+	unsigned long long sample_interval_gyro = SAMPLE_INTV;
+
+	m_gyro.m_data = gyro.m_data;
+
 	if (m_gyro.m_time_stamp != 0 && gyro.m_time_stamp != 0)
 		sample_interval_gyro = 	gyro.m_time_stamp - m_gyro.m_time_stamp;
 
 	m_gyro_dt = sample_interval_gyro * US2S;
 
-	m_accel.m_time_stamp = accel.m_time_stamp;
 	m_gyro.m_time_stamp = gyro.m_time_stamp;
-	m_magnetic.m_time_stamp = magnetic.m_time_stamp;
 
 	m_gyro.m_data = m_gyro.m_data - m_bias_correction;
 }
@@ -124,17 +103,17 @@ inline void orientation_filter<TYPE>::orientation_triad_algorithm()
 	TYPE arr_acc_e[V1x3S] = {0.0, 0.0, 1.0};
 	TYPE arr_mag_e[V1x3S] = {0.0, (TYPE) m_magnetic_alignment_factor, 0.0};
 
-	vect<TYPE> acc_e(V1x3S, arr_acc_e);
-	vect<TYPE> mag_e(V1x3S, arr_mag_e);
+	vect<TYPE, V1x3S> acc_e(arr_acc_e);
+	vect<TYPE, V1x3S> mag_e(arr_mag_e);
 
-	vect<TYPE> acc_b_x_mag_b = cross(m_accel.m_data, m_magnetic.m_data);
-	vect<TYPE> acc_e_x_mag_e = cross(acc_e, mag_e);
+	vect<TYPE, V1x3S> acc_b_x_mag_b = cross(m_accel.m_data, m_magnetic.m_data);
+	vect<TYPE, V1x3S> acc_e_x_mag_e = cross(acc_e, mag_e);
 
-	vect<TYPE> cross1 = cross(acc_b_x_mag_b, m_accel.m_data);
-	vect<TYPE> cross2 = cross(acc_e_x_mag_e, acc_e);
+	vect<TYPE, V1x3S> cross1 = cross(acc_b_x_mag_b, m_accel.m_data);
+	vect<TYPE, V1x3S> cross2 = cross(acc_e_x_mag_e, acc_e);
 
-	matrix<TYPE> mat_b(M3X3R, M3X3C);
-	matrix<TYPE> mat_e(M3X3R, M3X3C);
+	matrix<TYPE, M3X3R, M3X3C> mat_b;
+	matrix<TYPE, M3X3R, M3X3C> mat_e;
 
 	for(int i = 0; i < M3X3R; i++)
 	{
@@ -146,7 +125,7 @@ inline void orientation_filter<TYPE>::orientation_triad_algorithm()
 		mat_e.m_mat[i][2] = cross2.m_vec[i];
 	}
 
-	matrix<TYPE> mat_b_t = tran(mat_b);
+	matrix<TYPE, M3X3R, M3X3C> mat_b_t = tran(mat_b);
 	rotation_matrix<TYPE> rot_mat(mat_e * mat_b_t);
 
 	m_quat_aid = rot_mat2quat(rot_mat);
@@ -155,33 +134,23 @@ inline void orientation_filter<TYPE>::orientation_triad_algorithm()
 template <typename TYPE>
 inline void orientation_filter<TYPE>::compute_covariance()
 {
-	TYPE var_gyr_x, var_gyr_y, var_gyr_z;
-	TYPE var_roll, var_pitch, var_azimuth;
-
-	insert_end(m_var_gyr_x, m_gyro.m_data.m_vec[0]);
-	insert_end(m_var_gyr_y, m_gyro.m_data.m_vec[1]);
-	insert_end(m_var_gyr_z, m_gyro.m_data.m_vec[2]);
-	insert_end(m_var_roll, m_orientation.m_ang.m_vec[0]);
-	insert_end(m_var_pitch, m_orientation.m_ang.m_vec[1]);
-	insert_end(m_var_azimuth, m_orientation.m_ang.m_vec[2]);
-
-	var_gyr_x = var(m_var_gyr_x);
-	var_gyr_y = var(m_var_gyr_y);
-	var_gyr_z = var(m_var_gyr_z);
-	var_roll = var(m_var_roll);
-	var_pitch = var(m_var_pitch);
-	var_azimuth = var(m_var_azimuth);
-
-	m_driv_cov.m_mat[0][0] = var_gyr_x;
-	m_driv_cov.m_mat[1][1] = var_gyr_y;
-	m_driv_cov.m_mat[2][2] = var_gyr_z;
+	m_var_gyr_x.insert(m_gyro.m_data.m_vec[0]);
+	m_var_gyr_y.insert(m_gyro.m_data.m_vec[1]);
+	m_var_gyr_z.insert(m_gyro.m_data.m_vec[2]);
+	m_var_roll.insert(m_orientation.m_ang.m_vec[0]);
+	m_var_pitch.insert(m_orientation.m_ang.m_vec[1]);
+	m_var_azimuth.insert(m_orientation.m_ang.m_vec[2]);
+
+	m_driv_cov.m_mat[0][0] = m_var_gyr_x.get_var();
+	m_driv_cov.m_mat[1][1] = m_var_gyr_y.get_var();
+	m_driv_cov.m_mat[2][2] = m_var_gyr_z.get_var();
 	m_driv_cov.m_mat[3][3] = (TYPE) QWB_CONST;
 	m_driv_cov.m_mat[4][4] = (TYPE) QWB_CONST;
 	m_driv_cov.m_mat[5][5] = (TYPE) QWB_CONST;
 
-	m_aid_cov.m_mat[0][0] = var_roll;
-	m_aid_cov.m_mat[1][1] = var_pitch;
-	m_aid_cov.m_mat[2][2] = var_azimuth;
+	m_aid_cov.m_mat[0][0] = m_var_roll.get_var();
+	m_aid_cov.m_mat[1][1] = m_var_pitch.get_var();
+	m_aid_cov.m_mat[2][2] = m_var_azimuth.get_var();
 }
 
 template <typename TYPE>
@@ -208,7 +177,7 @@ inline void orientation_filter<TYPE>::time_update()
 	if (is_initialized(m_state_old))
 		m_state_new = transpose(mul(m_tran_mat, transpose(m_state_old)));
 
-	m_pred_cov = (m_tran_mat * m_pred_cov * tran(m_tran_mat)) + m_driv_cov;
+	predict_covariance(m_pred_cov, m_tran_mat, m_driv_cov);
 
 	if(!is_initialized(m_quat_driv.m_quat))
 		m_quat_driv = m_quat_aid;
@@ -256,55 +225,54 @@ inline void orientation_filter<TYPE>::time_update()
 template <typename TYPE>
 inline void orientation_filter<TYPE>::measurement_update()
 {
-	matrix<TYPE> gain(M6X6R, M6X6C);
-	TYPE iden = 0;
-
-	for (int j=0; j<M6X6C; ++j) {
-		for (int i=0; i<M6X6R; ++i)	{
-			gain.m_mat[i][j] = m_pred_cov.m_mat[j][i] / (m_pred_cov.m_mat[j][j] + m_aid_cov.m_mat[j][j]);
-
-			m_state_new.m_vec[i] = m_state_new.m_vec[i] + gain.m_mat[i][j] * m_state_error.m_vec[j];
-
-			if (i == j)
-				iden = 1;
-			else
-				iden = 0;
-
-			m_pred_cov.m_mat[j][i] = (iden - (gain.m_mat[i][j] * m_measure_mat.m_mat[j][i])) *
-					m_pred_cov.m_mat[j][i];
-
-			if (ABS(m_pred_cov.m_mat[j][i]) < NEGLIGIBLE_VAL)
-				m_pred_cov.m_mat[j][i] = NEGLIGIBLE_VAL;
-		}
-	}
+	update_covariance(m_pred_cov, m_state_new, m_state_error, m_aid_cov,
+			m_measure_mat, (TYPE) NEGLIGIBLE_VAL);
 
 	m_state_old = m_state_new;
 
-	TYPE arr_bias[V1x3S] = {m_state_new.m_vec[3], m_state_new.m_vec[4], m_state_new.m_vec[5]};
-	vect<TYPE> vec(V1x3S, arr_bias);
-
-	m_bias_correction = vec;
+	m_bias_correction.m_vec[0] = m_state_new.m_vec[3];
+	m_bias_correction.m_vec[1] = m_state_new.m_vec[4];
+	m_bias_correction.m_vec[2] = m_state_new.m_vec[5];
 }
 
+// Recomputes the aiding attitude. It only has to run when a new accel or
+// magnetic sample arrives; until then update_gyro() keeps correcting
+// against the last one.
 template <typename TYPE>
-euler_angles<TYPE> orientation_filter<TYPE>::get_orientation(const sensor_data<TYPE> accel,
-		const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic)
+void orientation_filter<TYPE>::update_aiding(const sensor_data<TYPE> &accel,
+		const sensor_data<TYPE> &magnetic)
 {
-	euler_angles<TYPE> cor_euler_ang;
-
-	initialize_sensor_data(accel, gyro, magnetic);
+	initialize_aiding_data(accel, magnetic);
 
 	normalize(m_accel);
-	m_gyro.m_data = m_gyro.m_data * (TYPE) PI;
 	normalize(m_magnetic);
 
 	orientation_triad_algorithm();
+}
+
+// One prediction/correction cycle driven by a gyro sample. update_aiding()
+// must have run at least once before.
+template <typename TYPE>
+void orientation_filter<TYPE>::update_gyro(const sensor_data<TYPE> &gyro)
+{
+	initialize_gyro_data(gyro);
+
+	m_gyro.m_data = m_gyro.m_data * (TYPE) PI;
 
 	compute_covariance();
 
 	time_update();
 
 	measurement_update();
+}
+
+template <typename TYPE>
+euler_angles<TYPE> orientation_filter<TYPE>::get_orientation(const sensor_data<TYPE> accel,
+		const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic)
+{
+	update_aiding(accel, magnetic);
+
+	update_gyro(gyro);
 
 	return m_orientation;
 }
@@ -327,4 +295,28 @@ quaternion<TYPE> orientation_filter<TYPE>::get_quaternion(const sensor_data<TYPE
 	return m_quaternion;
 }
 
+// Runs count samples through the filter in one call, for FIFO bursts and
+// replays. The arrays are parallel, one entry per gyro sample; an accel or
+// magnetic entry that repeats the previous timestamp is treated as "no new
+// sample" and the aiding step is skipped. Either output array may be NULL.
+template <typename TYPE>
+void orientation_filter<TYPE>::get_orientation_batch(const sensor_data<TYPE> *accel,
+		const sensor_data<TYPE> *gyro, const sensor_data<TYPE> *magnetic,
+		const int count, quaternion<TYPE> *quaternions,
+		euler_angles<TYPE> *orientations)
+{
+	for (int i = 0; i < count; i++) {
+		if (i == 0 || accel[i].m_time_stamp != accel[i - 1].m_time_stamp ||
+				magnetic[i].m_time_stamp != magnetic[i - 1].m_time_stamp)
+			update_aiding(accel[i], magnetic[i]);
+
+		update_gyro(gyro[i]);
+
+		if (quaternions)
+			quaternions[i] = m_quaternion;
+		if (orientations)
+			orientations[i] = m_orientation;
+	}
+}
+
 #endif  //_ORIENTATION_FILTER_H_
@@ -26,6 +26,21 @@
 #include "quaternion.h"
 #include "euler_angles.h"
 #include "rotation_matrix.h"
+#include "kalman_kernels.h"
+#include "moving_stats.h"
+
+//Windowing is used for buffering of previous samples for statistical analysis
+#define MOVING_AVERAGE_WINDOW_LENGTH	20
+#define MOVING_AVERAGE_WINDOW_MAX	64
+
+// M-matrix, V-vector, MxN=> matrix dimension, R-RowCount, C-Column count
+#define M3X3R	3
+#define M3X3C	3
+#define M6X6R	6
+#define M6X6C	6
+#define V1x3S	3
+#define V1x4S	4
+#define V1x6S	6
 
 template <typename TYPE>
 class orientation_filter {
@@ -33,21 +48,21 @@ public:
 	sensor_data<TYPE> m_accel;
 	sensor_data<TYPE> m_gyro;
 	sensor_data<TYPE> m_magnetic;
-	vect<TYPE> m_var_gyr_x;
-	vect<TYPE> m_var_gyr_y;
-	vect<TYPE> m_var_gyr_z;
-	vect<TYPE> m_var_roll;
-	vect<TYPE> m_var_pitch;
-	vect<TYPE> m_var_azimuth;
-	matrix<TYPE> m_driv_cov;
-	matrix<TYPE> m_aid_cov;
-	matrix<TYPE> m_tran_mat;
-	matrix<TYPE> m_measure_mat;
-	matrix<TYPE> m_pred_cov;
-	vect<TYPE> m_state_new;
-	vect<TYPE> m_state_old;
-	vect<TYPE> m_state_error;
-	vect<TYPE> m_bias_correction;
+	moving_stats<TYPE, MOVING_AVERAGE_WINDOW_MAX> m_var_gyr_x;
+	moving_stats<TYPE, MOVING_AVERAGE_WINDOW_MAX> m_var_gyr_y;
+	moving_stats<TYPE, MOVING_AVERAGE_WINDOW_MAX> m_var_gyr_z;
+	moving_stats<TYPE, MOVING_AVERAGE_WINDOW_MAX> m_var_roll;
+	moving_stats<TYPE, MOVING_AVERAGE_WINDOW_MAX> m_var_pitch;
+	moving_stats<TYPE, MOVING_AVERAGE_WINDOW_MAX> m_var_azimuth;
+	matrix<TYPE, M6X6R, M6X6C> m_driv_cov;
+	matrix<TYPE, M6X6R, M6X6C> m_aid_cov;
+	matrix<TYPE, M6X6R, M6X6C> m_tran_mat;
+	matrix<TYPE, M6X6R, M6X6C> m_measure_mat;
+	matrix<TYPE, M6X6R, M6X6C> m_pred_cov;
+	vect<TYPE, V1x6S> m_state_new;
+	vect<TYPE, V1x6S> m_state_old;
+	vect<TYPE, V1x6S> m_state_error;
+	vect<TYPE, V1x3S> m_bias_correction;
 	quaternion<TYPE> m_quat_aid;
 	quaternion<TYPE> m_quat_driv;
 	rotation_matrix<TYPE> m_rot_matrix;
@@ -63,19 +78,30 @@ public:
 	orientation_filter();
 	~orientation_filter();
 
-	inline void initialize_sensor_data(const sensor_data<TYPE> accel,
-			const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic);
+	void set_moving_average_window(const int length);
+
+	inline void initialize_aiding_data(const sensor_data<TYPE> &accel,
+			const sensor_data<TYPE> &magnetic);
+	inline void initialize_gyro_data(const sensor_data<TYPE> &gyro);
 	inline void orientation_triad_algorithm();
 	inline void compute_covariance();
 	inline void time_update();
 	inline void measurement_update();
 
+	void update_aiding(const sensor_data<TYPE> &accel,
+			const sensor_data<TYPE> &magnetic);
+	void update_gyro(const sensor_data<TYPE> &gyro);
+
 	euler_angles<TYPE> get_orientation(const sensor_data<TYPE> accel,
 			const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic);
 	rotation_matrix<TYPE> get_rotation_matrix(const sensor_data<TYPE> accel,
 			const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic);
 	quaternion<TYPE> get_quaternion(const sensor_data<TYPE> accel,
 			const sensor_data<TYPE> gyro, const sensor_data<TYPE> magnetic);
+	void get_orientation_batch(const sensor_data<TYPE> *accel,
+			const sensor_data<TYPE> *gyro, const sensor_data<TYPE> *magnetic,
+			const int count, quaternion<TYPE> *quaternions,
+			euler_angles<TYPE> *orientations);
 };
 
 #include "orientation_filter.cpp"
@@ -21,8 +21,6 @@
 
 #include <math.h>
 
-#define QUAT_SIZE 4
-
 template <typename T> int sgn(T val) {
 	if (val >= 0)
 		return 1;
@@ -38,21 +36,21 @@ template <typename T> T mag(T val) {
 }
 
 template <typename TYPE>
-quaternion<TYPE>::quaternion() : m_quat(QUAT_SIZE)
+quaternion<TYPE>::quaternion()
 {
 }
 
 template <typename TYPE>
 quaternion<TYPE>::quaternion(const TYPE w, const TYPE x, const TYPE y, const TYPE z)
 {
-	TYPE vec_data[QUAT_SIZE] = {w, x, y, z};
-
-	vect<TYPE> v(QUAT_SIZE, vec_data);
-	m_quat = v;
+	m_quat.m_vec[0] = w;
+	m_quat.m_vec[1] = x;
+	m_quat.m_vec[2] = y;
+	m_quat.m_vec[3] = z;
 }
 
 template <typename TYPE>
-quaternion<TYPE>::quaternion(const vect<TYPE> v)
+quaternion<TYPE>::quaternion(const vect<TYPE, QUAT_SIZE>& v)
 {
 	m_quat = v;
 }
@@ -80,16 +78,13 @@ template <typename TYPE>
 void quaternion<TYPE>::quat_normalize()
 {
 	TYPE w, x, y, z;
-	TYPE val;
 
 	w = m_quat.m_vec[0] * m_quat.m_vec[0];
 	x = m_quat.m_vec[1] * m_quat.m_vec[1];
 	y = m_quat.m_vec[2] * m_quat.m_vec[2];
 	z = m_quat.m_vec[3] * m_quat.m_vec[3];
 
-	val = sqrt(w + x + y + z);
-
-	m_quat = m_quat / val;
+	m_quat = m_quat * fast_rsqrt(w + x + y + z);
 }
 
 template <typename T>
@@ -145,4 +140,59 @@ quaternion<T> phase_correction(const quaternion<T> q1, const quaternion<T> q2)
 
 	return q;
 }
+
+// Spherical linear interpolation from q1 (t = 0) to q2 (t = 1) along the
+// shorter arc. Nearly parallel inputs fall back to a normalised lerp, where
+// sin() of the angle between them is too small to divide by.
+template<typename T>
+quaternion<T> slerp(const quaternion<T> &q1, const quaternion<T> &q2, const T t)
+{
+	const T LERP_THRESHOLD = (T) 0.9995;
+	T dot = 0;
+	T sign = 1;
+	T s1, s2;
+
+	for (int i = 0; i < QUAT_SIZE; i++)
+		dot += q1.m_quat.m_vec[i] * q2.m_quat.m_vec[i];
+
+	if (dot < 0) {
+		dot = -dot;
+		sign = -1;
+	}
+
+	if (dot > LERP_THRESHOLD) {
+		s1 = 1 - t;
+		s2 = t;
+	} else {
+		T theta = acos(dot);
+		T sin_theta = sin(theta);
+
+		s1 = sin((1 - t) * theta) / sin_theta;
+		s2 = sin(t * theta) / sin_theta;
+	}
+
+	quaternion<T> q(q1.m_quat * s1 + q2.m_quat * (s2 * sign));
+	q.quat_normalize();
+
+	return q;
+}
+
+// g times the bottom row of quat2rot_mat(q), i.e. the gravity vector in the
+// frame q rotates into. Skips the rotation matrix -> Euler -> sin/cos round
+// trip when only the gravity direction is wanted. q must be unit length.
+template<typename T>
+vect<T, 3> quat2gravity(const quaternion<T> &q, const T g)
+{
+	T w = q.m_quat.m_vec[0];
+	T x = q.m_quat.m_vec[1];
+	T y = q.m_quat.m_vec[2];
+	T z = q.m_quat.m_vec[3];
+	vect<T, 3> v;
+
+	v.m_vec[0] = g * 2 * ((x * z) + (w * y));
+	v.m_vec[1] = g * 2 * ((y * z) - (w * x));
+	v.m_vec[2] = g * (1 - 2 * ((x * x) + (y * y)));
+
+	return v;
+}
 #endif  //_QUATERNION_H_
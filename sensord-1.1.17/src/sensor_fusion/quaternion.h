@@ -21,15 +21,18 @@
 #define _QUATERNION_H_
 
 #include "vector.h"
+#include "fast_math.h"
+
+#define QUAT_SIZE 4
 
 template <typename TYPE>
 class quaternion {
 public:
-	vect<TYPE> m_quat;
+	vect<TYPE, QUAT_SIZE> m_quat;
 
 	quaternion();
 	quaternion(const TYPE w, const TYPE x, const TYPE y, const TYPE z);
-	quaternion(const vect<TYPE> v);
+	quaternion(const vect<TYPE, QUAT_SIZE>& v);
 	quaternion(const quaternion<TYPE>& q);
 	~quaternion();
 
@@ -44,6 +47,10 @@ public:
 			const quaternion<T> q2);
 	template<typename T> friend quaternion<T> phase_correction(const quaternion<T> q1,
 			const quaternion<T> q2);
+	template<typename T> friend quaternion<T> slerp(const quaternion<T> &q1,
+			const quaternion<T> &q2, const T t);
+	template<typename T> friend vect<T, 3> quat2gravity(const quaternion<T> &q,
+			const T g);
 };
 
 #include "quaternion.cpp"
@@ -0,0 +1,91 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef _RESAMPLER_H_
+
+template <typename T>
+quaternion<T> interpolate(const quaternion<T> &v1, const quaternion<T> &v2, const T t)
+{
+	return slerp(v1, v2, t);
+}
+
+template <typename T, int N>
+vect<T, N> interpolate(const vect<T, N> &v1, const vect<T, N> &v2, const T t)
+{
+	return v1 * (1 - t) + v2 * t;
+}
+
+template <typename TYPE, typename VALUE>
+resampler<TYPE, VALUE>::resampler()
+{
+	reset();
+}
+
+template <typename TYPE, typename VALUE>
+void resampler<TYPE, VALUE>::reset(void)
+{
+	m_prev_time = 0;
+	m_last_out_time = 0;
+	m_primed = false;
+}
+
+// Feeds one filter output taken at time and writes the grid points that
+// have come due since the previous one into outs/out_times. Returns how
+// many were written, at most max_outs. The first input, and any input
+// after a gap longer than max_outs intervals, is passed through as is and
+// restarts the grid from its own timestamp.
+template <typename TYPE, typename VALUE>
+int resampler<TYPE, VALUE>::resample(const VALUE &value, const unsigned long long time,
+		const unsigned long long interval, VALUE *outs,
+		unsigned long long *out_times, const int max_outs)
+{
+	unsigned long long next_time;
+	int count = 0;
+
+	if (m_primed && time <= m_prev_time)
+		return 0;
+
+	next_time = m_last_out_time + interval;
+
+	if (!m_primed || !interval || time > next_time + interval * (max_outs - 1)) {
+		outs[count] = value;
+		out_times[count++] = time;
+		m_last_out_time = time;
+	} else {
+		while (next_time <= time && count < max_outs) {
+			TYPE t = 0;
+
+			if (next_time > m_prev_time)
+				t = (TYPE) (next_time - m_prev_time) / (TYPE) (time - m_prev_time);
+
+			outs[count] = interpolate(m_prev_value, value, t);
+			out_times[count++] = next_time;
+			m_last_out_time = next_time;
+			next_time += interval;
+		}
+	}
+
+	m_prev_value = value;
+	m_prev_time = time;
+	m_primed = true;
+
+	return count;
+}
+
+#endif /* _RESAMPLER_H_ */
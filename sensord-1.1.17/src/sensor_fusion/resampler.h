@@ -0,0 +1,57 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _RESAMPLER_H_
+#define _RESAMPLER_H_
+
+#include "vector.h"
+#include "quaternion.h"
+
+// Upper bound on the outputs one input may produce, so a client asking for
+// a much faster rate than the filter runs at cannot flood the dispatcher.
+#define RESAMPLER_MAX_OUTPUTS	4
+
+// Re-times a stream of filter outputs onto a client's own output grid,
+// every interval microseconds. Outputs that fall between two inputs are
+// interpolated: quaternions by slerp(), vectors linearly. The filter can
+// then run at whatever rate it needs while each consumer sees its own.
+template <typename TYPE, typename VALUE>
+class resampler {
+public:
+	VALUE m_prev_value;
+	unsigned long long m_prev_time;
+	unsigned long long m_last_out_time;
+	bool m_primed;
+
+	resampler();
+
+	void reset(void);
+	int resample(const VALUE &value, const unsigned long long time,
+			const unsigned long long interval, VALUE *outs,
+			unsigned long long *out_times, const int max_outs);
+};
+
+template <typename T>
+quaternion<T> interpolate(const quaternion<T> &v1, const quaternion<T> &v2, const T t);
+template <typename T, int N>
+vect<T, N> interpolate(const vect<T, N> &v1, const vect<T, N> &v2, const T t);
+
+#include "resampler.cpp"
+
+#endif /* _RESAMPLER_H_ */
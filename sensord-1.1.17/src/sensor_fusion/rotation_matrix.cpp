@@ -19,32 +19,26 @@
 
 #if defined (_ROTATION_MATRIX_H_) && defined (_MATRIX_H_)
 
-#define QUAT_LEN 4
-#define ROT_MAT_ROWS 3
-#define ROT_MAT_COLS 3
-
 template <typename T> T get_sign(T val)
 {
 	return (val >= (T) 0) ? (T) 1 : (T) -1;
 }
 
 template <typename TYPE>
-rotation_matrix<TYPE>::rotation_matrix() : m_rot_mat(ROT_MAT_ROWS, ROT_MAT_COLS)
+rotation_matrix<TYPE>::rotation_matrix()
 {
 
 }
 
 template <typename TYPE>
-rotation_matrix<TYPE>::rotation_matrix(const matrix<TYPE> m)
+rotation_matrix<TYPE>::rotation_matrix(const matrix<TYPE, ROT_MAT_ROWS, ROT_MAT_COLS>& m)
 {
 	m_rot_mat = m;
 }
 
 template <typename TYPE>
-rotation_matrix<TYPE>::rotation_matrix(const int rows, const int cols, TYPE *mat_data)
+rotation_matrix<TYPE>::rotation_matrix(const TYPE *mat_data) : m_rot_mat(mat_data)
 {
-	matrix<TYPE> m(rows, cols, mat_data);
-	m_rot_mat = m;
 }
 
 template <typename TYPE>
@@ -88,7 +82,7 @@ rotation_matrix<T> quat2rot_mat(quaternion<T> q)
 	R[2][1] = 2 * ((y * z) - (w * x));
 	R[2][2] = (2 * w * w) - 1 + (2 * z * z);
 
-	rotation_matrix<T> rm(ROT_MAT_ROWS, ROT_MAT_COLS, &R[0][0]);
+	rotation_matrix<T> rm(&R[0][0]);
 
 	return rm;
 }
@@ -102,8 +96,9 @@ quaternion<T> rot_mat2quat(rotation_matrix<T> rm)
 
 	if ( diag_sum > 0 )
 	{
-		T val = (T) 0.5 / sqrt(diag_sum + (T) 1.0);
-		q0 = (T) 0.25 / val;
+		T sum = diag_sum + (T) 1.0;
+		T val = (T) 0.5 * fast_rsqrt(sum);
+		q0 = sum * val;
 		q1 = ( rm.m_rot_mat.m_mat[2][1] - rm.m_rot_mat.m_mat[1][2] ) * val;
 		q2 = ( rm.m_rot_mat.m_mat[0][2] - rm.m_rot_mat.m_mat[2][0] ) * val;
 		q3 = ( rm.m_rot_mat.m_mat[1][0] - rm.m_rot_mat.m_mat[0][1] ) * val;
@@ -112,27 +107,30 @@ quaternion<T> rot_mat2quat(rotation_matrix<T> rm)
 	{
 		if ( rm.m_rot_mat.m_mat[0][0] > rm.m_rot_mat.m_mat[1][1] && rm.m_rot_mat.m_mat[0][0] > rm.m_rot_mat.m_mat[2][2] )
 		{
-			T val = (T) 2.0 * sqrt( 1.0 + rm.m_rot_mat.m_mat[0][0] - rm.m_rot_mat.m_mat[1][1] - rm.m_rot_mat.m_mat[2][2]);
-			q0 = (rm.m_rot_mat.m_mat[2][1] - rm.m_rot_mat.m_mat[1][2] ) / val;
-			q1 = (T) 0.25 * val;
-			q2 = (rm.m_rot_mat.m_mat[0][1] + rm.m_rot_mat.m_mat[1][0] ) / val;
-			q3 = (rm.m_rot_mat.m_mat[0][2] + rm.m_rot_mat.m_mat[2][0] ) / val;
+			T sum = (T) 1.0 + rm.m_rot_mat.m_mat[0][0] - rm.m_rot_mat.m_mat[1][1] - rm.m_rot_mat.m_mat[2][2];
+			T val = (T) 0.5 * fast_rsqrt(sum);
+			q0 = (rm.m_rot_mat.m_mat[2][1] - rm.m_rot_mat.m_mat[1][2] ) * val;
+			q1 = sum * val;
+			q2 = (rm.m_rot_mat.m_mat[0][1] + rm.m_rot_mat.m_mat[1][0] ) * val;
+			q3 = (rm.m_rot_mat.m_mat[0][2] + rm.m_rot_mat.m_mat[2][0] ) * val;
 		}
 		else if (rm.m_rot_mat.m_mat[1][1] > rm.m_rot_mat.m_mat[2][2])
 		{
-			T val = (T) 2.0 * sqrt( 1.0 + rm.m_rot_mat.m_mat[1][1] - rm.m_rot_mat.m_mat[0][0] - rm.m_rot_mat.m_mat[2][2]);
-			q0 = (rm.m_rot_mat.m_mat[0][2] - rm.m_rot_mat.m_mat[2][0] ) / val;
-			q1 = (rm.m_rot_mat.m_mat[0][1] + rm.m_rot_mat.m_mat[1][0] ) / val;
-			q2 = (T) 0.25 * val;
-			q3 = (rm.m_rot_mat.m_mat[1][2] + rm.m_rot_mat.m_mat[2][1] ) / val;
+			T sum = (T) 1.0 + rm.m_rot_mat.m_mat[1][1] - rm.m_rot_mat.m_mat[0][0] - rm.m_rot_mat.m_mat[2][2];
+			T val = (T) 0.5 * fast_rsqrt(sum);
+			q0 = (rm.m_rot_mat.m_mat[0][2] - rm.m_rot_mat.m_mat[2][0] ) * val;
+			q1 = (rm.m_rot_mat.m_mat[0][1] + rm.m_rot_mat.m_mat[1][0] ) * val;
+			q2 = sum * val;
+			q3 = (rm.m_rot_mat.m_mat[1][2] + rm.m_rot_mat.m_mat[2][1] ) * val;
 		}
 		else
 		{
-			T val = (T) 2.0 * sqrt( 1.0 + rm.m_rot_mat.m_mat[2][2] - rm.m_rot_mat.m_mat[0][0] - rm.m_rot_mat.m_mat[1][1] );
-			q0 = (rm.m_rot_mat.m_mat[1][0] - rm.m_rot_mat.m_mat[0][1] ) / val;
-			q1 = (rm.m_rot_mat.m_mat[0][2] + rm.m_rot_mat.m_mat[2][0] ) / val;
-			q2 = (rm.m_rot_mat.m_mat[1][2] + rm.m_rot_mat.m_mat[2][1] ) / val;
-			q3 = (T) 0.25 * val;
+			T sum = (T) 1.0 + rm.m_rot_mat.m_mat[2][2] - rm.m_rot_mat.m_mat[0][0] - rm.m_rot_mat.m_mat[1][1];
+			T val = (T) 0.5 * fast_rsqrt(sum);
+			q0 = (rm.m_rot_mat.m_mat[1][0] - rm.m_rot_mat.m_mat[0][1] ) * val;
+			q1 = (rm.m_rot_mat.m_mat[0][2] + rm.m_rot_mat.m_mat[2][0] ) * val;
+			q2 = (rm.m_rot_mat.m_mat[1][2] + rm.m_rot_mat.m_mat[2][1] ) * val;
+			q3 = sum * val;
 		}
 	}
 
@@ -21,10 +21,8 @@
 
 #include "math.h"
 
-#define SENSOR_DATA_SIZE 3
-
 template <typename TYPE>
-sensor_data<TYPE>::sensor_data() : m_data(SENSOR_DATA_SIZE), m_time_stamp(0)
+sensor_data<TYPE>::sensor_data() : m_time_stamp(0)
 {
 }
 
@@ -32,15 +30,14 @@ template <typename TYPE>
 sensor_data<TYPE>::sensor_data(const TYPE x, const TYPE y,
 		const TYPE z, const unsigned long long time_stamp)
 {
-	TYPE vec_data[SENSOR_DATA_SIZE] = {x, y, z};
-
-	vect<TYPE> v(SENSOR_DATA_SIZE, vec_data);
-	m_data = v;
+	m_data.m_vec[0] = x;
+	m_data.m_vec[1] = y;
+	m_data.m_vec[2] = z;
 	m_time_stamp = time_stamp;
 }
 
 template <typename TYPE>
-sensor_data<TYPE>::sensor_data(const vect<TYPE> v,
+sensor_data<TYPE>::sensor_data(const vect<TYPE, SENSOR_DATA_SIZE>& v,
 		const unsigned long long time_stamp)
 {
 	m_data = v;
@@ -19,85 +19,24 @@
 
 #if defined (_VECTOR_H_) && defined (_MATRIX_H_)
 
-template <typename TYPE>
-vect<TYPE>::vect(void)
+template <typename TYPE, int SIZE>
+vect<TYPE, SIZE>::vect(void)
 {
-	m_vec = NULL;
+	for (int j = 0; j < SIZE; j++)
+		m_vec[j] = 0;
 }
 
-template <typename TYPE>
-vect<TYPE>::vect(const int size)
+template <typename TYPE, int SIZE>
+vect<TYPE, SIZE>::vect(const TYPE *vec_data)
 {
-	m_size = size;
-	m_vec = NULL;
-	m_vec = new TYPE [m_size]();
-}
-
-template <typename TYPE>
-vect<TYPE>::vect(const int size, TYPE *vec_data)
-{
-	m_size = size;
-	m_vec = NULL;
-	m_vec = new TYPE [m_size];
-
-	for (int j = 0; j < m_size; j++)
+	for (int j = 0; j < SIZE; j++)
 		m_vec[j] = *vec_data++;
 }
 
-template <typename TYPE>
-vect<TYPE>::vect(const vect<TYPE>& v)
-{
-	m_size = v.m_size;
-	m_vec = NULL;
-	m_vec = new TYPE [m_size];
-
-	for (int q = 0; q < m_size; q++)
-		m_vec[q] = v.m_vec[q];
-}
-
-template <typename TYPE>
-vect<TYPE>::~vect()
-{
-	if (m_vec != NULL)
-		delete[] m_vec;
-}
-
-template <typename TYPE>
-vect<TYPE> vect<TYPE>::operator =(const vect<TYPE>& v)
+template <typename TYPE, int SIZE>
+ostream& operator <<(ostream& dout, const vect<TYPE, SIZE>& v)
 {
-	if (this == &v)
-	{
-		return *this;
-	}
-
-	if (m_vec == NULL)
-	{
-		m_size = v.m_size;
-		m_vec = new TYPE [m_size];
-	}
-	else
-	{
-		if (m_size != v.m_size)
-		{
-			delete[] m_vec;
-
-			m_size = v.m_size;
-			m_vec = new TYPE [m_size];
-		}
-	}
-
-
-	for (int q = 0; q < m_size; q++)
-		m_vec[q] = v.m_vec[q];
-
-
-	return *this;
-}
-
-template <typename TYPE>
-ostream& operator <<(ostream& dout, vect<TYPE>& v)
-{
-	for (int j = 0; j < v.m_size; j++)
+	for (int j = 0; j < SIZE; j++)
 	{
 		dout << v.m_vec[j] << "\t";
 	}
@@ -107,65 +46,58 @@ ostream& operator <<(ostream& dout, vect<TYPE>& v)
 	return dout;
 }
 
-template <typename T>
-vect<T> operator +(const vect<T> v1, const vect<T> v2)
+template <typename T, int N>
+vect<T, N> operator +(const vect<T, N>& v1, const vect<T, N>& v2)
 {
-	assert(v1.m_size == v2.m_size);
+	vect<T, N> v3;
 
-	vect<T> v3(v1.m_size);
-
-	for (int j = 0; j < v1.m_size; j++)
+	for (int j = 0; j < N; j++)
 		v3.m_vec[j] = v1.m_vec[j] + v2.m_vec[j];
 
 	return v3;
 }
 
-template <typename T>
-vect<T> operator +(const vect<T> v, const T val)
+template <typename T, int N>
+vect<T, N> operator +(const vect<T, N>& v, const T val)
 {
-	vect<T> v1(v.m_size);
+	vect<T, N> v1;
 
-	for (int j = 0; j < v.m_size; j++)
+	for (int j = 0; j < N; j++)
 		v1.m_vec[j] = v.m_vec[j] + val;
 
 	return v1;
 }
 
-template <typename T>
-vect<T> operator -(const vect<T> v1, const vect<T> v2)
+template <typename T, int N>
+vect<T, N> operator -(const vect<T, N>& v1, const vect<T, N>& v2)
 {
-	assert(v1.m_size == v2.m_size);
-
-	vect<T> v3(v1.m_size);
+	vect<T, N> v3;
 
-	for (int j = 0; j < v1.m_size; j++)
+	for (int j = 0; j < N; j++)
 		v3.m_vec[j] = v1.m_vec[j] - v2.m_vec[j];
 
 	return v3;
 }
 
-template <typename T>
-vect<T> operator -(const vect<T> v, const T val)
+template <typename T, int N>
+vect<T, N> operator -(const vect<T, N>& v, const T val)
 {
-	vect<T> v1(v.m_size);
+	vect<T, N> v1;
 
-	for (int j = 0; j < v.m_size; j++)
+	for (int j = 0; j < N; j++)
 		v1.m_vec[j] = v.m_vec[j] - val;
 
 	return v1;
 }
 
-template <typename T>
-matrix<T> operator *(const matrix<T> m, const vect<T> v)
+template <typename T, int N>
+matrix<T, N, N> operator *(const matrix<T, N, 1>& m, const vect<T, N>& v)
 {
-	assert(m.m_rows == v.m_size);
-	assert(m.m_cols == 1);
-
-	matrix<T> m1(m.m_rows, v.m_size);
+	matrix<T, N, N> m1;
 
-	for (int i = 0; i < m1.m_rows; i++)
+	for (int i = 0; i < N; i++)
 	{
-		for (int j = 0; j < m1.m_cols; j++)
+		for (int j = 0; j < N; j++)
 		{
 			m1.m_mat[i][j] = m.m_mat[i][0] * v.m_vec[j];
 		}
@@ -174,117 +106,107 @@ matrix<T> operator *(const matrix<T> m, const vect<T> v)
 	return m1;
 }
 
-template <typename T>
-vect<T> operator *(const vect<T> v, const matrix<T> m)
+template <typename T, int R, int C>
+vect<T, C> operator *(const vect<T, R>& v, const matrix<T, R, C>& m)
 {
-	assert(m.m_rows == v.m_size);
-	assert(m.m_cols != 1);
+	vect<T, C> v1;
 
-	vect<T> v1(m.m_cols);
-
-	for (int j = 0; j < m.m_cols; j++)
+	for (int j = 0; j < C; j++)
 	{
-		v1.m_vec[j] = 0;
-		for (int k = 0; k < m.m_rows; k++)
-			v1.m_vec[j] += v.m_vec[k] * m.m_mat[k][j];
+		T sum = 0;
+		for (int k = 0; k < R; k++)
+			sum += v.m_vec[k] * m.m_mat[k][j];
+		v1.m_vec[j] = sum;
 	}
 
 	return v1;
 }
 
-template <typename T>
-vect<T> operator *(const vect<T> v, const T val)
+template <typename T, int N>
+vect<T, N> operator *(const vect<T, N>& v, const T val)
 {
-	vect<T> v1(v.m_size);
+	vect<T, N> v1;
 
-	for (int j = 0; j < v.m_size; j++)
+	for (int j = 0; j < N; j++)
 		v1.m_vec[j] = v.m_vec[j] * val;
 
 	return v1;
 }
 
-template <typename T>
-vect<T> operator /(const vect<T> v, const T val)
+template <typename T, int N>
+vect<T, N> operator /(const vect<T, N>& v, const T val)
 {
-	vect<T> v1(v.m_size);
+	vect<T, N> v1;
 
-	for (int j = 0; j < v.m_size; j++)
+	for (int j = 0; j < N; j++)
 		v1.m_vec[j] = v.m_vec[j] / val;
 
 	return v1;
 }
 
-template <typename T>
-bool operator ==(const vect<T> v1, const vect<T> v2)
+template <typename T, int N>
+bool operator ==(const vect<T, N>& v1, const vect<T, N>& v2)
 {
-	if (v1.m_size == v2.m_size)
-	{
-		for (int i = 0; i < v1.m_size; i++)
-			if (v1.m_vec[i] != v2.m_vec[i])
-				return false;
-	}
-	else
-		return false;
+	for (int i = 0; i < N; i++)
+		if (v1.m_vec[i] != v2.m_vec[i])
+			return false;
 
 	return true;
 }
 
-template <typename T>
-bool operator !=(const vect<T> v1, const vect<T> v2)
+template <typename T, int N>
+bool operator !=(const vect<T, N>& v1, const vect<T, N>& v2)
 {
 	return (!(v1 == v2));
 }
 
-template <typename T>
-matrix<T> transpose(const vect<T> v)
+template <typename T, int N>
+matrix<T, N, 1> transpose(const vect<T, N>& v)
 {
-	matrix<T> m(v.m_size, 1);
+	matrix<T, N, 1> m;
 
-	for (int i = 0; i < v.m_size; i++)
+	for (int i = 0; i < N; i++)
 		m.m_mat[i][0] = v.m_vec[i];
 
 	return m;
 }
 
-template <typename T>
-vect<T> transpose(const matrix<T> m)
+template <typename T, int N>
+vect<T, N> transpose(const matrix<T, N, 1>& m)
 {
-	vect<T> v(m.m_rows);
+	vect<T, N> v;
 
-	for (int i = 0; i < m.m_rows; i++)
+	for (int i = 0; i < N; i++)
 		v.m_vec[i] = m.m_mat[i][0];
 
 	return v;
 }
 
-template <typename T>
-T mul(const vect<T> v, const matrix<T> m)
+template <typename T, int N>
+T mul(const vect<T, N>& v, const matrix<T, N, 1>& m)
 {
-	assert(m.m_rows == v.m_size);
-	assert(m.m_cols == 1);
-
 	T result = (T) 0;
 
-	for (int k = 0; k < v.m_size; k++)
+	for (int k = 0; k < N; k++)
 		result += v.m_vec[k] * m.m_mat[k][0];
 
 	return result;
 }
 
 
-template <typename T>
-void insert_end(vect<T>& v, T val)
+template <typename T, int N>
+void insert_end(vect<T, N>& v, T val)
 {
-	for (int i = 0; i < (v.m_size - 1); i++)
+	for (int i = 0; i < (N - 1); i++)
 		v.m_vec[i] = v.m_vec[i+1];
 
-	v.m_vec[v.m_size-1] = val;
+	v.m_vec[N-1] = val;
 }
 
 template <typename T>
-vect<T> cross(const vect<T> v1, const vect<T> v2)
+vect<T, 3> cross(const vect<T, 3>& v1, const vect<T, 3>& v2)
 {
-	vect<T> v3(v1.m_size);
+	vect<T, 3> v3;
 
 	v3.m_vec[0] = ((v1.m_vec[1] * v2.m_vec[2]) - (v1.m_vec[2] * v2.m_vec[1]));
 	v3.m_vec[1] = ((v1.m_vec[2] * v2.m_vec[0]) - (v1.m_vec[0] * v2.m_vec[2]));
@@ -293,38 +215,36 @@ vect<T> cross(const vect<T> v1, const vect<T> v2)
 	return v3;
 }
 
-template <typename T>
-bool is_initialized(const vect<T> v)
+template <typename T, int N>
+bool is_initialized(const vect<T, N>& v)
 {
-	vect<T> v1(v.m_size);
-	bool retval;
+	for (int i = 0; i < N; i++)
+		if (v.m_vec[i] != 0)
+			return true;
 
-	retval = (v == v1) ? false : true;
-
-	return retval;
+	return false;
 }
 
-template <typename T>
-T var(const vect<T> v)
+template <typename T, int N>
+T var(const vect<T, N>& v)
 {
 	T val = 0;
 	T mean, var, diff;
 
-	for (int i = 0; i < v.m_size; i++)
+	for (int i = 0; i < N; i++)
 		val += v.m_vec[i];
 
-	mean = val / v.m_size;
+	mean = val / N;
 
 	val = 0;
-	for (int i = 0; i < v.m_size; i++)
+	for (int i = 0; i < N; i++)
 	{
 		diff = (v.m_vec[i] - mean);
 		val += diff * diff;
 	}
 
-	var = val / (v.m_size - 1);
+	var = val / (N - 1);
 
 	return var;
 }
 #endif
-
@@ -22,51 +22,46 @@
 
 #include "matrix.h"
 
-template <typename TYPE>
+template <typename TYPE, int SIZE>
 class vect {
 public:
-	int m_size;
-	TYPE *m_vec;
+	static const int m_size = SIZE;
+	TYPE m_vec[SIZE];
 
 	vect(void);
-	vect(const int size);
-	vect(const int size, TYPE *vec_data);
-	vect(const vect<TYPE>& v);
-	~vect();
+	explicit vect(const TYPE *vec_data);
 
-	vect<TYPE> operator =(const vect<TYPE>& v);
-
-	template<typename T> friend ostream& operator << (ostream& dout,
-			vect<T>& v);
-	template<typename T> friend vect<T> operator +(const vect<T> v1,
-			const vect<T> v2);
-	template<typename T> friend vect<T> operator +(const vect<T> v,
+	template<typename T, int N> friend ostream& operator << (ostream& dout,
+			const vect<T, N>& v);
+	template<typename T, int N> friend vect<T, N> operator +(const vect<T, N>& v1,
+			const vect<T, N>& v2);
+	template<typename T, int N> friend vect<T, N> operator +(const vect<T, N>& v,
 			const T val);
-	template<typename T> friend vect<T> operator -(const vect<T> v1,
-			const vect<T> v2);
-	template<typename T> friend vect<T> operator -(const vect<T> v,
+	template<typename T, int N> friend vect<T, N> operator -(const vect<T, N>& v1,
+			const vect<T, N>& v2);
+	template<typename T, int N> friend vect<T, N> operator -(const vect<T, N>& v,
 			const T val);
-	template<typename T> friend matrix<T> operator *(const matrix<T> v1,
-			const vect<T> v2);
-	template<typename T> friend vect<T> operator *(const vect<T> v,
-			const matrix<T> m);
-	template<typename T> friend vect<T> operator *(const vect<T> v,
+	template<typename T, int N> friend matrix<T, N, N> operator *(const matrix<T, N, 1>& v1,
+			const vect<T, N>& v2);
+	template<typename T, int R, int C> friend vect<T, C> operator *(const vect<T, R>& v,
+			const matrix<T, R, C>& m);
+	template<typename T, int N> friend vect<T, N> operator *(const vect<T, N>& v,
 			const T val);
-	template<typename T> friend vect<T> operator /(const vect<T> v1,
+	template<typename T, int N> friend vect<T, N> operator /(const vect<T, N>& v1,
 			const T val);
-	template<typename T> friend bool operator ==(const vect<T> v1,
-			const vect<T> v2);
-	template<typename T> friend bool operator !=(const vect<T> v1,
-			const vect<T> v2);
+	template<typename T, int N> friend bool operator ==(const vect<T, N>& v1,
+			const vect<T, N>& v2);
+	template<typename T, int N> friend bool operator !=(const vect<T, N>& v1,
+			const vect<T, N>& v2);
 
-	template<typename T> friend T mul(const vect<T> v, const matrix<T> m);
-	template<typename T> friend void insert_end(vect<T>& v, T val);
-	template<typename T> friend matrix<T> transpose(const vect<T> v);
-	template <typename T> friend vect<T> transpose(const matrix<T> m);
-	template<typename T> friend vect<T> cross(const vect<T> v1,
-			const vect<T> v2);
-	template <typename T> friend T var(const vect<T> v);
-	template <typename T> friend bool is_initialized(const vect<T> v);
+	template<typename T, int N> friend T mul(const vect<T, N>& v, const matrix<T, N, 1>& m);
+	template<typename T, int N> friend void insert_end(vect<T, N>& v, T val);
+	template<typename T, int N> friend matrix<T, N, 1> transpose(const vect<T, N>& v);
+	template <typename T, int N> friend vect<T, N> transpose(const matrix<T, N, 1>& m);
+	template<typename T> friend vect<T, 3> cross(const vect<T, 3>& v1,
+			const vect<T, 3>& v2);
+	template <typename T, int N> friend T var(const vect<T, N>& v);
+	template <typename T, int N> friend bool is_initialized(const vect<T, N>& v);
 };
 
 #include "vector.cpp"
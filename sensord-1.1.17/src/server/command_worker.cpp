@@ -24,32 +24,27 @@
 #include <string>
 #include <utility>
 #include <permission_checker.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
 
 using std::string;
 using std::make_pair;
 
 command_worker::cmd_handler_t command_worker::m_cmd_handlers[];
 sensor_raw_data_map command_worker::m_sensor_raw_data_map;
-cpacket command_worker::m_sensor_list;
+sensor_list_map command_worker::m_sensor_lists;
+int command_worker::m_permission_set = SENSOR_PERMISSION_NONE;
 
 command_worker::command_worker(const csocket& socket)
 : m_client_id(CLIENT_ID_INVALID)
 , m_permission(SENSOR_PERMISSION_NONE)
+, m_reactor(NULL)
 , m_socket(socket)
+, m_recv_size(0)
 , m_module(NULL)
+, m_batching(false)
 {
-	static bool init = false;
-
-	if (!init) {
-		init_cmd_handlers();
-		make_sensor_raw_data_map();
-
-		init = true;
-	}
-
-	m_worker.set_context(this);
-	m_worker.set_working(working);
-	m_worker.set_stopped(stopped);
 }
 
 command_worker::~command_worker()
@@ -58,9 +53,22 @@ command_worker::~command_worker()
 }
 
 
-bool command_worker::start(void)
+/*
+ * Must run once, after the sensor plugins are loaded and before the first
+ * client is accepted
+ */
+void command_worker::init(void)
 {
-	return m_worker.start();
+	init_cmd_handlers();
+	make_sensor_raw_data_map();
+	make_sensor_lists();
+	publish_sensor_list();
+}
+
+bool command_worker::start(creactor &reactor)
+{
+	m_reactor = &reactor;
+	return reactor.add(m_socket.get_socket_fd(), working, stopped, this);
 }
 
 void command_worker::init_cmd_handlers(void)
@@ -79,6 +87,41 @@ void command_worker::init_cmd_handlers(void)
 	m_cmd_handlers[CMD_SET_COMMAND]			= &command_worker::cmd_set_command;
 	m_cmd_handlers[CMD_GET_DATA]			= &command_worker::cmd_get_data;
 	m_cmd_handlers[CMD_SEND_SENSORHUB_DATA]	= &command_worker::cmd_send_sensorhub_data;
+	m_cmd_handlers[CMD_BATCH]				= &command_worker::cmd_batch;
+}
+
+bool command_worker::is_batchable(int cmd)
+{
+	switch (cmd) {
+	case CMD_START:
+	case CMD_STOP:
+	case CMD_REG:
+	case CMD_UNREG:
+	case CMD_SET_OPTION:
+	case CMD_SET_INTERVAL:
+	case CMD_UNSET_INTERVAL:
+	case CMD_SET_COMMAND:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Commands that can wait on a sensor HAL or sleep, and so run on a reactor
+ * worker instead of a reactor thread. A batch may carry START or STOP.
+ */
+bool command_worker::is_blocking(int cmd)
+{
+	switch (cmd) {
+	case CMD_START:
+	case CMD_STOP:
+	case CMD_GET_DATA:
+	case CMD_BATCH:
+		return true;
+	default:
+		return false;
+	}
 }
 
 void command_worker::get_sensor_list(int permissions, cpacket &sensor_list)
@@ -129,6 +172,78 @@ void command_worker::get_sensor_list(int permissions, cpacket &sensor_list)
 
 }
 
+/*
+ * Serializes the sensor list once for every set of permissions a client can
+ * hold, so CMD_GET_SENSOR_LIST only has to send the matching one
+ */
+void command_worker::make_sensor_lists(void)
+{
+	int permission;
+	cpacket *sensor_list;
+
+	auto it_raw_data = m_sensor_raw_data_map.begin();
+
+	while (it_raw_data != m_sensor_raw_data_map.end()) {
+		m_permission_set |= it_raw_data->first;
+		++it_raw_data;
+	}
+
+	permission = m_permission_set;
+
+	while (true) {
+		sensor_list = new(std::nothrow) cpacket;
+		retm_if(!sensor_list, "Failed to allocate memory");
+
+		get_sensor_list(permission, *sensor_list);
+		m_sensor_lists[permission] = sensor_list;
+
+		if (!permission)
+			break;
+
+		permission = (permission - 1) & m_permission_set;
+	}
+}
+
+void command_worker::publish_sensor_list(void)
+{
+	const char *tmp_path = SENSOR_LIST_PATH ".tmp";
+	sensor_list_file_t header;
+	cmd_get_sensor_list_done_t *list;
+	int fd;
+
+	auto it_sensor_list = m_sensor_lists.find(SENSOR_PERMISSION_STANDARD & m_permission_set);
+	retm_if(it_sensor_list == m_sensor_lists.end(), "No sensor list to publish");
+
+	list = (cmd_get_sensor_list_done_t *)it_sensor_list->second->data();
+
+	header.magic = SENSOR_LIST_MAGIC;
+	header.hidden_cnt = m_sensor_raw_data_map.size() - list->sensor_cnt;
+	header.size = it_sensor_list->second->payload_size();
+
+	unlink(tmp_path);
+
+	fd = open(tmp_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IRGRP | S_IROTH);
+	retm_if(fd < 0, "Failed to create %s, errno : %d , errstr : %s", tmp_path, errno, strerror(errno));
+
+	if ((write(fd, &header, sizeof(header)) != (ssize_t) sizeof(header)) ||
+		(write(fd, list, header.size) != (ssize_t) header.size)) {
+		ERR("Failed to write %s, errno : %d , errstr : %s", tmp_path, errno, strerror(errno));
+		close(fd);
+		unlink(tmp_path);
+		return;
+	}
+
+	close(fd);
+
+	if (rename(tmp_path, SENSOR_LIST_PATH) < 0) {
+		ERR("Failed to publish %s, errno : %d , errstr : %s", SENSOR_LIST_PATH, errno, strerror(errno));
+		unlink(tmp_path);
+		return;
+	}
+
+	INFO("Published %d sensors to %s, %d hidden", list->sensor_cnt, SENSOR_LIST_PATH, header.hidden_cnt);
+}
+
 void command_worker::make_sensor_raw_data_map(void)
 {
 	vector<sensor_base *> sensors;
@@ -152,41 +267,81 @@ void command_worker::make_sensor_raw_data_map(void)
 	}
 }
 
+/*
+ * Runs on a reactor thread each time the socket turns readable. Reads
+ * without blocking, dispatching every packet that completes, and leaves a
+ * partial one in m_header and m_packet until the rest arrives. m_packet
+ * keeps its storage between packets, so the steady state doesn't allocate.
+ * A blocking command stops the reading here and is dispatched by deferred()
+ * on a reactor worker; the reactor re-arms the socket after it for the
+ * packets behind it.
+ */
 bool command_worker::working(void *ctx)
 {
-	bool ret;
 	command_worker *inst = (command_worker *)ctx;
+	packet_header *header = (packet_header *)inst->m_header.buffer;
+
+	while (true) {
+		char *buffer;
+		size_t size;
+		ssize_t len;
+
+		if (inst->m_recv_size < sizeof(packet_header)) {
+			buffer = inst->m_header.buffer + inst->m_recv_size;
+			size = sizeof(packet_header) - inst->m_recv_size;
+		} else {
+			buffer = (char *)inst->m_packet.data() + (inst->m_recv_size - sizeof(packet_header));
+			size = sizeof(packet_header) + header->size - inst->m_recv_size;
+		}
 
-	packet_header header;
-	char *payload;
-
-	if (inst->m_socket.recv(&header, sizeof(header)) <= 0) {
-		string info;
-		inst->get_info(info);
-		DBG("%s failed to receive header", info.c_str());
-		return false;
-	}
-
-	if (header.size > 0) {
+		len = inst->m_socket.recv_available(buffer, size);
 
-		payload = new(std::nothrow) char[header.size];
-		retvm_if(!payload, false, "Failed to allocate memory");
+		if (len == -EAGAIN)
+			return true;
 
-		if (inst->m_socket.recv(payload, header.size) <= 0) {
+		if (len <= 0) {
 			string info;
 			inst->get_info(info);
-			DBG("%s failed to receive data of packet", info.c_str());
-			delete[] payload;
+			DBG("%s failed to receive %s", info.c_str(),
+				inst->m_recv_size < sizeof(packet_header) ? "header" : "data of packet");
 			return false;
 		}
-	} else {
-		payload = NULL;
+
+		inst->m_recv_size += len;
+
+		if (inst->m_recv_size < sizeof(packet_header))
+			continue;
+
+		if (inst->m_recv_size == sizeof(packet_header)) {
+			if (!inst->m_packet.set_payload_size(header->size))
+				return false;
+		}
+
+		if (inst->m_recv_size < sizeof(packet_header) + header->size)
+			continue;
+
+		if (is_blocking(packet_cmd(header)) && inst->m_reactor->defer(deferred))
+			return true;
+
+		if (!inst->dispatch_packet())
+			return false;
 	}
+}
+
+bool command_worker::deferred(void *ctx)
+{
+	command_worker *inst = (command_worker *)ctx;
+
+	return inst->dispatch_packet();
+}
 
-	ret = inst->dispatch_command(header.cmd, payload);
+bool command_worker::dispatch_packet(void)
+{
+	packet_header *header = (packet_header *)m_header.buffer;
+	bool ret;
 
-	if (payload)
-		delete[] payload;
+	ret = dispatch_command(packet_cmd(header), packet_sensor(header), m_packet.data());
+	m_recv_size = 0;
 
 	return ret;
 }
@@ -195,48 +350,68 @@ bool command_worker::working(void *ctx)
 bool command_worker::stopped(void *ctx)
 {
 	string info;
-	event_type_vector event_vec;
 	command_worker *inst = (command_worker *)ctx;
 
 	inst->get_info(info);
 	INFO("%s is stopped", info.c_str());
 
-	if ((inst->m_module) && (inst->m_client_id != CLIENT_ID_INVALID)) {
+	if (inst->m_client_id != CLIENT_ID_INVALID) {
+		auto it_module = inst->m_modules.begin();
 
-		get_client_info_manager().get_registered_events(inst->m_client_id, inst->m_module->get_id(), event_vec);
+		while (it_module != inst->m_modules.end()) {
+			inst->cleanup_module(it_module->second);
+			++it_module;
+		}
+	}
 
-		auto it_event = event_vec.begin();
+	delete inst;
+	return true;
+}
 
-		while (it_event != event_vec.end()) {
-			WARN("Does not unregister event[0x%x] before connection broken for [%s]!!", *it_event, inst->m_module->get_name());
-			if (!inst->m_module->delete_client(*it_event))
-				ERR("Unregistering event[0x%x] failed", *it_event);
+void command_worker::cleanup_module(sensor_base *module)
+{
+	event_type_vector event_vec;
 
-			++it_event;
-		}
+	get_client_info_manager().get_registered_events(m_client_id, module->get_id(), event_vec);
 
-		if (get_client_info_manager().is_started(inst->m_client_id, inst->m_module->get_id())) {
-			WARN("Does not receive cmd_stop before connection broken for [%s]!!", inst->m_module->get_name());
-			inst->m_module->delete_interval(inst->m_client_id, false);
-			inst->m_module->stop();
-		}
+	auto it_event = event_vec.begin();
 
-		if (inst->m_module->get_id()) {
-			if (get_client_info_manager().has_sensor_record(inst->m_client_id, inst->m_module->get_id())) {
-				INFO("Removing sensor[0x%x] record for client_id[%d]", inst->m_module->get_id(), inst->m_client_id);
-				get_client_info_manager().remove_sensor_record(inst->m_client_id, inst->m_module->get_id());
-			}
-		}
+	while (it_event != event_vec.end()) {
+		WARN("Does not unregister event[0x%x] before connection broken for [%s]!!", *it_event, module->get_name());
+		if (!module->delete_client(*it_event))
+			ERR("Unregistering event[0x%x] failed", *it_event);
+
+		++it_event;
 	}
 
-	delete inst;
-	return true;
+	if (get_client_info_manager().is_started(m_client_id, module->get_id())) {
+		WARN("Does not receive cmd_stop before connection broken for [%s]!!", module->get_name());
+		module->delete_interval(m_client_id, false);
+		module->stop();
+	}
+
+	if (module->get_id()) {
+		if (get_client_info_manager().has_sensor_record(m_client_id, module->get_id())) {
+			INFO("Removing sensor[0x%x] record for client_id[%d]", module->get_id(), m_client_id);
+			get_client_info_manager().remove_sensor_record(m_client_id, module->get_id());
+		}
+	}
 }
 
-bool command_worker::dispatch_command(int cmd, void* payload)
+/*
+ * A packet naming a sensor selects the module that sensor was greeted with
+ * on this connection; one naming none keeps the module of a legacy
+ * per-sensor channel.
+ */
+bool command_worker::dispatch_command(int cmd, sensor_id_t sensor, void* payload)
 {
 	int ret = false;
 
+	if (sensor != UNKNOWN_SENSOR) {
+		auto it_module = m_modules.find(sensor);
+		m_module = (it_module != m_modules.end()) ? it_module->second : NULL;
+	}
+
 	if (!(cmd > 0 && cmd < CMD_CNT)) {
 		ERR("Unknown command: %d", cmd);
 	} else {
@@ -251,24 +426,25 @@ bool command_worker::dispatch_command(int cmd, void* payload)
 
 bool command_worker::send_cmd_done(long value)
 {
-	cpacket* ret_packet;
 	cmd_done_t *cmd_done;
 
-	ret_packet = new(std::nothrow) cpacket(sizeof(cmd_done_t));
-	retvm_if(!ret_packet, false, "Failed to allocate memory");
+	if (m_batching) {
+		m_batch_results.push_back(value);
+		return true;
+	}
 
-	ret_packet->set_cmd(CMD_DONE);
+	cpacket ret_packet(sizeof(cmd_done_t));
 
-	cmd_done = (cmd_done_t*)ret_packet->data();
+	ret_packet.set_cmd(CMD_DONE);
+
+	cmd_done = (cmd_done_t*)ret_packet.data();
 	cmd_done->value = value;
 
-	if (m_socket.send(ret_packet->packet(), ret_packet->size()) <= 0) {
+	if (m_socket.send(ret_packet.packet(), ret_packet.size()) <= 0) {
 		ERR("Failed to send a cmd_done to client_id [%d] with value [%ld]", m_client_id, value);
-		delete ret_packet;
 		return false;
 	}
 
-	delete ret_packet;
 	return true;
 
 }
@@ -276,65 +452,57 @@ bool command_worker::send_cmd_done(long value)
 
 bool command_worker::send_cmd_get_id_done(int client_id)
 {
-	cpacket* ret_packet;
+	cpacket ret_packet(sizeof(cmd_get_id_done_t));
 	cmd_get_id_done_t *cmd_get_id_done;
 
-	ret_packet = new(std::nothrow) cpacket(sizeof(cmd_get_id_done_t));
-	retvm_if(!ret_packet, false, "Failed to allocate memory");
-
-	ret_packet->set_cmd(CMD_GET_ID);
+	ret_packet.set_cmd(CMD_GET_ID);
 
-	cmd_get_id_done = (cmd_get_id_done_t*)ret_packet->data();
+	cmd_get_id_done = (cmd_get_id_done_t*)ret_packet.data();
 	cmd_get_id_done->client_id = client_id;
 
-	if (m_socket.send(ret_packet->packet(), ret_packet->size()) <= 0) {
+	if (m_socket.send(ret_packet.packet(), ret_packet.size()) <= 0) {
 		ERR("Failed to send a cmd_get_id_done with client_id [%d]", client_id);
-		delete ret_packet;
 		return false;
 	}
 
-	delete ret_packet;
 	return true;
 }
 
 bool command_worker::send_cmd_get_data_done(int state, sensor_data_t *data)
 {
-
-	cpacket* ret_packet;
+	cpacket ret_packet(sizeof(cmd_get_data_done_t));
 	cmd_get_data_done_t *cmd_get_data_done;
 
-	ret_packet = new(std::nothrow) cpacket(sizeof(cmd_get_data_done_t));
-	retvm_if(!ret_packet, false, "Failed to allocate memory");
-
-	ret_packet->set_cmd(CMD_GET_DATA);
+	ret_packet.set_cmd(CMD_GET_DATA);
 
-	cmd_get_data_done = (cmd_get_data_done_t*)ret_packet->data();
+	cmd_get_data_done = (cmd_get_data_done_t*)ret_packet.data();
 	cmd_get_data_done->state = state;
 
 	memcpy(&cmd_get_data_done->base_data , data, sizeof(sensor_data_t));
 
-	if (m_socket.send(ret_packet->packet(), ret_packet->size()) <= 0) {
+	if (m_socket.send(ret_packet.packet(), ret_packet.size()) <= 0) {
 		ERR("Failed to send a cmd_get_data_done");
-		delete ret_packet;
 		return false;
 	}
 
-	delete ret_packet;
 	return true;
 }
 
 
 bool command_worker::send_cmd_get_sensor_list_done(void)
 {
-	cpacket sensor_list;
+	cpacket *sensor_list;
 
 	int permission = get_permission();
 
 	INFO("permission = 0x%x", permission);
 
-	get_sensor_list(permission, sensor_list);
+	auto it_sensor_list = m_sensor_lists.find(permission & m_permission_set);
+	retvm_if(it_sensor_list == m_sensor_lists.end(), false, "No sensor list for permission 0x%x", permission);
+
+	sensor_list = it_sensor_list->second;
 
-	if (m_socket.send(sensor_list.packet(), sensor_list.size()) <= 0) {
+	if (m_socket.send(sensor_list->packet(), sensor_list->size()) <= 0) {
 		ERR("Failed to send a cmd_get_sensor_list_done");
 		return false;
 	}
@@ -342,6 +510,27 @@ bool command_worker::send_cmd_get_sensor_list_done(void)
 	return true;
 }
 
+bool command_worker::send_cmd_batch_done(vector<long> &results)
+{
+	cpacket ret_packet(sizeof(cmd_batch_done_t) + (sizeof(long) * results.size()));
+	cmd_batch_done_t *cmd_batch_done;
+
+	retvm_if(!ret_packet.data(), false, "Failed to allocate memory");
+
+	ret_packet.set_cmd(CMD_BATCH);
+
+	cmd_batch_done = (cmd_batch_done_t*)ret_packet.data();
+	cmd_batch_done->cmd_cnt = results.size();
+	copy(results.begin(), results.end(), cmd_batch_done->value);
+
+	if (m_socket.send(ret_packet.packet(), ret_packet.size()) <= 0) {
+		ERR("Failed to send a cmd_batch_done to client_id [%d]", m_client_id);
+		return false;
+	}
+
+	return true;
+}
+
 bool command_worker::cmd_get_id(void *payload)
 {
 	cmd_get_id_t *cmd;
@@ -406,6 +595,7 @@ bool command_worker::cmd_hello(void *payload)
 	}
 
 	DBG("Hello sensor [0x%x], client id [%d]", m_module->get_id(), m_client_id);
+	m_modules[m_module->get_id()] = m_module;
 	get_client_info_manager().create_sensor_record(m_client_id, m_module->get_id());
 	INFO("New sensor record created for sensor [0x%x], sensor name [%s] on client id [%d]\n", m_module->get_id(), m_module->get_name(), m_client_id);
 	ret_value = OP_SUCCESS;
@@ -434,15 +624,18 @@ bool command_worker::cmd_byebye(void *payload)
 		goto out;
 	}
 
-	m_client_id = CLIENT_ID_INVALID;
+	m_modules.erase(m_module->get_id());
+	m_module = NULL;
 	ret_value = OP_SUCCESS;
 
 out:
 	if (!send_cmd_done(ret_value))
 		ERR("Failed to send cmd_done to a client");
 
-	if (ret_value == OP_SUCCESS)
+	if ((ret_value == OP_SUCCESS) && m_modules.empty()) {
+		m_client_id = CLIENT_ID_INVALID;
 		return false;
+	}
 
 	return true;
 }
@@ -705,12 +898,15 @@ out:
 
 bool command_worker::cmd_get_data(void *payload)
 {
-	const int GET_DATA_MIN_INTERVAL = 10;
+	const unsigned int GET_DATA_MIN_INTERVAL = 10;
+	const unsigned int GET_DATA_WAIT_TIME = 220; //ms
 	cmd_get_data_t *cmd;
 	int state = OP_ERROR;
 	bool adjusted = false;
+	unsigned int interval;
 
 	sensor_data_t data;
+	sensor_event_t event;
 
 	DBG("CMD_GET_VALUE Handler invoked\n");
 
@@ -723,28 +919,42 @@ bool command_worker::cmd_get_data(void *payload)
 		goto out;
 	}
 
+	interval = m_module->get_interval(m_client_id, false);
+
+	// While the sensor streams the requested type, the dispatcher already
+	// holds its latest sample; one older than two of the client's intervals
+	// is treated as stale and read from the sensor instead
+	if (interval && get_event_dispathcher().get_last_event(m_module->get_id(), cmd->type,
+			2000ULL * interval, event)) {
+		data = event.data;
+		state = OP_SUCCESS;
+		goto out;
+	}
+
 	state = m_module->get_sensor_data(cmd->type, data);
 
 	// In case of not getting sensor data, wait short time and retry again
 	// 1. changing interval to be less than 10ms
-	// 2. In case of first time, wait for INIT_WAIT_TIME
-	// 3. at another time, wait for WAIT_TIME
-	// 4. retrying to get data
-	// 5. repeat 2 ~ 4 operations RETRY_CNT times
-	// 6. reverting back to original interval
+	// 2. answering with the next event of the type the event dispatcher
+	//    records, or after GET_DATA_WAIT_TIME, from get_data_resumed()
+	// 3. if it is not recorded or can't be waited for, retrying to get data
+	//    RETRY_CNT times
+	// 4. reverting back to original interval
 	if (!state && !data.timestamp) {
-		const int RETRY_CNT	= 3;
-		const unsigned long long INIT_WAIT_TIME = 20000; //20ms
-		const unsigned long WAIT_TIME = 100000;	//100ms
-		int retry = 0;
-
-		unsigned int interval = m_module->get_interval(m_client_id, false);
-
 		if (interval > GET_DATA_MIN_INTERVAL) {
 			m_module->add_interval(m_client_id, GET_DATA_MIN_INTERVAL, false);
 			adjusted = true;
 		}
 
+		if (get_event_dispathcher().is_record_event(m_module->get_id(), cmd->type) &&
+			request_get_data(cmd->type, interval, adjusted, GET_DATA_WAIT_TIME))
+			return true;
+
+		const int RETRY_CNT	= 3;
+		const unsigned long long INIT_WAIT_TIME = 20000; //20ms
+		const unsigned long WAIT_TIME = 100000;	//100ms
+		int retry = 0;
+
 		while (!state && !data.timestamp && (retry++ < RETRY_CNT)) {
 			INFO("Wait sensor[0x%x] data updated for client [%d] #%d", m_module->get_id(), m_client_id, retry);
 			usleep((retry == 1) ? INIT_WAIT_TIME : WAIT_TIME);
@@ -769,6 +979,79 @@ out:
 	return true;
 }
 
+/*
+ * Suspends the connection until the event dispatcher records the next
+ * event of type or timeout (msec) passes, so no thread waits for it.
+ * Returns false if it can't, without suspending.
+ */
+bool command_worker::request_get_data(unsigned int type, unsigned int interval, bool adjusted, unsigned int timeout)
+{
+	m_get_data.handle = m_reactor->suspend();
+
+	if (!m_get_data.handle)
+		return false;
+
+	INFO("Wait sensor[0x%x] data updated for client [%d]", m_module->get_id(), m_client_id);
+
+	m_get_data.type = type;
+	m_get_data.interval = interval;
+	m_get_data.adjusted = adjusted;
+	m_get_data.answered = false;
+	m_get_data.request.answer = get_data_answered;
+	m_get_data.request.ctx = this;
+
+	if (!get_event_dispathcher().request_next_event(m_module->get_id(), type, timeout, &m_get_data.request))
+		m_reactor->resume(m_get_data.handle, get_data_resumed);
+
+	return true;
+}
+
+/*
+ * Runs on the dispatcher thread with the event, or on a reactor thread
+ * with NULL on timeout, and leaves the reply to a reactor worker
+ */
+void command_worker::get_data_answered(void *ctx, const sensor_event_t *event)
+{
+	command_worker *inst = (command_worker *)ctx;
+
+	if (event) {
+		inst->m_get_data.event = *event;
+		inst->m_get_data.answered = true;
+	}
+
+	inst->m_reactor->resume(inst->m_get_data.handle, get_data_resumed);
+}
+
+bool command_worker::get_data_resumed(void *ctx)
+{
+	command_worker *inst = (command_worker *)ctx;
+	get_data_request_t &get_data = inst->m_get_data;
+	int state = OP_SUCCESS;
+	sensor_data_t data;
+
+	memset(&data, 0, sizeof(data));
+
+	if (get_data.answered)
+		data = get_data.event.data;
+	else
+		state = inst->m_module->get_sensor_data(get_data.type, data);
+
+	if (get_data.adjusted)
+		inst->m_module->add_interval(inst->m_client_id, get_data.interval, false);
+
+	if (!data.timestamp)
+		state = OP_ERROR;
+
+	if (state) {
+		ERR("Failed to get data for client [%d], for sensor [0x%x]",
+			inst->m_client_id, inst->m_module->get_id());
+	}
+
+	inst->send_cmd_get_data_done(state, &data);
+
+	return true;
+}
+
 bool command_worker::cmd_send_sensorhub_data(void *payload)
 {
 	cmd_send_sensorhub_data_t *cmd;
@@ -794,6 +1077,67 @@ out:
 	return true;
 }
 
+/*
+ * Applies the sub-commands in order within this one dispatch, collecting
+ * what each would have sent back as cmd_done, and answers them all at once
+ */
+bool command_worker::cmd_batch(void *payload)
+{
+	cmd_batch_t *cmd;
+	packet_header *sub_packet;
+	size_t payload_size;
+	size_t offset = 0;
+
+	DBG("CMD_BATCH Handler invoked\n");
+
+	cmd = (cmd_batch_t*)payload;
+	payload_size = m_packet.payload_size();
+	m_batch_results.clear();
+
+	if (payload_size < sizeof(cmd_batch_t)) {
+		ERR("Invalid batch of size [%zu] from client [%d]", payload_size, m_client_id);
+		goto out;
+	}
+
+	payload_size -= sizeof(cmd_batch_t);
+	m_batching = true;
+
+	for (size_t i = 0; i < cmd->cmd_cnt; ++i) {
+		sub_packet = (packet_header *)(cmd->data + offset);
+
+		if ((payload_size - offset < sizeof(packet_header)) ||
+			(payload_size - offset - sizeof(packet_header) < sub_packet->size)) {
+			ERR("Truncated sub-command #%d in batch from client [%d]", (int)i, m_client_id);
+			m_batch_results.push_back(OP_ERROR);
+			break;
+		}
+
+		if (!is_batchable(packet_cmd(sub_packet))) {
+			ERR("Command [%d] can't be batched for client [%d]", packet_cmd(sub_packet), m_client_id);
+			m_batch_results.push_back(OP_ERROR);
+			break;
+		}
+
+		dispatch_command(packet_cmd(sub_packet), packet_sensor(sub_packet), sub_packet->data);
+
+		if (m_batch_results.back() < 0)
+			break;
+
+		offset += CMD_BATCH_ALIGN(sizeof(packet_header) + sub_packet->size);
+
+		if (offset > payload_size)
+			offset = payload_size;
+	}
+
+	m_batching = false;
+
+out:
+	if (!send_cmd_batch_done(m_batch_results))
+		ERR("Failed to send cmd_batch_done to a client");
+
+	return true;
+}
+
 void command_worker::get_info(string &info)
 {
 	const char *client_info = NULL;
@@ -20,15 +20,18 @@
 #ifndef COMMAND_WORKER_H_
 #define COMMAND_WORKER_H_
 
-#include <worker_thread.h>
+#include <creactor.h>
 #include <cclient_info_manager.h>
 #include <csensor_event_dispatcher.h>
 #include <sensor_base.h>
 #include <map>
 
 using std::multimap;
+using std::map;
 
 typedef multimap<int, raw_data_t> sensor_raw_data_map;
+typedef map<sensor_id_t, sensor_base *> sensor_module_map;
+typedef map<int, cpacket *> sensor_list_map;
 
 class command_worker {
 private:
@@ -37,28 +40,60 @@ private:
 	static const int OP_ERROR = -1;
 	static const int OP_SUCCESS = 0;
 
+	/* A CMD_GET_DATA waiting, with the connection suspended, for the next event */
+	typedef struct {
+		last_event_request_t request;
+		void *handle;
+		unsigned int type;
+		unsigned int interval;
+		bool adjusted;
+		bool answered;
+		sensor_event_t event;
+	} get_data_request_t;
+
 	int m_client_id;
 	int m_permission;
+	creactor *m_reactor;
 	csocket m_socket;
-	worker_thread m_worker;
+	union {
+		size_t align;
+		char buffer[sizeof(packet_header)];
+	} m_header;
+	cpacket m_packet;
+	size_t m_recv_size;
 	sensor_base *m_module;
+	sensor_module_map m_modules;
+	bool m_batching;
+	vector<long> m_batch_results;
+	get_data_request_t m_get_data;
 	static cmd_handler_t m_cmd_handlers[CMD_CNT];
-	static cpacket m_sensor_list;
 	static sensor_raw_data_map m_sensor_raw_data_map;
+	static sensor_list_map m_sensor_lists;
+	static int m_permission_set;
 
 	static void init_cmd_handlers(void);
 	static void make_sensor_raw_data_map(void);
 	static void get_sensor_list(int permissions, cpacket &sensor_list);
+	static void make_sensor_lists(void);
+	static void publish_sensor_list(void);
+	static bool is_batchable(int cmd);
+	static bool is_blocking(int cmd);
 
 	static bool working(void *ctx);
+	static bool deferred(void *ctx);
+	static void get_data_answered(void *ctx, const sensor_event_t *event);
+	static bool get_data_resumed(void *ctx);
 	static bool stopped(void *ctx);
 
-	bool dispatch_command(int cmd, void *payload);
+	void cleanup_module(sensor_base *module);
+	bool dispatch_packet(void);
+	bool dispatch_command(int cmd, sensor_id_t sensor, void *payload);
 
 	bool send_cmd_done(long value);
 	bool send_cmd_get_id_done(int client_id);
 	bool send_cmd_get_data_done(int state, sensor_data_t *data);
 	bool send_cmd_get_sensor_list_done(void);
+	bool send_cmd_batch_done(vector<long> &results);
 
 	bool cmd_get_id(void *payload);
 	bool cmd_get_sensor_list(void *payload);
@@ -74,7 +109,9 @@ private:
 	bool cmd_set_option(void *payload);
 	bool cmd_set_command(void *payload);
 	bool cmd_get_data(void *payload);
+	bool request_get_data(unsigned int type, unsigned int interval, bool adjusted, unsigned int timeout);
 	bool cmd_send_sensorhub_data(void *payload);
+	bool cmd_batch(void *payload);
 
 	void get_info(string &info);
 
@@ -87,7 +124,9 @@ public:
 	command_worker(const csocket& socket);
 	virtual ~command_worker();
 
-	bool start(void);
+	static void init(void);
+
+	bool start(creactor &reactor);
 
 };
 
@@ -21,9 +21,6 @@
 #include <server.h>
 #include <sensor_plugin_loader.h>
 #include <command_worker.h>
-#include <thread>
-
-using std::thread;
 
 server::server()
 : m_mainloop(NULL)
@@ -54,19 +51,20 @@ int server::get_systemd_socket(const char *name)
 	return -1;
 }
 
-void server::accept_client(void)
+/*
+ * Accepts every pending connection on the non-blocking command socket and
+ * hands each to the reactor, which then serves its commands.
+ */
+bool server::accept_client(void *ctx)
 {
+	server *inst = (server *)ctx;
 	command_worker *cmd_worker;
 
-	INFO("Client acceptor is started");
-
 	while (true) {
 		csocket client_command_socket;
 
-		if (!m_client_accep_socket.accept(client_command_socket)) {
-			ERR("Failed to accept connection request from a client");
-			continue;
-		}
+		if (!inst->m_client_accep_socket.accept(client_command_socket))
+			return true;
 
 		DBG("New client (socket_fd : %d) connected", client_command_socket.get_socket_fd());
 
@@ -74,10 +72,11 @@ void server::accept_client(void)
 
 		if (!cmd_worker) {
 			ERR("Failed to allocate memory");
+			client_command_socket.close();
 			continue;
 		}
 
-		if(!cmd_worker->start())
+		if(!cmd_worker->start(inst->m_reactor))
 			delete cmd_worker;
 	}
 }
@@ -86,9 +85,13 @@ void server::run(void)
 {
 	int sock_fd = -1;
 	const int MAX_PENDING_CONNECTION = 5;
+	const int REACTOR_THREAD_CNT = 2;
+	const int REACTOR_WORKER_CNT = 2;
 
 	m_mainloop = g_main_loop_new(NULL, false);
 
+	command_worker::init();
+
 	sock_fd = get_systemd_socket(COMMAND_CHANNEL_PATH);
 
 	if (sock_fd >= 0) {
@@ -113,10 +116,19 @@ void server::run(void)
 		}
 	}
 
-	csensor_event_dispatcher::get_instance().run();
+	if (!m_reactor.start(REACTOR_THREAD_CNT, REACTOR_WORKER_CNT)) {
+		ERR("Failed to start reactor");
+		return;
+	}
+
+	csensor_event_dispatcher::get_instance().run(m_reactor);
 
-	thread client_accepter(&server::accept_client, this);
-	client_accepter.detach();
+	m_client_accep_socket.set_blocking_mode(false);
+
+	if (!m_reactor.add(m_client_accep_socket.get_socket_fd(), accept_client, NULL, this)) {
+		ERR("Failed to watch command channel");
+		return;
+	}
 
 	sd_notify(0, "READY=1");
 
@@ -22,17 +22,19 @@
 
 #include <glib.h>
 #include <csocket.h>
+#include <creactor.h>
 
 class server
 {
 private:
 	GMainLoop *m_mainloop;
 	csocket m_client_accep_socket;
+	creactor m_reactor;
 
 	server();
 	~server();
 
-	void accept_client(void);
+	static bool accept_client(void *ctx);
 	int get_systemd_socket(const char *name);
 public:
 	void run(void);
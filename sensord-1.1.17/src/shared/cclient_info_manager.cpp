@@ -23,12 +23,22 @@
 
 using std::pair;
 
+static unsigned long long get_listener_key(sensor_id_t sensor_id, unsigned int event_type)
+{
+	return ((unsigned long long)sensor_id << 32) | event_type;
+}
+
 cclient_info_manager::cclient_info_manager()
+: m_listener_index(new event_listener_index())
+, m_index_gen(0)
+, m_reader_gen(0)
 {
 }
 cclient_info_manager::~cclient_info_manager()
 {
 	m_clients.clear();
+	reclaim_listener_indexes(true);
+	delete m_listener_index.load();
 }
 
 cclient_info_manager& cclient_info_manager::get_instance()
@@ -84,6 +94,8 @@ bool cclient_info_manager::register_event(int client_id, sensor_id_t sensor_id,
 	if(!it_record->second.register_event(sensor_id, event_type))
 		return false;
 
+	rebuild_listener_index();
+
 	return true;
 }
 
@@ -101,6 +113,8 @@ bool cclient_info_manager::unregister_event(int client_id, sensor_id_t sensor_id
 	if(!it_record->second.unregister_event(sensor_id, event_type))
 		return false;
 
+	rebuild_listener_index();
+
 	return true;
 }
 
@@ -207,6 +221,7 @@ bool cclient_info_manager::remove_client_record(int client_id)
 	}
 
 	m_clients.erase(it_record);
+	rebuild_listener_index();
 
 	INFO("Client record for client[%d] is removed from client info manager", client_id);
 
@@ -316,6 +331,8 @@ bool cclient_info_manager::remove_sensor_record(int client_id, sensor_id_t senso
 
 	if(!it_record->second.has_sensor_usage())
 		remove_client_record(client_id);
+	else
+		rebuild_listener_index();
 
 	return true;
 }
@@ -400,6 +417,101 @@ bool cclient_info_manager::set_event_socket(int client_id, const csocket &socket
 	}
 
 	it_record->second.set_event_socket(socket);
+	rebuild_listener_index();
 
 	return true;
 }
+
+/*
+ * The listener index maps (sensor_id, event_type) to the event sockets of
+ * listening clients. It is rebuilt under m_mutex whenever registrations or
+ * event sockets change, and published by swapping m_listener_index, so the
+ * dispatcher can look listeners up without taking any lock.
+ *
+ * There is a single reader, the dispatcher thread. Each call to
+ * get_listener_index() marks that the index returned by the previous call
+ * is no longer in use, which lets the writer free the indexes it replaced.
+ */
+const event_listener_index* cclient_info_manager::get_listener_index(void)
+{
+	m_reader_gen.store(m_index_gen.load());
+	return m_listener_index.load();
+}
+
+const event_listener_vec* cclient_info_manager::find_listeners(const event_listener_index *index,
+	sensor_id_t sensor_id, unsigned int event_type)
+{
+	auto it_listeners = index->find(get_listener_key(sensor_id, event_type));
+
+	if (it_listeners == index->end())
+		return NULL;
+
+	return &(it_listeners->second);
+}
+
+void cclient_info_manager::rebuild_listener_index(void)
+{
+	event_listener_index *index;
+	retired_index_t retired;
+
+	index = new(std::nothrow) event_listener_index();
+	retm_if(!index, "Failed to allocate memory");
+
+	auto it_record = m_clients.begin();
+
+	while (it_record != m_clients.end()) {
+		vector<sensor_id_t> sensor_ids;
+		event_listener_t listener;
+
+		listener.client_id = it_record->first;
+		it_record->second.get_event_socket(listener.event_socket);
+
+		if (!listener.event_socket.is_valid()) {
+			++it_record;
+			continue;
+		}
+
+		it_record->second.get_sensor_ids(sensor_ids);
+
+		auto it_sensor_id = sensor_ids.begin();
+
+		while (it_sensor_id != sensor_ids.end()) {
+			event_type_vector event_vec;
+			it_record->second.get_registered_events(*it_sensor_id, event_vec);
+
+			auto it_event = event_vec.begin();
+
+			while (it_event != event_vec.end()) {
+				(*index)[get_listener_key(*it_sensor_id, *it_event)].push_back(listener);
+				++it_event;
+			}
+
+			++it_sensor_id;
+		}
+
+		++it_record;
+	}
+
+	retired.index = m_listener_index.exchange(index);
+	retired.gen = ++m_index_gen;
+	m_retired_indexes.push_back(retired);
+
+	reclaim_listener_indexes(false);
+}
+
+void cclient_info_manager::reclaim_listener_indexes(bool force)
+{
+	unsigned int reader_gen = m_reader_gen.load();
+
+	auto it_retired = m_retired_indexes.begin();
+
+	while (it_retired != m_retired_indexes.end()) {
+		if (!force && ((int)(reader_gen - it_retired->gen) < 0)) {
+			++it_retired;
+			continue;
+		}
+
+		delete it_retired->index;
+		it_retired = m_retired_indexes.erase(it_retired);
+	}
+}
@@ -22,13 +22,25 @@
 
 #include <cclient_sensor_record.h>
 #include <unordered_map>
+#include <list>
+#include <atomic>
 #include <common.h>
 #include <cmutex.h>
 using std::unordered_map;
+using std::list;
+using std::atomic;
 
 typedef unordered_map<int,cclient_sensor_record> client_id_sensor_record_map;
 typedef vector<int> client_id_vec;
 
+typedef struct {
+	int client_id;
+	csocket event_socket;
+} event_listener_t;
+
+typedef vector<event_listener_t> event_listener_vec;
+typedef unordered_map<unsigned long long, event_listener_vec> event_listener_index;
+
 
 class cclient_info_manager {
 public:
@@ -63,10 +75,27 @@ public:
 	bool get_listener_ids(sensor_id_t sensor_id, unsigned int event_type, client_id_vec &id_vec);
 	bool get_event_socket(int client_id, csocket &sock);
 	bool set_event_socket(int client_id, const csocket &sock);
+
+	const event_listener_index* get_listener_index(void);
+	static const event_listener_vec* find_listeners(const event_listener_index *index,
+		sensor_id_t sensor_id, unsigned int event_type);
 private:
+	typedef struct {
+		event_listener_index *index;
+		unsigned int gen;
+	} retired_index_t;
+
 	client_id_sensor_record_map m_clients;
 	cmutex m_mutex;
 
+	atomic<event_listener_index *> m_listener_index;
+	atomic<unsigned int> m_index_gen;
+	atomic<unsigned int> m_reader_gen;
+	list<retired_index_t> m_retired_indexes;
+
+	void rebuild_listener_index(void);
+	void reclaim_listener_indexes(bool force);
+
 	cclient_info_manager();
 	~cclient_info_manager();
 	cclient_info_manager(cclient_info_manager const&) {};
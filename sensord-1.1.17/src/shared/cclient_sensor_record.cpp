@@ -218,6 +218,16 @@ bool cclient_sensor_record::get_registered_events(sensor_id_t sensor_id, event_t
 
 }
 
+void cclient_sensor_record::get_sensor_ids(vector<sensor_id_t> &sensor_ids)
+{
+	auto it_usage = m_sensor_usages.begin();
+
+	while (it_usage != m_sensor_usages.end()) {
+		sensor_ids.push_back(it_usage->first);
+		++it_usage;
+	}
+}
+
 void cclient_sensor_record::set_client_id(int client_id)
 {
 	m_client_id = client_id;
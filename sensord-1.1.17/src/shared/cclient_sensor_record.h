@@ -58,6 +58,7 @@ public:
 	bool has_sensor_usage(sensor_id_t sensor_id);
 
 	bool get_registered_events(sensor_id_t sensor_id, event_type_vector &event_vec);
+	void get_sensor_ids(vector<sensor_id_t> &sensor_ids);
 
 	bool add_sensor_usage(sensor_id_t sensor_id);
 	bool remove_sensor_usage(sensor_id_t sensor_id);
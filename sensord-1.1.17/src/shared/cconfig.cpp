@@ -22,6 +22,10 @@
 
 using std::ifstream;
 
+#if !defined(INFO_INI_PATH)
+#define INFO_INI_PATH "/etc/info.ini"
+#endif
+
 cconfig::cconfig(void)
 {
 
@@ -34,7 +38,6 @@ cconfig::~cconfig(void)
 
 bool cconfig::get_device_id(void)
 {
-	const string INFO_INI_PATH = "/etc/info.ini";
 	const string START_DELIMETER = "Model=";
 	const string END_DELIMETER = ";";
 	string line;
@@ -169,3 +169,45 @@ void copy_sensorhub_data(sensorhub_data_t *dest, sensorhub_data_t *src)
 	memcpy(dest->hub_data, src->hub_data, src->hub_data_size);
 	memcpy(dest->data, src->data, sizeof(src->data));
 }
+
+static int get_valid_hub_data_size(int hub_data_size)
+{
+	if (hub_data_size < 0)
+		return 0;
+
+	if (hub_data_size > SENSOR_HUB_DATA_SIZE)
+		return SENSOR_HUB_DATA_SIZE;
+
+	return hub_data_size;
+}
+
+size_t get_compact_sensorhub_event_size(int hub_data_size)
+{
+	return offsetof(compact_sensorhub_event_t, hub_data) + get_valid_hub_data_size(hub_data_size);
+}
+
+void compact_sensorhub_event(compact_sensorhub_event_t *dest, sensorhub_event_t *src)
+{
+	dest->event_type = src->event_type;
+	dest->sensor_id = src->sensor_id;
+	dest->version = src->data.version;
+	dest->sensorhub = src->data.sensorhub;
+	dest->type = src->data.type;
+	dest->hub_data_size = get_valid_hub_data_size(src->data.hub_data_size);
+	dest->timestamp = src->data.timestamp;
+	memcpy(dest->data, src->data.data, sizeof(dest->data));
+	memcpy(dest->hub_data, src->data.hub_data, dest->hub_data_size);
+}
+
+void expand_sensorhub_event(sensorhub_event_t *dest, compact_sensorhub_event_t *src)
+{
+	dest->event_type = src->event_type;
+	dest->sensor_id = src->sensor_id;
+	dest->data.version = src->version;
+	dest->data.sensorhub = src->sensorhub;
+	dest->data.type = src->type;
+	dest->data.hub_data_size = get_valid_hub_data_size(src->hub_data_size);
+	dest->data.timestamp = src->timestamp;
+	memcpy(dest->data.data, src->data, sizeof(src->data));
+	memcpy(dest->data.hub_data, src->hub_data, dest->data.hub_data_size);
+}
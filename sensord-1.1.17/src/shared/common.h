@@ -215,14 +215,21 @@ void sf_log(int type , int priority , const char *tag , const char *fmt , ...);
 
 struct sensor_data_t;
 struct sensorhub_data_t;
+struct sensorhub_event_t;
+struct compact_sensorhub_event_t;
 typedef struct sensor_data_t sensor_data_t;
 typedef struct sensorhub_data_t sensorhub_data_t;
+typedef struct sensorhub_event_t sensorhub_event_t;
+typedef struct compact_sensorhub_event_t compact_sensorhub_event_t;
 
 const char* get_client_name(void);
 bool get_proc_name(pid_t pid, char *process_name);
 bool is_sensorhub_event(unsigned int event_type);
 void copy_sensor_data(sensor_data_t *dest, sensor_data_t *src);
 void copy_sensorhub_data(sensorhub_data_t *dest, sensorhub_data_t *src);
+size_t get_compact_sensorhub_event_size(int hub_data_size);
+void compact_sensorhub_event(compact_sensorhub_event_t *dest, sensorhub_event_t *src);
+void expand_sensorhub_event(sensorhub_event_t *dest, compact_sensorhub_event_t *src);
 
 #ifdef __cplusplus
 }
@@ -26,19 +26,22 @@
 #include <sf_common.h>
 
 cpacket::cpacket()
+: m_packet(NULL)
+, m_capacity(sizeof(m_inline.buffer))
 {
-	m_packet = NULL;
 }
 
 cpacket::cpacket(size_t size)
+: m_packet(NULL)
+, m_capacity(sizeof(m_inline.buffer))
 {
-	m_packet = NULL;
 	set_payload_size(size);
 }
 
 cpacket::~cpacket()
 {
-	delete[] (char*)m_packet;
+	if ((char *)m_packet != m_inline.buffer)
+		delete[] (char*)m_packet;
 }
 
 void cpacket::set_cmd(int cmd)
@@ -46,7 +49,7 @@ void cpacket::set_cmd(int cmd)
 	if (!m_packet)
 		set_payload_size(0);
 
-	m_packet->cmd = cmd;
+	m_packet->cmd = (m_packet->cmd & ~PACKET_CMD_MASK) | (cmd & PACKET_CMD_MASK);
 }
 
 int cpacket::cmd(void)
@@ -54,7 +57,28 @@ int cpacket::cmd(void)
 	if (!m_packet)
 		return CMD_NONE;
 
-	return m_packet->cmd;
+	return packet_cmd(m_packet);
+}
+
+bool cpacket::set_sensor(unsigned int sensor)
+{
+	retvm_if (sensor >> (32 - PACKET_SENSOR_SHIFT), false,
+		"Sensor id 0x%x doesn't fit in a packet header", sensor);
+
+	if (!m_packet)
+		set_payload_size(0);
+
+	m_packet->cmd = (int)(sensor << PACKET_SENSOR_SHIFT) | packet_cmd(m_packet);
+
+	return true;
+}
+
+unsigned int cpacket::sensor(void)
+{
+	if (!m_packet)
+		return UNKNOWN_SENSOR;
+
+	return packet_sensor(m_packet);
 }
 
 void *cpacket::data(void)
@@ -86,19 +110,29 @@ size_t cpacket::payload_size(void)
 	return m_packet->size;
 }
 
-void cpacket::set_payload_size(size_t size)
+bool cpacket::set_payload_size(size_t size)
 {
 	int prev_cmd = CMD_NONE;
+	char *storage;
 
-	if (m_packet) {
+	if (m_packet)
 		prev_cmd = m_packet->cmd;
-		delete []m_packet;
+
+	if (size + sizeof(packet_header) <= m_capacity) {
+		storage = m_packet ? (char *)m_packet : m_inline.buffer;
+	} else {
+		storage = new(std::nothrow) char[size + sizeof(packet_header)];
+		retvm_if (!storage, false, "Failed to allocate memory");
+
+		if ((char *)m_packet != m_inline.buffer)
+			delete[] (char *)m_packet;
+
+		m_capacity = size + sizeof(packet_header);
 	}
 
-	m_packet = (packet_header*) new(std::nothrow) char[size + sizeof(packet_header)];
-	retm_if (!m_packet, "Failed to allocate memory");
+	m_packet = (packet_header*) storage;
 	m_packet->size = size;
+	m_packet->cmd = prev_cmd;
 
-	if (prev_cmd != CMD_NONE)
-		m_packet->cmd = prev_cmd;
+	return true;
 }
@@ -20,12 +20,46 @@
 #if !defined(_CPACKET_CLASS_H_)
 #define _CPACKET_CLASS_H_
 
+#include <stddef.h>
+
 typedef struct packet_header {
 	int cmd;
 	size_t size;
 	char data[];
 } packet_header;
 
+#if defined(__GXX_EXPERIMENTAL_CXX0X__) || __cplusplus >= 201103L
+static_assert(sizeof(packet_header) == 2 * sizeof(size_t),
+	"packet_header is shared with clients built against older headers");
+#endif
+
+/*
+ * The low bits of cmd hold the command. On a multiplexed command channel
+ * the bits above them hold the id of the sensor the command targets; a
+ * legacy per-sensor channel leaves them 0 (UNKNOWN_SENSOR), and the server
+ * uses the sensor given to CMD_HELLO. That leaves room for sensor ids
+ * below 1 << (32 - PACKET_SENSOR_SHIFT), i.e. up to 256 sensors of a type
+ */
+#define PACKET_SENSOR_SHIFT	8
+#define PACKET_CMD_MASK		((1 << PACKET_SENSOR_SHIFT) - 1)
+
+static inline int packet_cmd(const packet_header *header)
+{
+	return header->cmd & PACKET_CMD_MASK;
+}
+
+static inline unsigned int packet_sensor(const packet_header *header)
+{
+	return (unsigned int)header->cmd >> PACKET_SENSOR_SHIFT;
+}
+
+/*
+ * A packet whose payload fits in INLINE_PAYLOAD_SIZE is built in place
+ * inside the object, so every fixed-size command and reply can live on the
+ * stack. Larger ones go to the heap, and the storage is kept when the
+ * payload is resized, so a long-lived cpacket reused as a buffer stops
+ * allocating once it has seen its largest packet
+ */
 class cpacket
 {
 public:
@@ -36,15 +70,28 @@ public:
 	void set_cmd(int cmd);
 	int cmd(void);
 
+	bool set_sensor(unsigned int sensor);
+	unsigned int sensor(void);
+
 	void *data(void);
 	void *packet(void);
 
 	size_t size(void);
 	size_t payload_size(void);
 
-	void set_payload_size(size_t size);
+	bool set_payload_size(size_t size);
 private:
+	static const size_t INLINE_PAYLOAD_SIZE = 128;
+
 	packet_header *m_packet;
+	size_t m_capacity;
+	union {
+		unsigned long long align;
+		char buffer[sizeof(packet_header) + INLINE_PAYLOAD_SIZE];
+	} m_inline;
+
+	cpacket(const cpacket &);
+	cpacket& operator=(const cpacket &);
 };
 
 #endif
@@ -0,0 +1,283 @@
+/*
+ * libsensord-share
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <common.h>
+#include <creactor.h>
+#include <sys/epoll.h>
+#include <errno.h>
+#include <new>
+#include <unistd.h>
+#include <thread>
+
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+
+// What the handler or job running on this thread asked for through defer()
+// or suspend(), acted on by finish() only after it has returned
+static __thread void *running_source;
+static __thread creactor::reactor_func_t deferred_job;
+static __thread bool suspended;
+
+creactor::creactor()
+: m_epoll_fd(-1)
+, m_worker_cnt(0)
+, m_job_head(NULL)
+, m_job_tail(NULL)
+{
+}
+
+creactor::~creactor()
+{
+	if (m_epoll_fd >= 0)
+		close(m_epoll_fd);
+}
+
+bool creactor::start(int thread_cnt, int worker_cnt)
+{
+	if (m_epoll_fd < 0) {
+		m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		retvm_if(m_epoll_fd < 0, false, "epoll_create1 failed, errno : %d , errstr : %s", errno, strerror(errno));
+	}
+
+	for (int i = 0; i < thread_cnt; ++i) {
+		thread reactor_thread(&creactor::main, this);
+		reactor_thread.detach();
+	}
+
+	for (int i = 0; i < worker_cnt; ++i) {
+		thread worker(&creactor::worker_main, this);
+		worker.detach();
+	}
+
+	m_worker_cnt += worker_cnt;
+
+	INFO("Reactor is started with %d thread(s), %d worker(s)", thread_cnt, worker_cnt);
+	return true;
+}
+
+bool creactor::add(int fd, reactor_func_t readable, reactor_func_t removed, void *ctx)
+{
+	reactor_source_t *source;
+
+	retvm_if(m_epoll_fd < 0, false, "Reactor is not started");
+
+	source = new(std::nothrow) reactor_source_t;
+	retvm_if(!source, false, "Failed to allocate memory");
+
+	source->fd = fd;
+	source->readable = readable;
+	source->removed = removed;
+	source->ctx = ctx;
+	source->job = NULL;
+	source->next = NULL;
+	source->suspended = false;
+	source->resumed = false;
+
+	if (!arm(source, EPOLL_CTL_ADD)) {
+		delete source;
+		return false;
+	}
+
+	return true;
+}
+
+bool creactor::arm(reactor_source_t *source, int op)
+{
+	struct epoll_event event;
+
+	event.events = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+	event.data.ptr = source;
+
+	if (epoll_ctl(m_epoll_fd, op, source->fd, &event) < 0) {
+		ERR("epoll_ctl(%d) failed for fd[%d], errno : %d , errstr : %s", op, source->fd, errno, strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Only meaningful inside a readable handler. Returns false when there are
+ * no workers, in which case the handler has to do the work itself.
+ */
+bool creactor::defer(reactor_func_t job)
+{
+	if (!m_worker_cnt)
+		return false;
+
+	deferred_job = job;
+	return true;
+}
+
+/*
+ * Only meaningful inside a handler or job, which must then return true.
+ * Returns NULL when there are no workers to resume on.
+ */
+void *creactor::suspend(void)
+{
+	if (!m_worker_cnt)
+		return NULL;
+
+	suspended = true;
+	return running_source;
+}
+
+/*
+ * May run before the suspending handler has returned; the job is then
+ * queued by finish() instead
+ */
+void creactor::resume(void *handle, reactor_func_t job)
+{
+	reactor_source_t *source = (reactor_source_t *)handle;
+	lock_guard<mutex> lock(m_job_mutex);
+
+	source->job = job;
+
+	if (source->suspended) {
+		source->suspended = false;
+		queue_job(source);
+	} else {
+		source->resumed = true;
+	}
+}
+
+void creactor::push_job(reactor_source_t *source, reactor_func_t job)
+{
+	lock_guard<mutex> lock(m_job_mutex);
+
+	source->job = job;
+	queue_job(source);
+}
+
+// Called with m_job_mutex held
+void creactor::queue_job(reactor_source_t *source)
+{
+	source->next = NULL;
+
+	if (m_job_tail)
+		m_job_tail->next = source;
+	else
+		m_job_head = source;
+
+	m_job_tail = source;
+	m_job_cond.notify_one();
+}
+
+/*
+ * Acts on what the handler or job that just ran on this thread returned
+ * and asked for
+ */
+void creactor::finish(reactor_source_t *source, bool keep)
+{
+	if (!keep) {
+		remove(source);
+	} else if (deferred_job) {
+		push_job(source, deferred_job);
+	} else if (suspended) {
+		lock_guard<mutex> lock(m_job_mutex);
+
+		if (source->resumed) {
+			source->resumed = false;
+			queue_job(source);
+		} else {
+			source->suspended = true;
+		}
+	} else if (!arm(source, EPOLL_CTL_MOD)) {
+		remove(source);
+	}
+}
+
+/*
+ * The fd leaves the epoll set before removed() may close it, so a number
+ * reused by a concurrent accept() never gets unregistered by mistake.
+ */
+void creactor::remove(reactor_source_t *source)
+{
+	epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+
+	if (source->removed)
+		source->removed(source->ctx);
+
+	delete source;
+}
+
+/*
+ * Each thread takes one ready fd per wait, so a slow command on one client
+ * leaves the rest of the set to the other threads.
+ */
+void creactor::main(void)
+{
+	struct epoll_event event;
+	reactor_source_t *source;
+	int ret;
+
+	while (true) {
+		ret = epoll_wait(m_epoll_fd, &event, 1, -1);
+
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+
+			ERR("epoll_wait failed, errno : %d , errstr : %s", errno, strerror(errno));
+			break;
+		}
+
+		if (ret == 0)
+			continue;
+
+		source = (reactor_source_t *)event.data.ptr;
+		running_source = source;
+		deferred_job = NULL;
+		suspended = false;
+
+		finish(source, source->readable(source->ctx));
+	}
+}
+
+/*
+ * A queued source is disarmed, so its job is the only thing touching it
+ * until finish() re-arms or removes it, just as after a handler.
+ */
+void creactor::worker_main(void)
+{
+	reactor_source_t *source;
+
+	while (true) {
+		{
+			unique_lock<mutex> lock(m_job_mutex);
+
+			while (!m_job_head)
+				m_job_cond.wait(lock);
+
+			source = m_job_head;
+			m_job_head = source->next;
+
+			if (!m_job_head)
+				m_job_tail = NULL;
+		}
+
+		running_source = source;
+		deferred_job = NULL;
+		suspended = false;
+
+		finish(source, source->job(source->ctx));
+	}
+}
@@ -0,0 +1,87 @@
+/*
+ * libsensord-share
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _CREACTOR_H_
+#define _CREACTOR_H_
+
+#include <mutex>
+#include <condition_variable>
+
+/*
+ * Serves many mostly idle file descriptors from a small, fixed set of
+ * threads. Every fd is registered edge-triggered and one-shot, so only one
+ * thread runs its handler at a time and the handler can keep per-fd state
+ * without locking. A handler must consume everything readable before it
+ * returns true to be re-armed; returning false unregisters the fd and then
+ * calls its removed function, which owns closing it.
+ *
+ * A handler that would block, e.g. on a sensor HAL, hands the rest of its
+ * work to defer() and returns true. The fd then stays disarmed until that
+ * job has run on one of the worker threads, so the reactor threads keep
+ * serving other fds and the fd's own commands stay in order.
+ *
+ * A handler or job that has to wait for something else, e.g. the next
+ * event of a sensor, calls suspend() and returns true instead. The fd stays
+ * disarmed until resume() is called with the returned handle, from any
+ * thread, which queues a job to finish the work on a worker.
+ */
+class creactor
+{
+public:
+	typedef bool(*reactor_func_t)(void *ctx);
+
+	creactor();
+	virtual ~creactor();
+
+	bool start(int thread_cnt, int worker_cnt = 0);
+	bool add(int fd, reactor_func_t readable, reactor_func_t removed, void *ctx);
+	bool defer(reactor_func_t job);
+	void *suspend(void);
+	void resume(void *handle, reactor_func_t job);
+
+private:
+	typedef struct reactor_source {
+		int fd;
+		reactor_func_t readable;
+		reactor_func_t removed;
+		void *ctx;
+		reactor_func_t job;
+		struct reactor_source *next;
+		bool suspended;
+		bool resumed;
+	} reactor_source_t;
+
+	int m_epoll_fd;
+	int m_worker_cnt;
+
+	std::mutex m_job_mutex;
+	std::condition_variable m_job_cond;
+	reactor_source_t *m_job_head;
+	reactor_source_t *m_job_tail;
+
+	bool arm(reactor_source_t *source, int op);
+	void remove(reactor_source_t *source);
+	void push_job(reactor_source_t *source, reactor_func_t job);
+	void queue_job(reactor_source_t *source);
+	void finish(reactor_source_t *source, bool keep);
+	void main(void);
+	void worker_main(void);
+};
+
+#endif /* _CREACTOR_H_ */
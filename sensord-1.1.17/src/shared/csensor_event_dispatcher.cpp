@@ -23,16 +23,56 @@
 #include <sf_common.h>
 #include <vconf.h>
 #include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
 using std::thread;
+using std::lock_guard;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::atomic_thread_fence;
 
 #define MAX_PENDING_CONNECTION 32
 
 csensor_event_dispatcher::csensor_event_dispatcher()
+: m_reactor(NULL)
+, m_request_timer_fd(-1)
+, m_request_timer_deadline(0)
+, m_virtual_sensor_routes(new virtual_sensor_routes_t())
+, m_routes_gen(0)
+, m_routes_reader_gen(0)
 {
 	m_sensor_fusion = sensor_plugin_loader::get_instance().get_fusion();
 }
 
-csensor_event_dispatcher::~csensor_event_dispatcher() { }
+csensor_event_dispatcher::~csensor_event_dispatcher()
+{
+	reclaim_virtual_sensor_routes(true);
+	delete m_virtual_sensor_routes.load();
+
+	auto it_slot = m_last_events.begin();
+
+	while (it_slot != m_last_events.end()) {
+		delete it_slot->second;
+		++it_slot;
+	}
+
+	if (m_request_timer_fd >= 0)
+		close(m_request_timer_fd);
+}
+
+static unsigned long long get_timestamp(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return ((unsigned long long)(t.tv_sec)*1000000000LL + t.tv_nsec) / 1000;
+}
+
+static unsigned long long get_last_event_key(sensor_id_t sensor_id, unsigned int event_type)
+{
+	return ((unsigned long long) sensor_id << 32) | event_type;
+}
 
 
 csensor_event_dispatcher& csensor_event_dispatcher::get_instance()
@@ -42,7 +82,7 @@ csensor_event_dispatcher& csensor_event_dispatcher::get_instance()
 }
 
 
-bool csensor_event_dispatcher::run(void)
+bool csensor_event_dispatcher::run(creactor &reactor)
 {
 	INFO("Starting Event Dispatcher\n");
 
@@ -62,8 +102,25 @@ bool csensor_event_dispatcher::run(void)
 		return false;
 	}
 
-	thread accepter(&csensor_event_dispatcher::accept_connections, this);
-	accepter.detach();
+	make_last_event_slots();
+
+	m_reactor = &reactor;
+	m_accept_socket.set_blocking_mode(false);
+
+	if (!m_reactor->add(m_accept_socket.get_socket_fd(), accept_connections, NULL, this)) {
+		ERR("Failed to watch event channel listener\n");
+		return false;
+	}
+
+	m_request_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+	if (m_request_timer_fd < 0) {
+		ERR("timerfd_create failed, errno : %d , errstr : %s", errno, strerror(errno));
+	} else if (!m_reactor->add(m_request_timer_fd, expire_requests, NULL, this)) {
+		ERR("Failed to watch the last event request timer");
+		close(m_request_timer_fd);
+		m_request_timer_fd = -1;
+	}
 
 	thread dispatcher(&csensor_event_dispatcher::dispatch_event, this);
 	dispatcher.detach();
@@ -71,17 +128,28 @@ bool csensor_event_dispatcher::run(void)
 	return true;
 }
 
-void csensor_event_dispatcher::accept_event_channel(csocket client_socket)
+/*
+ * Completes the handshake once the client id arrives, on a reactor thread
+ * instead of one spawned per connection. Returning false always ends the
+ * reactor's watch; the socket then belongs to the client record, or is
+ * closed by close_event_channel_handshake() if the handshake failed.
+ */
+bool csensor_event_dispatcher::accept_event_channel(event_channel_handshake_t &handshake)
 {
+	csocket &client_socket = handshake.socket;
 	int client_id;
+	ssize_t len;
 	event_channel_ready_t event_channel_ready;
 	cclient_info_manager& client_info_manager = get_client_info_manager();
 
-	client_socket.set_connection_mode();
+	len = client_socket.recv_available(&client_id, sizeof(client_id));
 
-	if (client_socket.recv(&client_id, sizeof(client_id)) <= 0) {
+	if (len == -EAGAIN)
+		return true;
+
+	if (len != sizeof(client_id)) {
 		ERR("Failed to receive client id on socket fd[%d]", client_socket.get_socket_fd());
-		return;
+		return false;
 	}
 
 	client_socket.set_transfer_mode();
@@ -91,9 +159,11 @@ void csensor_event_dispatcher::accept_event_channel(csocket client_socket)
 	if(!get_client_info_manager().set_event_socket(client_id, client_socket)) {
 		ERR("Failed to store event socket[%d] for %s", client_socket.get_socket_fd(),
 			client_info_manager.get_client_info(client_id));
-		return;
+		return false;
 	}
 
+	handshake.accepted = true;
+
 	event_channel_ready.magic = EVENT_CHANNEL_MAGIC;
 	event_channel_ready.client_id = client_id;
 
@@ -103,26 +173,56 @@ void csensor_event_dispatcher::accept_event_channel(csocket client_socket)
 	if (client_socket.send(&event_channel_ready, sizeof(event_channel_ready)) <= 0) {
 		ERR("Failed to send event_channel_ready packet to %s on socket fd[%d]",
 			client_info_manager.get_client_info(client_id), client_socket.get_socket_fd());
-		return;
 	}
+
+	return false;
+}
+
+bool csensor_event_dispatcher::event_channel_readable(void *ctx)
+{
+	return get_instance().accept_event_channel(*(event_channel_handshake_t *)ctx);
+}
+
+bool csensor_event_dispatcher::close_event_channel_handshake(void *ctx)
+{
+	event_channel_handshake_t *handshake = (event_channel_handshake_t *)ctx;
+
+	if (!handshake->accepted)
+		handshake->socket.close();
+
+	delete handshake;
+	return true;
 }
 
-void csensor_event_dispatcher::accept_connections(void)
+bool csensor_event_dispatcher::accept_connections(void *ctx)
 {
-	INFO("Event channel acceptor is started.\n");
+	csensor_event_dispatcher *inst = (csensor_event_dispatcher *)ctx;
+	event_channel_handshake_t *handshake;
 
 	while (true) {
 		csocket client_socket;
 
-		if (!m_accept_socket.accept(client_socket)) {
-			ERR("Accepting socket failed in Server \n");
+		if (!inst->m_accept_socket.accept(client_socket))
+			return true;
+
+		INFO("New client connected (socket_fd : %d)\n", client_socket.get_socket_fd());
+
+		handshake = new(std::nothrow) event_channel_handshake_t;
+
+		if (!handshake) {
+			ERR("Failed to allocate memory");
+			client_socket.close();
 			continue;
 		}
 
-		INFO("New client connected (socket_fd : %d)\n", client_socket.get_socket_fd());
+		handshake->socket = client_socket;
+		handshake->accepted = false;
 
-		thread event_channel_creator(&csensor_event_dispatcher::accept_event_channel, this, client_socket);
-		event_channel_creator.detach();
+		if (!inst->m_reactor->add(client_socket.get_socket_fd(), event_channel_readable,
+				close_event_channel_handshake, handshake)) {
+			client_socket.close();
+			delete handshake;
+		}
 	}
 }
 
@@ -132,8 +232,10 @@ void csensor_event_dispatcher::dispatch_event(void)
 	const int MAX_SENSOR_EVENT = 1 + (sensor_plugin_loader::get_instance().get_virtual_sensors().size()
 		* MAX_EVENT_PER_SENSOR);
 	const int MAX_SYNTH_PER_SENSOR = 5;
+	const unsigned long long POOL_STATS_INTERVAL = 60 * 1000000ULL;
 
 	vector<sensor_event_t> v_sensor_events(MAX_SYNTH_PER_SENSOR);
+	unsigned long long pool_stats_time = get_timestamp();
 
 	INFO("Event Dispatcher started");
 
@@ -147,105 +249,159 @@ void csensor_event_dispatcher::dispatch_event(void)
 			is_hub_event = true;
 
 		if (is_hub_event) {
-			sensorhub_event_t *sensorhub_event = (sensorhub_event_t *)seed_event;
+			compact_sensorhub_event_t *sensorhub_event = (compact_sensorhub_event_t *)seed_event;
 			send_sensor_events(sensorhub_event, 1, true);
 		} else {
 			sensor_event_t sensor_events[MAX_SENSOR_EVENT];
-			unsigned int event_cnt = 0;
-			sensor_events[event_cnt++] = *((sensor_event_t *)seed_event);
+			unsigned int event_cnt;
 
-			if (m_sensor_fusion) {
-				if (m_sensor_fusion->is_started())
-					m_sensor_fusion->fuse(*((sensor_event_t *)seed_event));
-			}
+			event_cnt = process_event(*((sensor_event_t *)seed_event), sensor_events, MAX_SENSOR_EVENT, v_sensor_events);
 
-			virtual_sensors v_sensors = get_active_virtual_sensors();
+			for (int i = 0; i < event_cnt; ++i)
+				put_last_event(sensor_events[i]);
 
-			auto it_v_sensor = v_sensors.begin();
+			send_sensor_events(sensor_events, event_cnt, false);
+		}
 
-			while (it_v_sensor != v_sensors.end()) {
-				int synthesized_cnt;
-				v_sensor_events.clear();
-				(*it_v_sensor)->synthesize(*((sensor_event_t *)seed_event), v_sensor_events);
-				synthesized_cnt = v_sensor_events.size();
+		get_event_queue().release(seed_event);
 
-				for (int i = 0; i < synthesized_cnt; ++i)
-					sensor_events[event_cnt++] = v_sensor_events[i];
+		if (get_timestamp() - pool_stats_time >= POOL_STATS_INTERVAL) {
+			get_event_queue().print_pool_stats();
+			pool_stats_time = get_timestamp();
+		}
+	}
+}
 
-				++it_v_sensor;
-			}
+/*
+ * Runs one seed event through the fusion sensor and the active virtual
+ * sensors and fills events with the seed and everything derived from it,
+ * in timestamp order. Returns the number of events. Nothing is recorded or
+ * sent, so a recorded trace can be replayed through the same path.
+ */
+unsigned int csensor_event_dispatcher::process_event(const sensor_event_t &seed, sensor_event_t *events,
+	unsigned int max_event_cnt, vector<sensor_event_t> &outs)
+{
+	unsigned int event_cnt = 0;
 
-			if (m_sensor_fusion)
-				m_sensor_fusion->clear_data();
+	events[event_cnt++] = seed;
 
-			sort_sensor_events(sensor_events, event_cnt);
+	if (m_sensor_fusion) {
+		if (m_sensor_fusion->is_started()) {
+			m_sensor_fusion->fuse(seed);
 
-			for (int i = 0; i < event_cnt; ++i) {
-				if (is_record_event(sensor_events[i].event_type))
-					put_last_event(sensor_events[i].event_type, sensor_events[i]);
-			}
+			if (m_sensor_fusion->is_data_ready()) {
+				sensor_event_t &fusion_event = events[event_cnt++];
 
-			send_sensor_events(sensor_events, event_cnt, false);
+				fusion_event.sensor_id = m_sensor_fusion->get_id();
+				fusion_event.event_type = FUSION_EVENT_AGM;
+				fusion_event.data.accuracy = SENSOR_ACCURACY_GOOD;
+				fusion_event.data.timestamp = m_sensor_fusion->get_data_timestamp();
+				fusion_event.data.value_count = 0;
+			}
 		}
-
-		if (is_hub_event)
-			delete (sensorhub_event_t *)seed_event;
-		else
-			delete (sensor_event_t *)seed_event;
 	}
+
+	synthesize_events(get_virtual_sensor_routes(), events, event_cnt, max_event_cnt, outs);
+
+	if (m_sensor_fusion)
+		m_sensor_fusion->clear_data();
+
+	sort_sensor_events(events, event_cnt);
+
+	return event_cnt;
 }
 
+/*
+ * Synthesized events are appended behind the seed and routed in turn, so a
+ * chain such as orientation -> gravity -> linear_accel completes within one
+ * dispatch cycle instead of going back through the event queue.
+ */
+void csensor_event_dispatcher::synthesize_events(const virtual_sensor_routes_t *routes,
+	sensor_event_t *events, unsigned int &event_cnt, unsigned int max_event_cnt, vector<sensor_event_t> &outs)
+{
+	unsigned int route_pos = 0;
+
+	while (route_pos < event_cnt) {
+		const sensor_event_t &event = events[route_pos++];
+		const virtual_sensor_vec *route_consumers[2] = {NULL, &routes->any_event_consumers};
+
+		auto it_route = routes->consumers.find(event.event_type);
+
+		if (it_route != routes->consumers.end())
+			route_consumers[0] = &(it_route->second);
+
+		for (int route = 0; route < 2; ++route) {
+			if (!route_consumers[route])
+				continue;
+
+			auto it_v_sensor = route_consumers[route]->begin();
+
+			while (it_v_sensor != route_consumers[route]->end()) {
+				outs.clear();
+				(*it_v_sensor)->synthesize(event, outs);
+
+				auto it_out = outs.begin();
+
+				while (it_out != outs.end()) {
+					if (event_cnt >= max_event_cnt) {
+						ERR("Too many synthesized events, event[0x%x] from %s is dropped",
+							it_out->event_type, (*it_v_sensor)->get_name());
+						break;
+					}
+
+					events[event_cnt++] = *it_out;
+					++it_out;
+				}
+
+				++it_v_sensor;
+			}
+		}
+	}
+}
 
 void csensor_event_dispatcher::send_sensor_events(void* events, int event_cnt, bool is_hub_event)
 {
-	sensor_event_t *sensor_events;
-	sensorhub_event_t *sensor_hub_events;
+	char *event_pos = (char *)events;
 	cclient_info_manager& client_info_manager = get_client_info_manager();
-
-	const int RESERVED_CLIENT_CNT = 20;
-	static client_id_vec id_vec(RESERVED_CLIENT_CNT);
-
-	if (is_hub_event)
-		sensor_hub_events = (sensorhub_event_t *)events;
-	else
-		sensor_events = (sensor_event_t *)events;
+	const event_listener_index *listener_index = client_info_manager.get_listener_index();
 
 	for (int i = 0; i < event_cnt; ++i) {
 		sensor_id_t sensor_id;
 		unsigned int event_type;
+		size_t event_size;
 
 		if (is_hub_event) {
-			sensor_id = sensor_hub_events[i].sensor_id;
-			event_type = sensor_hub_events[i].event_type;
+			compact_sensorhub_event_t *sensor_hub_event = (compact_sensorhub_event_t *)event_pos;
+			sensor_id = sensor_hub_event->sensor_id;
+			event_type = sensor_hub_event->event_type;
+			event_size = get_compact_sensorhub_event_size(sensor_hub_event->hub_data_size);
 		} else {
-			sensor_id = sensor_events[i].sensor_id;
-			event_type = sensor_events[i].event_type;
+			sensor_event_t *sensor_event = (sensor_event_t *)event_pos;
+			sensor_id = sensor_event->sensor_id;
+			event_type = sensor_event->event_type;
+			event_size = sizeof(sensor_event_t);
 		}
 
-		id_vec.clear();
-		client_info_manager.get_listener_ids(sensor_id, event_type, id_vec);
-
-		auto it_client_id = id_vec.begin();
-
-		while (it_client_id != id_vec.end()) {
-			csocket client_socket;
+		const event_listener_vec *listeners = cclient_info_manager::find_listeners(listener_index, sensor_id, event_type);
 
-			client_info_manager.get_event_socket(*it_client_id, client_socket);
+		if (listeners) {
+			auto it_listener = listeners->begin();
 
-			bool ret;
+			while (it_listener != listeners->end()) {
+				const csocket &client_socket = it_listener->event_socket;
 
-			if (is_hub_event)
-				ret = (client_socket.send(sensor_hub_events + i, sizeof(sensorhub_event_t)) > 0);
-			else
-				ret = (client_socket.send(sensor_events + i, sizeof(sensor_event_t)) > 0);
+				bool ret = (client_socket.send(event_pos, event_size) > 0);
 
-			if (ret)
-				DBG("Event[0x%x] sent to %s on socket[%d]", event_type, client_info_manager.get_client_info(*it_client_id), client_socket.get_socket_fd());
-			else
-				ERR("Failed to send event[0x%x] to %s on socket[%d]", event_type, client_info_manager.get_client_info(*it_client_id), client_socket.get_socket_fd());
+				if (ret)
+					DBG("Event[0x%x] sent to %s on socket[%d]", event_type, client_info_manager.get_client_info(it_listener->client_id), client_socket.get_socket_fd());
+				else
+					ERR("Failed to send event[0x%x] to %s on socket[%d]", event_type, client_info_manager.get_client_info(it_listener->client_id), client_socket.get_socket_fd());
 
-			++it_client_id;
+				++it_listener;
+			}
 		}
+
+		event_pos += event_size;
 	}
 
 }
@@ -260,27 +416,267 @@ csensor_event_queue& csensor_event_dispatcher::get_event_queue(void)
 	return csensor_event_queue::get_instance();
 }
 
-bool csensor_event_dispatcher::is_record_event(unsigned int event_type)
+/*
+ * The slot table is filled before the dispatcher thread starts and never
+ * changes afterwards, so it is looked up without a lock. Only the event
+ * types a sensor registered as supported are recorded.
+ */
+void csensor_event_dispatcher::make_last_event_slots(void)
 {
-	return false;
+	vector<sensor_base *> sensors;
+
+	sensors = sensor_plugin_loader::get_instance().get_sensors(ALL_SENSOR);
+
+	auto it_sensor = sensors.begin();
+
+	while (it_sensor != sensors.end()) {
+		sensor_info info;
+		vector<unsigned int> events;
+
+		(*it_sensor)->get_sensor_info(info);
+		info.get_supported_events(events);
+
+		auto it_event = events.begin();
+
+		while (it_event != events.end()) {
+			unsigned long long key = get_last_event_key((*it_sensor)->get_id(), *it_event);
+
+			if (m_last_events.find(key) == m_last_events.end()) {
+				last_event_slot_t *slot = new last_event_slot_t();
+
+				slot->seq.store(0);
+				slot->recorded_time = 0;
+				slot->request_cnt.store(0);
+				slot->requests = NULL;
+				slot->on_change = (*it_sensor)->is_on_change_event(*it_event);
+				m_last_events[key] = slot;
+			}
+
+			++it_event;
+		}
+
+		++it_sensor;
+	}
+
+	INFO("Recording the last event of %zu event types", m_last_events.size());
+}
+
+last_event_slot_t* csensor_event_dispatcher::get_last_event_slot(sensor_id_t sensor_id, unsigned int event_type)
+{
+	auto it_slot = m_last_events.find(get_last_event_key(sensor_id, event_type));
+
+	if (it_slot == m_last_events.end())
+		return NULL;
+
+	return it_slot->second;
+}
+
+/*
+ * Called only from the dispatcher thread, which also answers the requests
+ * pending on the slot with the event
+ */
+void csensor_event_dispatcher::put_last_event(const sensor_event_t &event)
+{
+	last_event_slot_t *slot = get_last_event_slot(event.sensor_id, event.event_type);
+
+	if (!slot)
+		return;
+
+	unsigned int seq = slot->seq.load(memory_order_relaxed);
+
+	slot->seq.store(seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	slot->event = event;
+	slot->recorded_time = get_timestamp();
+
+	slot->seq.store(seq + 2);
+
+	if (!slot->request_cnt.load())
+		return;
+
+	last_event_request_t *request;
+	last_event_request_t *next;
+
+	{
+		lock_guard<mutex> lock(slot->request_mutex);
+		request = slot->requests;
+		slot->requests = NULL;
+		slot->request_cnt.store(0);
+	}
+
+	while (request) {
+		next = request->next;
+		request->answer(request->ctx, &event);
+		request = next;
+	}
 }
 
-void csensor_event_dispatcher::put_last_event(unsigned int event_type, const sensor_event_t &event)
+bool csensor_event_dispatcher::read_last_event(last_event_slot_t *slot, sensor_event_t &event,
+	unsigned long long &recorded_time)
 {
-	AUTOLOCK(m_last_events_mutex);
-	m_last_events[event_type] = event;
+	unsigned int seq_begin;
+	unsigned int seq_end;
+
+	do {
+		seq_begin = slot->seq.load(memory_order_acquire);
+		event = slot->event;
+		recorded_time = slot->recorded_time;
+		atomic_thread_fence(memory_order_acquire);
+		seq_end = slot->seq.load(memory_order_relaxed);
+	} while ((seq_begin & 1) || (seq_begin != seq_end));
+
+	return (seq_begin != 0);
 }
 
-bool csensor_event_dispatcher::get_last_event(unsigned int event_type, sensor_event_t &event)
+bool csensor_event_dispatcher::is_record_event(sensor_id_t sensor_id, unsigned int event_type)
 {
-	AUTOLOCK(m_last_events_mutex);
+	return (get_last_event_slot(sensor_id, event_type) != NULL);
+}
 
-	auto it_event = m_last_events.find(event_type);
+/*
+ * Copies the last recorded event without blocking. With a non-zero
+ * max_age (usec), an event recorded longer ago than that is treated as
+ * missing, e.g. once nobody keeps the sensor streaming it.
+ */
+bool csensor_event_dispatcher::get_last_event(sensor_id_t sensor_id, unsigned int event_type,
+	unsigned long long max_age, sensor_event_t &event)
+{
+	last_event_slot_t *slot;
+	unsigned long long recorded_time;
+
+	slot = get_last_event_slot(sensor_id, event_type);
+
+	if (!slot)
+		return false;
 
-	if (it_event == m_last_events.end())
+	if (!read_last_event(slot, event, recorded_time))
+		return false;
+
+	if (max_age && (get_timestamp() - recorded_time > max_age))
 		return false;
 
-	event = it_event->second;
+	return true;
+}
+
+/*
+ * Registers request to be answered with the next event of the type
+ * recorded, or with NULL after timeout (msec). The answer may come before
+ * this returns. Returns false, leaving request unanswered, if the type is
+ * not recorded or there is no timer to bound the wait.
+ */
+bool csensor_event_dispatcher::request_next_event(sensor_id_t sensor_id, unsigned int event_type,
+	unsigned int timeout, last_event_request_t *request)
+{
+	last_event_slot_t *slot;
+
+	slot = get_last_event_slot(sensor_id, event_type);
+
+	if (!slot || m_request_timer_fd < 0)
+		return false;
+
+	request->deadline = get_timestamp() + timeout * 1000ULL;
+
+	{
+		lock_guard<mutex> lock(slot->request_mutex);
+		request->next = slot->requests;
+		slot->requests = request;
+		slot->request_cnt.fetch_add(1);
+	}
+
+	set_request_timer(request->deadline);
+	return true;
+}
+
+/*
+ * Brings the timer forward to deadline (usec) unless it already fires
+ * earlier. expire_requests() re-arms it for whatever is left.
+ */
+void csensor_event_dispatcher::set_request_timer(unsigned long long deadline)
+{
+	struct itimerspec spec;
+	unsigned long long now;
+	unsigned long long delay;
+
+	lock_guard<mutex> lock(m_request_timer_mutex);
+
+	if (m_request_timer_deadline && (m_request_timer_deadline <= deadline))
+		return;
+
+	m_request_timer_deadline = deadline;
+
+	now = get_timestamp();
+	delay = (deadline > now) ? (deadline - now) : 1;
+
+	memset(&spec, 0, sizeof(spec));
+	spec.it_value.tv_sec = delay / 1000000;
+	spec.it_value.tv_nsec = (delay % 1000000) * 1000;
+
+	if (timerfd_settime(m_request_timer_fd, 0, &spec, NULL) < 0)
+		ERR("timerfd_settime failed, errno : %d , errstr : %s", errno, strerror(errno));
+}
+
+/*
+ * Runs on a reactor thread when the request timer fires, and answers every
+ * request past its deadline with NULL
+ */
+bool csensor_event_dispatcher::expire_requests(void *ctx)
+{
+	csensor_event_dispatcher *inst = (csensor_event_dispatcher *)ctx;
+	last_event_request_t *expired = NULL;
+	last_event_request_t *next;
+	unsigned long long next_deadline = 0;
+	unsigned long long now;
+	uint64_t expirations;
+
+	while (read(inst->m_request_timer_fd, &expirations, sizeof(expirations)) > 0)
+		;
+
+	{
+		lock_guard<mutex> lock(inst->m_request_timer_mutex);
+		inst->m_request_timer_deadline = 0;
+	}
+
+	now = get_timestamp();
+
+	auto it_slot = inst->m_last_events.begin();
+
+	while (it_slot != inst->m_last_events.end()) {
+		last_event_slot_t *slot = it_slot->second;
+		++it_slot;
+
+		if (!slot->request_cnt.load())
+			continue;
+
+		lock_guard<mutex> lock(slot->request_mutex);
+		last_event_request_t **link = &slot->requests;
+
+		while (*link) {
+			last_event_request_t *request = *link;
+
+			if (request->deadline <= now) {
+				*link = request->next;
+				request->next = expired;
+				expired = request;
+				slot->request_cnt.fetch_sub(1);
+			} else {
+				if (!next_deadline || (request->deadline < next_deadline))
+					next_deadline = request->deadline;
+
+				link = &request->next;
+			}
+		}
+	}
+
+	while (expired) {
+		next = expired->next;
+		expired->answer(expired->ctx, NULL);
+		expired = next;
+	}
+
+	if (next_deadline)
+		inst->set_request_timer(next_deadline);
+
 	return true;
 }
 
@@ -293,12 +689,79 @@ bool csensor_event_dispatcher::has_active_virtual_sensor(virtual_sensor *sensor)
 	return (it_v_sensor != m_active_virtual_sensors.end());
 }
 
+/*
+ * Routes are swapped in by add/delete_active_virtual_sensor() and read only
+ * by the dispatcher thread; a replaced table is freed once the dispatcher
+ * has fetched a newer one. Consumers of an event are kept in dependency
+ * graph order, so upstream virtual sensors see a sample before the sensors
+ * built on top of them.
+ */
+const virtual_sensor_routes_t* csensor_event_dispatcher::get_virtual_sensor_routes(void)
+{
+	m_routes_reader_gen.store(m_routes_gen.load());
+	return m_virtual_sensor_routes.load();
+}
+
+void csensor_event_dispatcher::rebuild_virtual_sensor_routes(void)
+{
+	virtual_sensor_routes_t *routes;
+	retired_routes_t retired;
+
+	routes = new(std::nothrow) virtual_sensor_routes_t();
+	retm_if(!routes, "Failed to allocate memory");
+
+	auto it_v_sensor = m_active_virtual_sensors.begin();
+
+	while (it_v_sensor != m_active_virtual_sensors.end()) {
+		event_type_vector input_events;
+		(*it_v_sensor)->get_input_events(input_events);
+
+		if (input_events.empty())
+			routes->any_event_consumers.push_back(*it_v_sensor);
+
+		auto it_event = input_events.begin();
 
-virtual_sensors csensor_event_dispatcher::get_active_virtual_sensors(void)
+		while (it_event != input_events.end()) {
+			routes->consumers[*it_event].push_back(*it_v_sensor);
+			++it_event;
+		}
+
+		++it_v_sensor;
+	}
+
+	auto it_route = routes->consumers.begin();
+
+	while (it_route != routes->consumers.end()) {
+		std::stable_sort(it_route->second.begin(), it_route->second.end(),
+			[](virtual_sensor *a, virtual_sensor *b)->bool {
+				return a->get_graph_depth() < b->get_graph_depth();
+			}
+		);
+		++it_route;
+	}
+
+	retired.routes = m_virtual_sensor_routes.exchange(routes);
+	retired.gen = ++m_routes_gen;
+	m_retired_routes.push_back(retired);
+
+	reclaim_virtual_sensor_routes(false);
+}
+
+void csensor_event_dispatcher::reclaim_virtual_sensor_routes(bool force)
 {
-	AUTOLOCK(m_active_virtual_sensors_mutex);
+	unsigned int reader_gen = m_routes_reader_gen.load();
+
+	auto it_retired = m_retired_routes.begin();
 
-	return m_active_virtual_sensors;
+	while (it_retired != m_retired_routes.end()) {
+		if (!force && ((int)(reader_gen - it_retired->gen) < 0)) {
+			++it_retired;
+			continue;
+		}
+
+		delete it_retired->routes;
+		it_retired = m_retired_routes.erase(it_retired);
+	}
 }
 
 void csensor_event_dispatcher::sort_sensor_events(sensor_event_t *events, unsigned int cnt)
@@ -311,6 +774,11 @@ void csensor_event_dispatcher::sort_sensor_events(sensor_event_t *events, unsign
 }
 
 
+/*
+ * Replays the current state of the on-change event types the client
+ * registered. A streamed type is left to its next sample, which is due
+ * within one interval, rather than replaying one that may be long stale.
+ */
 void csensor_event_dispatcher::request_last_event(int client_id, sensor_id_t sensor_id)
 {
 	cclient_info_manager& client_info_manager = get_client_info_manager();
@@ -322,8 +790,10 @@ void csensor_event_dispatcher::request_last_event(int client_id, sensor_id_t sen
 
 		auto it_event = event_vec.begin();
 		while (it_event != event_vec.end()) {
+			last_event_slot_t *slot = get_last_event_slot(sensor_id, *it_event);
+			unsigned long long recorded_time;
 			sensor_event_t event;
-			if (is_record_event(*it_event) && get_last_event(*it_event, event)) {
+			if (slot && slot->on_change && read_last_event(slot, event, recorded_time)) {
 				if (client_socket.send(&event, sizeof(event)) > 0)
 					INFO("Send the last event[0x%x] to %s on socket[%d]", event.event_type,
 						client_info_manager.get_client_info(client_id), client_socket.get_socket_fd());
@@ -347,6 +817,7 @@ bool csensor_event_dispatcher::add_active_virtual_sensor(virtual_sensor * sensor
 	}
 
 	m_active_virtual_sensors.push_back(sensor);
+	rebuild_virtual_sensor_routes();
 
 	return true;
 }
@@ -363,6 +834,7 @@ bool csensor_event_dispatcher::delete_active_virtual_sensor(virtual_sensor * sen
 	}
 
 	m_active_virtual_sensors.erase(it_v_sensor);
+	rebuild_virtual_sensor_routes();
 
 	return true;
 }
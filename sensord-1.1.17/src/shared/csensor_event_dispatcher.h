@@ -25,50 +25,128 @@
 #include <cclient_info_manager.h>
 #include <sensor_fusion.h>
 #include <csocket.h>
+#include <creactor.h>
 #include <virtual_sensor.h>
 #include <vconf.h>
+#include <atomic>
+#include <mutex>
 
-typedef unordered_map<unsigned int, sensor_event_t> event_type_last_event_map;
+using std::atomic;
+using std::mutex;
+
+/*
+ * A request for the next event recorded in a slot. It is answered exactly
+ * once: with that event, on the dispatcher thread, or with NULL, on a
+ * reactor thread, once its deadline has passed. It belongs to the caller,
+ * who must keep it alive until then.
+ */
+typedef struct last_event_request {
+	void (*answer)(void *ctx, const sensor_event_t *event);
+	void *ctx;
+	unsigned long long deadline;
+	struct last_event_request *next;
+} last_event_request_t;
+
+/*
+ * Latest event of one (sensor, event type), guarded by a sequence lock:
+ * only the dispatcher thread writes it, seq is odd while a write is in
+ * progress and 0 until the first one. Readers never block the writer.
+ * request_cnt counts the pending requests, so recording an event only
+ * takes request_mutex when one is waiting. on_change is copied from the
+ * sensor's register_on_change_event().
+ */
+typedef struct {
+	atomic<unsigned int> seq;
+	sensor_event_t event;
+	unsigned long long recorded_time;
+	atomic<unsigned int> request_cnt;
+	mutex request_mutex;
+	last_event_request_t *requests;
+	bool on_change;
+} last_event_slot_t;
+
+typedef unordered_map<unsigned long long, last_event_slot_t *> last_event_slot_map;
 typedef list<virtual_sensor *> virtual_sensors;
+typedef vector<virtual_sensor *> virtual_sensor_vec;
+
+typedef struct {
+	unordered_map<unsigned int, virtual_sensor_vec> consumers;
+	virtual_sensor_vec any_event_consumers;
+} virtual_sensor_routes_t;
 
 class csensor_event_dispatcher
 {
 private:
+	typedef struct {
+		csocket socket;
+		bool accepted;
+	} event_channel_handshake_t;
+
 	bool m_lcd_on;
 	csocket m_accept_socket;
+	creactor *m_reactor;
 	cmutex m_mutex;
-	cmutex m_last_events_mutex;
-	event_type_last_event_map m_last_events;
+	last_event_slot_map m_last_events;
+	int m_request_timer_fd;
+	mutex m_request_timer_mutex;
+	unsigned long long m_request_timer_deadline;
 	virtual_sensors m_active_virtual_sensors;
 	cmutex m_active_virtual_sensors_mutex;
 	sensor_fusion *m_sensor_fusion;
 
+	typedef struct {
+		virtual_sensor_routes_t *routes;
+		unsigned int gen;
+	} retired_routes_t;
+
+	atomic<virtual_sensor_routes_t *> m_virtual_sensor_routes;
+	atomic<unsigned int> m_routes_gen;
+	atomic<unsigned int> m_routes_reader_gen;
+	list<retired_routes_t> m_retired_routes;
+
 	csensor_event_dispatcher();
 	~csensor_event_dispatcher();
 	csensor_event_dispatcher(csensor_event_dispatcher const&) {};
 	csensor_event_dispatcher& operator=(csensor_event_dispatcher const&);
 
-	void accept_connections(void);
-	void accept_event_channel(csocket client_socket);
+	static bool accept_connections(void *ctx);
+	static bool event_channel_readable(void *ctx);
+	static bool close_event_channel_handshake(void *ctx);
+	bool accept_event_channel(event_channel_handshake_t &handshake);
 
 	void dispatch_event(void);
+	void synthesize_events(const virtual_sensor_routes_t *routes, sensor_event_t *events,
+		unsigned int &event_cnt, unsigned int max_event_cnt, vector<sensor_event_t> &outs);
 	void send_sensor_events(void* events, int event_cnt, bool is_hub_event);
 	static cclient_info_manager& get_client_info_manager(void);
 	static csensor_event_queue& get_event_queue(void);
 
-	bool is_record_event(unsigned int event_type);
-	void put_last_event(unsigned int event_type, const sensor_event_t &event);
-	bool get_last_event(unsigned int event_type, sensor_event_t &event);
+	void make_last_event_slots(void);
+	last_event_slot_t* get_last_event_slot(sensor_id_t sensor_id, unsigned int event_type);
+	void put_last_event(const sensor_event_t &event);
+	bool read_last_event(last_event_slot_t *slot, sensor_event_t &event, unsigned long long &recorded_time);
+	void set_request_timer(unsigned long long deadline);
+	static bool expire_requests(void *ctx);
 
 	bool has_active_virtual_sensor(virtual_sensor *sensor);
-	virtual_sensors get_active_virtual_sensors(void);
+	const virtual_sensor_routes_t* get_virtual_sensor_routes(void);
+	void rebuild_virtual_sensor_routes(void);
+	void reclaim_virtual_sensor_routes(bool force);
 
 	void sort_sensor_events(sensor_event_t *events, unsigned int cnt);
 public:
 	static csensor_event_dispatcher& get_instance();
-	bool run(void);
+	bool run(creactor &reactor);
 	void request_last_event(int client_id, sensor_id_t sensor_id);
 
+	unsigned int process_event(const sensor_event_t &seed, sensor_event_t *events,
+		unsigned int max_event_cnt, vector<sensor_event_t> &outs);
+
+	bool is_record_event(sensor_id_t sensor_id, unsigned int event_type);
+	bool get_last_event(sensor_id_t sensor_id, unsigned int event_type, unsigned long long max_age, sensor_event_t &event);
+	bool request_next_event(sensor_id_t sensor_id, unsigned int event_type, unsigned int timeout,
+		last_event_request_t *request);
+
 	bool add_active_virtual_sensor(virtual_sensor *sensor);
 	bool delete_active_virtual_sensor(virtual_sensor *sensor);
 };
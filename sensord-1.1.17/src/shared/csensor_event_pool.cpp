@@ -0,0 +1,172 @@
+/*
+ * libsensord-share
+ *
+ * Copyright (c) 2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <csensor_event_pool.h>
+#include <new>
+#include "common.h"
+
+csensor_event_pool::csensor_event_pool(size_t event_size, unsigned int capacity)
+: m_event_size(event_size)
+, m_capacity(capacity)
+, m_mask(capacity - 1)
+, m_head(0)
+, m_tail(capacity)
+, m_in_use(0)
+, m_high_water(0)
+, m_fallback_cnt(0)
+{
+	if (capacity & m_mask)
+		ERR("Capacity(%d) of event pool must be a power of two", capacity);
+
+	m_buffer = new(std::nothrow) char[event_size * capacity];
+	m_free_slots = new(std::nothrow) free_slot[capacity];
+
+	if (!m_buffer || !m_free_slots) {
+		ERR("Failed to allocate memory for event pool(%d x %d)", event_size, capacity);
+		delete[] m_buffer;
+		delete[] m_free_slots;
+		m_buffer = NULL;
+		m_free_slots = NULL;
+		m_capacity = 0;
+		return;
+	}
+
+	for (unsigned int i = 0; i < capacity; ++i) {
+		m_free_slots[i].index = i;
+		m_free_slots[i].seq.store(i + 1, std::memory_order_relaxed);
+	}
+}
+
+csensor_event_pool::~csensor_event_pool()
+{
+	delete[] m_buffer;
+	delete[] m_free_slots;
+}
+
+bool csensor_event_pool::pop_free_index(unsigned int &index)
+{
+	free_slot *slot;
+	unsigned int pos = m_head.load(std::memory_order_relaxed);
+
+	if (!m_capacity)
+		return false;
+
+	while (true) {
+		slot = &m_free_slots[pos & m_mask];
+		unsigned int seq = slot->seq.load(std::memory_order_acquire);
+		int diff = (int)(seq - (pos + 1));
+
+		if (diff == 0) {
+			if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0)
+			return false;
+		else
+			pos = m_head.load(std::memory_order_relaxed);
+	}
+
+	index = slot->index;
+	slot->seq.store(pos + m_capacity, std::memory_order_release);
+
+	return true;
+}
+
+void csensor_event_pool::push_free_index(unsigned int index)
+{
+	free_slot *slot;
+	unsigned int pos = m_tail.load(std::memory_order_relaxed);
+
+	while (true) {
+		slot = &m_free_slots[pos & m_mask];
+		unsigned int seq = slot->seq.load(std::memory_order_acquire);
+
+		/*
+		 * The ring can never be full here, as it holds every index at most
+		 * once. A mismatch only means another thread is still in the middle
+		 * of moving this slot, so just retry.
+		 */
+		if (seq == pos) {
+			if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else
+			pos = m_tail.load(std::memory_order_relaxed);
+	}
+
+	slot->index = index;
+	slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+void csensor_event_pool::update_high_water(unsigned int in_use)
+{
+	unsigned int high_water = m_high_water.load(std::memory_order_relaxed);
+
+	while (in_use > high_water) {
+		if (m_high_water.compare_exchange_weak(high_water, in_use, std::memory_order_relaxed))
+			break;
+	}
+}
+
+void* csensor_event_pool::acquire(void)
+{
+	unsigned int index;
+	void *event;
+
+	if (pop_free_index(index)) {
+		event = m_buffer + (index * m_event_size);
+	} else {
+		event = new(std::nothrow) char[m_event_size];
+		retvm_if(!event, NULL, "Failed to allocate memory");
+		m_fallback_cnt.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	update_high_water(m_in_use.fetch_add(1, std::memory_order_relaxed) + 1);
+
+	return event;
+}
+
+void csensor_event_pool::release(void *event)
+{
+	if (!event)
+		return;
+
+	m_in_use.fetch_sub(1, std::memory_order_relaxed);
+
+	if (!is_owner(event)) {
+		delete[] (char *)event;
+		return;
+	}
+
+	push_free_index(((char *)event - m_buffer) / m_event_size);
+}
+
+bool csensor_event_pool::is_owner(void *event) const
+{
+	char *pos = (char *)event;
+
+	return (m_buffer && (pos >= m_buffer) && (pos < m_buffer + (m_event_size * m_capacity)));
+}
+
+void csensor_event_pool::get_stats(event_pool_stats_t &stats) const
+{
+	stats.event_size = m_event_size;
+	stats.capacity = m_capacity;
+	stats.in_use = m_in_use.load(std::memory_order_relaxed);
+	stats.high_water = m_high_water.load(std::memory_order_relaxed);
+	stats.fallback_cnt = m_fallback_cnt.load(std::memory_order_relaxed);
+}
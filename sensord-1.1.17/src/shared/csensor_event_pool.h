@@ -0,0 +1,78 @@
+/*
+ * libsensord-share
+ *
+ * Copyright (c) 2013 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if !defined(_CSENSOR_EVENT_POOL_CLASS_H_)
+#define _CSENSOR_EVENT_POOL_CLASS_H_
+#include <stddef.h>
+#include <atomic>
+
+using std::atomic;
+
+typedef struct {
+	size_t event_size;
+	unsigned int capacity;
+	unsigned int in_use;
+	unsigned int high_water;
+	unsigned int fallback_cnt;
+} event_pool_stats_t;
+
+/*
+ * Preallocated pool of fixed-size event buffers.
+ * Free buffers are kept as indices in a bounded lock-free ring, so acquire()
+ * and release() are O(1) and safe from any thread. When the pool runs dry,
+ * acquire() falls back to the heap and release() tells both apart by address.
+ */
+class csensor_event_pool
+{
+public:
+	csensor_event_pool(size_t event_size, unsigned int capacity);
+	~csensor_event_pool();
+
+	void* acquire(void);
+	void release(void *event);
+	bool is_owner(void *event) const;
+
+	void get_stats(event_pool_stats_t &stats) const;
+private:
+	struct free_slot {
+		atomic<unsigned int> seq;
+		unsigned int index;
+	};
+
+	size_t m_event_size;
+	unsigned int m_capacity;
+	unsigned int m_mask;
+	char *m_buffer;
+	free_slot *m_free_slots;
+	atomic<unsigned int> m_head;
+	atomic<unsigned int> m_tail;
+
+	atomic<unsigned int> m_in_use;
+	atomic<unsigned int> m_high_water;
+	atomic<unsigned int> m_fallback_cnt;
+
+	csensor_event_pool(csensor_event_pool const&);
+	csensor_event_pool& operator=(csensor_event_pool const&);
+
+	bool pop_free_index(unsigned int &index);
+	void push_free_index(unsigned int index);
+	void update_high_water(unsigned int in_use);
+};
+
+#endif
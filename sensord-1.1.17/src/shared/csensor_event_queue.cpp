@@ -18,10 +18,35 @@
  */
 
 #include <csensor_event_queue.h>
+#include <sys/eventfd.h>
+#include <sched.h>
+#include <errno.h>
 #include "common.h"
 
 csensor_event_queue::csensor_event_queue()
+: m_tail(0)
+, m_head(0)
+, m_event_cnt(0)
+, m_sleeping(false)
+, m_sensor_event_pool(sizeof(sensor_event_t), QUEUE_SIZE)
+, m_small_sensorhub_event_pool(get_compact_sensorhub_event_size(SMALL_HUB_DATA_SIZE), SMALL_SENSORHUB_EVENT_POOL_SIZE)
+, m_large_sensorhub_event_pool(get_compact_sensorhub_event_size(SENSOR_HUB_DATA_SIZE), LARGE_SENSORHUB_EVENT_POOL_SIZE)
 {
+	for (unsigned int i = 0; i < QUEUE_SIZE; ++i) {
+		m_slots[i].seq.store(i, std::memory_order_relaxed);
+		m_slots[i].event = NULL;
+	}
+
+	m_wakeup_fd = eventfd(0, 0);
+
+	if (m_wakeup_fd < 0)
+		ERR("Failed to create eventfd for event queue, errno : %d , errstr : %s", errno, strerror(errno));
+}
+
+csensor_event_queue::~csensor_event_queue()
+{
+	if (m_wakeup_fd >= 0)
+		close(m_wakeup_fd);
 }
 
 csensor_event_queue& csensor_event_queue::get_instance()
@@ -33,7 +58,7 @@ csensor_event_queue& csensor_event_queue::get_instance()
 
 void csensor_event_queue::push(sensor_event_t const &event)
 {
-	sensor_event_t *new_event = new(std::nothrow) sensor_event_t;
+	sensor_event_t *new_event = (sensor_event_t *)m_sensor_event_pool.acquire();
 	retm_if(!new_event, "Failed to allocate memory");
 	*new_event = event;
 
@@ -42,43 +67,145 @@ void csensor_event_queue::push(sensor_event_t const &event)
 
 void csensor_event_queue::push(sensorhub_event_t const &event)
 {
-	sensorhub_event_t *new_event = new(std::nothrow) sensorhub_event_t;
+	compact_sensorhub_event_t *new_event;
+	new_event = (compact_sensorhub_event_t *)get_sensorhub_event_pool(event.data.hub_data_size).acquire();
 	retm_if(!new_event, "Failed to allocate memory");
-	*new_event = event;
+	compact_sensorhub_event(new_event, (sensorhub_event_t *)&event);
 
 	push_internal(new_event);
 }
 
 void csensor_event_queue::push_internal(void *event)
 {
-	lock l(m_mutex);
-	bool wake = m_queue.empty();
+	event_slot *slot;
+	unsigned int pos = m_tail.load(std::memory_order_relaxed);
+
+	while (true) {
+		slot = &m_slots[pos & QUEUE_MASK];
+		unsigned int seq = slot->seq.load(std::memory_order_acquire);
+		int diff = (int)(seq - pos);
+
+		if (diff == 0) {
+			if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			event_pool_stats_t sensor_stats, small_sensorhub_stats, large_sensorhub_stats;
+
+			get_pool_stats(sensor_stats, small_sensorhub_stats, large_sensorhub_stats);
+			ERR("Queue is full, drop it! (sensor events in use: %d, high water: %d, fallback: %d)",
+				sensor_stats.in_use, sensor_stats.high_water, sensor_stats.fallback_cnt);
+
+			release(event);
+			return;
+		} else
+			pos = m_tail.load(std::memory_order_relaxed);
+	}
+
+	slot->event = event;
+	slot->seq.store(pos + 1, std::memory_order_release);
+
+	if (m_event_cnt.fetch_add(1) == 0 && m_sleeping.load())
+		wake_up();
+}
 
-	if (m_queue.size() >= QUEUE_FULL_SIZE) {
-		ERR("Queue is full, drop it!");
+bool csensor_event_queue::try_pop(void **event)
+{
+	event_slot *slot = &m_slots[m_head & QUEUE_MASK];
+	unsigned int seq = slot->seq.load(std::memory_order_acquire);
 
-		unsigned int event_type = *((unsigned int *)(event));
+	if (seq != m_head + 1)
+		return false;
 
-		if (is_sensorhub_event(event_type))
-			delete (sensorhub_event_t *)event;
-		else
-			delete (sensor_event_t *)event;
+	*event = slot->event;
+	slot->seq.store(m_head + QUEUE_SIZE, std::memory_order_release);
+	++m_head;
 
-	} else
-		m_queue.push(event);
+	m_event_cnt.fetch_sub(1, std::memory_order_acq_rel);
+	return true;
+}
+
+void csensor_event_queue::wake_up(void)
+{
+	const uint64_t one = 1;
 
-	if (wake)
-		m_cond_var.notify_one();
+	if (write(m_wakeup_fd, &one, sizeof(one)) != sizeof(one))
+		ERR("Failed to wake up event queue, errno : %d , errstr : %s", errno, strerror(errno));
+}
+
+void csensor_event_queue::wait_event(void)
+{
+	uint64_t cnt;
+
+	/*
+	 * Producers only signal the eventfd when they see the dispatcher asleep,
+	 * so announce it before the last look at the count. Both sides use
+	 * sequentially consistent accesses, so either the producer sees the
+	 * flag or the dispatcher sees the event.
+	 *
+	 * Events are counted after they are published, so a non-zero count with
+	 * an unready head slot means a producer is still filling the head slot.
+	 * No wakeup will come for it, so spin it out instead of sleeping.
+	 */
+	m_sleeping.store(true);
+
+	if (m_event_cnt.load() > 0) {
+		m_sleeping.store(false, std::memory_order_relaxed);
+		sched_yield();
+		return;
+	}
+
+	if (read(m_wakeup_fd, &cnt, sizeof(cnt)) < 0 && errno != EINTR)
+		ERR("Failed to wait on event queue, errno : %d , errstr : %s", errno, strerror(errno));
+
+	m_sleeping.store(false, std::memory_order_relaxed);
 }
 
 void* csensor_event_queue::pop(void)
 {
-	ulock u(m_mutex);
-	while (m_queue.empty())
-		m_cond_var.wait(u);
+	void *event;
+
+	while (!try_pop(&event))
+		wait_event();
 
-	void* event = m_queue.front();
-	m_queue.pop();
 	return event;
 }
 
+csensor_event_pool& csensor_event_queue::get_sensorhub_event_pool(int hub_data_size)
+{
+	if (hub_data_size <= SMALL_HUB_DATA_SIZE)
+		return m_small_sensorhub_event_pool;
+
+	return m_large_sensorhub_event_pool;
+}
+
+void csensor_event_queue::release(void *event)
+{
+	unsigned int event_type = *((unsigned int *)(event));
+
+	if (is_sensorhub_event(event_type))
+		get_sensorhub_event_pool(((compact_sensorhub_event_t *)event)->hub_data_size).release(event);
+	else
+		m_sensor_event_pool.release(event);
+}
+
+void csensor_event_queue::get_pool_stats(event_pool_stats_t &sensor_stats, event_pool_stats_t &small_sensorhub_stats,
+	event_pool_stats_t &large_sensorhub_stats)
+{
+	m_sensor_event_pool.get_stats(sensor_stats);
+	m_small_sensorhub_event_pool.get_stats(small_sensorhub_stats);
+	m_large_sensorhub_event_pool.get_stats(large_sensorhub_stats);
+}
+
+void csensor_event_queue::print_pool_stats(void)
+{
+	event_pool_stats_t stats[3];
+	const char *pool_names[3] = {"sensor", "small sensorhub", "large sensorhub"};
+
+	get_pool_stats(stats[0], stats[1], stats[2]);
+
+	for (int i = 0; i < 3; ++i) {
+		INFO("%s event pool: %d bytes x %d, in use: %d, high water: %d, fallback: %d",
+			pool_names[i], stats[i].event_size, stats[i].capacity, stats[i].in_use,
+			stats[i].high_water, stats[i].fallback_cnt);
+	}
+}
@@ -20,38 +20,66 @@
 #if !defined(_CSENSOR_EVENT_QUEUE_CLASS_H_)
 #define _CSENSOR_EVENT_QUEUE_CLASS_H_
 #include <sf_common.h>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
+#include <csensor_event_pool.h>
+#include <atomic>
 
-using std::queue;
-using std::mutex;
-using std::lock_guard;
-using std::unique_lock;
-using std::condition_variable;
+using std::atomic;
 
+/*
+ * Bounded multi-producer/single-consumer ring of event slots.
+ * Pollers and virtual sensors push concurrently without taking a lock,
+ * and only the dispatcher pops. The dispatcher sleeps on an eventfd which
+ * is signalled only when the queue goes from empty to non-empty while the
+ * dispatcher is asleep.
+ * Event buffers come from per-size pools owned by the queue, and the popped
+ * event must be handed back with release(). Sensorhub events are queued as
+ * compact_sensorhub_event_t, trimmed to their hub_data_size.
+ */
 class csensor_event_queue
 {
 private:
-	static const unsigned int QUEUE_FULL_SIZE = 1000;
+	static const unsigned int QUEUE_SIZE = 1024;
+	static const unsigned int QUEUE_MASK = QUEUE_SIZE - 1;
+	static const unsigned int SMALL_SENSORHUB_EVENT_POOL_SIZE = 64;
+	static const unsigned int LARGE_SENSORHUB_EVENT_POOL_SIZE = 4;
+	static const int SMALL_HUB_DATA_SIZE = 256;
 
-	queue<void* > m_queue;
-	mutex m_mutex;
-	condition_variable m_cond_var;
+	struct event_slot {
+		atomic<unsigned int> seq;
+		void *event;
+	};
 
-	typedef lock_guard<mutex> lock;
-	typedef unique_lock<mutex> ulock;
+	event_slot m_slots[QUEUE_SIZE];
+	atomic<unsigned int> m_tail;
+	unsigned int m_head;
+	atomic<unsigned int> m_event_cnt;
+	atomic<bool> m_sleeping;
+	int m_wakeup_fd;
+
+	csensor_event_pool m_sensor_event_pool;
+	csensor_event_pool m_small_sensorhub_event_pool;
+	csensor_event_pool m_large_sensorhub_event_pool;
 
 	csensor_event_queue();
-	csensor_event_queue(csensor_event_queue const&) {};
+	~csensor_event_queue();
+	csensor_event_queue(csensor_event_queue const&);
 	csensor_event_queue& operator=(csensor_event_queue const&);
 	void push_internal(void *event);
+	csensor_event_pool& get_sensorhub_event_pool(int hub_data_size);
+	bool try_pop(void **event);
+	void wait_event(void);
+	void wake_up(void);
 
 public:
 	static csensor_event_queue& get_instance();
 	void push(sensor_event_t const &event);
 	void push(sensorhub_event_t const &event);
 	void* pop(void);
+	void release(void *event);
+
+	void get_pool_stats(event_pool_stats_t &sensor_stats, event_pool_stats_t &small_sensorhub_stats,
+		event_pool_stats_t &large_sensorhub_stats);
+	void print_pool_stats(void);
 };
 
 #endif
@@ -145,12 +145,16 @@ bool csocket::accept(csocket& client_socket) const
 	int err = 0;
 
 	do {
+		err = 0;
 		client_socket.m_sock_fd = ::accept(m_sock_fd, (sockaddr *)&m_addr, (socklen_t *)&addr_length);
 		if (!client_socket.is_valid())
 			err = errno;
 	} while (err == EINTR);
 
 	if (!client_socket.is_valid()) {
+		if ((err == EAGAIN) || (err == EWOULDBLOCK))
+			return false;
+
 		ERR("Accept failed for socket(%d), errno : %d , errstr : %s", m_sock_fd, errno, strerror(errno));
 		return false;
 	}
@@ -283,6 +287,33 @@ ssize_t csocket::recv(void* buffer, size_t size) const
 	return recv_for_seqpacket(buffer, size);
 }
 
+/*
+ * Takes whatever is already queued, up to size, without waiting for the
+ * rest. Returns the byte count, 0 when the peer has shut down, -EAGAIN when
+ * nothing is queued and -errno on other failures.
+ */
+ssize_t csocket::recv_available(void* buffer, size_t size) const
+{
+	ssize_t len;
+	int err;
+
+	do {
+		len = ::recv(m_sock_fd, buffer, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+		err = len < 0 ? errno : 0;
+	} while (err == EINTR);
+
+	if (len >= 0)
+		return len;
+
+	if ((err == EAGAIN) || (err == EWOULDBLOCK))
+		return -EAGAIN;
+
+	ERR("recv(%d, 0x%p, %d) = %d, error: %s(%d) for %s",
+		m_sock_fd, buffer, size, len, strerror(err), err, get_client_name());
+
+	return -err;
+}
+
 bool csocket::connect(const char *sock_path)
 {
 	const int TIMEOUT = 5;
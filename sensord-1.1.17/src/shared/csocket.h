@@ -49,9 +49,11 @@ public:
 	//Data Transfer
 	ssize_t send(void const* buffer, size_t size) const;
 	ssize_t recv(void* buffer, size_t size) const;
+	ssize_t recv_available(void* buffer, size_t size) const;
 
 	bool set_connection_mode(void);
 	bool set_transfer_mode(void);
+	bool set_blocking_mode(bool blocking);
 	bool is_blocking_mode(void);
 
 	//check if socket is created
@@ -63,7 +65,6 @@ public:
 	bool is_block_mode(void);
 
 private:
-	bool set_blocking_mode(bool blocking);
 	bool set_sock_type(void);
 
 	ssize_t send_for_seqpacket(void const* buffer, size_t size) const;
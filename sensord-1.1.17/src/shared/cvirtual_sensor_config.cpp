@@ -298,6 +298,26 @@ bool cvirtual_sensor_config::get(const string& sensor_type, const string& elemen
 	return false;
 }
 
+bool cvirtual_sensor_config::get(const string& sensor_type, const string& element, vector<string> &values)
+{
+	string value;
+
+	values.clear();
+
+	for (int i = 1; ; ++i) {
+		stringstream attr_stream;
+
+		attr_stream << DEFAULT_ATTR << i;
+
+		if (!get(sensor_type, element, attr_stream.str(), value))
+			break;
+
+		values.push_back(value);
+	}
+
+	return !values.empty();
+}
+
 bool cvirtual_sensor_config::is_supported(const string& sensor_type)
 {
 	auto it_device_list = m_virtual_sensor_config.find(m_device_id);
@@ -21,8 +21,13 @@
 #define _CVIRTUAL_SENSOR_CONFIG_CLASS_H_
 
 #include <cconfig.h>
+#include <vector>
 
+using std::vector;
+
+#if !defined(VIRTUAL_SENSOR_CONFIG_FILE_PATH)
 #define VIRTUAL_SENSOR_CONFIG_FILE_PATH "/usr/etc/virtual_sensors.xml"
+#endif
 
 typedef unordered_map<string,string> Element;
 /*
@@ -78,6 +83,7 @@ public:
 	bool get(const string& sensor_type, const string& element, string& value);
 	bool get(const string& sensor_type, const string& element, float *value, int count =1);
 	bool get(const string& sensor_type, const string& element, int *value, int count = 1);
+	bool get(const string& sensor_type, const string& element, vector<string> &values);
 
 	bool is_supported(const string &sensor_type);
 };
@@ -292,6 +292,16 @@ bool sensor_base::is_supported(unsigned int event_type)
 	return true;
 }
 
+bool sensor_base::is_on_change_event(unsigned int event_type)
+{
+	auto iter = find(m_on_change_event_info.begin(), m_on_change_event_info.end(), event_type);
+
+	if (iter == m_on_change_event_info.end())
+		return false;
+
+	return true;
+}
+
 long sensor_base::set_command(unsigned int cmd, long value)
 {
 	return -1;
@@ -312,6 +322,16 @@ void sensor_base::register_supported_event(unsigned int event_type)
 	m_supported_event_info.push_back(event_type);
 }
 
+/*
+ * For an event type reported only when the state changes, so its last
+ * event stays the current state however old it is.
+ */
+void sensor_base::register_on_change_event(unsigned int event_type)
+{
+	register_supported_event(event_type);
+	m_on_change_event_info.push_back(event_type);
+}
+
 unsigned int sensor_base::get_client_cnt(unsigned int event_type)
 {
 	AUTOLOCK(m_client_info_mutex);
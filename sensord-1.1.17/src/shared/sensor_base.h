@@ -79,6 +79,7 @@ public:
 	void get_sensor_info(sensor_info &info);
 	virtual bool get_properties(sensor_properties_t &properties);
 	bool is_supported(unsigned int event_type);
+	bool is_on_change_event(unsigned int event_type);
 
 	virtual long set_command(unsigned int cmd, long value);
 	virtual int send_sensorhub_data(const char* data, int data_len);
@@ -86,6 +87,7 @@ public:
 	virtual int get_sensor_data(unsigned int type, sensor_data_t &data);
 
 	void register_supported_event(unsigned int event_type);
+	void register_on_change_event(unsigned int event_type);
 protected:
 	typedef lock_guard<mutex> lock;
 	typedef lock_guard<recursive_mutex> rlock;
@@ -107,6 +109,7 @@ protected:
 	cmutex m_client_info_mutex;
 
 	vector<unsigned int> m_supported_event_info;
+	vector<unsigned int> m_on_change_event_info;
 
 	bool m_started;
 
@@ -72,7 +72,8 @@ typedef enum {
 	DUST_SENSOR,
 	RV_RAW_SENSOR,
 	UNCAL_GYROSCOPE_SENSOR,
-	UNCAL_GEOMAGNETIC_SENSOR
+	UNCAL_GEOMAGNETIC_SENSOR,
+	GAME_ROTATION_VECTOR_SENSOR
 } sensor_type_t;
 
 typedef unsigned int sensor_id_t;
@@ -174,9 +174,7 @@ void sensor_info::get_raw_data(raw_data_t &data)
 
 void sensor_info::set_raw_data(const char *data, int data_len)
 {
-	raw_data_t raw_data(&data[0], &data[data_len]);
-
-	auto it_r_data = raw_data.begin();
+	const char *it_r_data = data;
 
 	int type, id, privilege;
 
@@ -270,37 +268,39 @@ void sensor_info::put(raw_data_t &data, vector<unsigned int> &value)
 	}
 }
 
-raw_data_iterator sensor_info::get(raw_data_iterator it, int &value)
+const char* sensor_info::get(const char *it, int &value)
 {
-	copy(it, it + sizeof(value), (char*) &value);
+	std::copy(it, it + sizeof(value), (char*) &value);
 
 	return it + sizeof(value);
 }
 
-raw_data_iterator sensor_info::get(raw_data_iterator it, float &value)
+const char* sensor_info::get(const char *it, float &value)
 {
-	copy(it, it + sizeof(value), (char*) &value);
+	std::copy(it, it + sizeof(value), (char*) &value);
 
 	return it + sizeof(value);
 }
 
-raw_data_iterator sensor_info::get(raw_data_iterator it, string &value)
+const char* sensor_info::get(const char *it, string &value)
 {
 	int len;
 
 	it = get(it, len);
 
-	copy(it, it + len, back_inserter(value));
+	value.assign(it, len);
 
 	return it + len;
 }
 
-raw_data_iterator sensor_info::get(raw_data_iterator it, vector<unsigned int> &value)
+const char* sensor_info::get(const char *it, vector<unsigned int> &value)
 {
 	int len;
 
 	it = get(it, len);
 
+	value.reserve(value.size() + len);
+
 	int ele;
 	for (int i = 0; i < len; ++i) {
 		it = get(it, ele);
@@ -86,10 +86,10 @@ private:
 	void put(raw_data_t &data, string &value);
 	void put(raw_data_t &data, vector<unsigned int> &value);
 
-	raw_data_iterator get(raw_data_iterator it, int &value);
-	raw_data_iterator get(raw_data_iterator it, float &value);
-	raw_data_iterator get(raw_data_iterator it, string &value);
-	raw_data_iterator get(raw_data_iterator it, vector<unsigned int> &value);
+	const char* get(const char *it, int &value);
+	const char* get(const char *it, float &value);
+	const char* get(const char *it, string &value);
+	const char* get(const char *it, vector<unsigned int> &value);
 };
 
 #endif /* _SENSOR_INFO_H_ */
@@ -41,8 +41,13 @@ using std::unordered_set;
 #define HAL_ELEMENT "HAL"
 #define SENSOR_ELEMENT "SENSOR"
 
+#if !defined(PLUGINS_CONFIG_PATH)
 #define PLUGINS_CONFIG_PATH "/usr/etc/sensor_plugins.xml"
+#endif
+
+#if !defined(PLUGINS_DIR_PATH)
 #define PLUGINS_DIR_PATH "/usr/lib/sensord"
+#endif
 
 #define SENSOR_INDEX_SHIFT 16
 
@@ -134,9 +139,10 @@ bool sensor_plugin_loader::insert_module(plugin_type type, const string &path)
 
 			sensor_type_t sensor_type = sensor->get_type();
 
-			if (sensor->is_fusion())
+			if (sensor->is_fusion()) {
+				sensor->set_id(m_fusions.size() << SENSOR_INDEX_SHIFT | sensor_type);
 				m_fusions.push_back((sensor_fusion*) sensor);
-			else {
+			} else {
 				int idx;
 				idx = m_sensors.count(sensor_type);
 				sensor->set_id(idx << SENSOR_INDEX_SHIFT | sensor_type);
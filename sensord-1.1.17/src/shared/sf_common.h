@@ -27,7 +27,12 @@
 #include <vector>
 
 #define COMMAND_CHANNEL_PATH			"/tmp/sf_command_socket"
+#if !defined(EVENT_CHANNEL_PATH)
 #define EVENT_CHANNEL_PATH				"/tmp/sf_event_socket"
+#endif
+#if !defined(SENSOR_LIST_PATH)
+#define SENSOR_LIST_PATH				"/tmp/sf_sensor_list"
+#endif
 
 #define MAX_HANDLE			64
 #define MAX_HANDLE_REACHED	-2
@@ -51,6 +56,7 @@ enum packet_type_t {
 	CMD_SET_COMMAND,
 	CMD_GET_DATA,
 	CMD_SEND_SENSORHUB_DATA,
+	CMD_BATCH,
 	CMD_CNT,
 };
 
@@ -111,6 +117,21 @@ typedef struct {
 	sensor_data_t base_data;
 } cmd_get_data_done_t;
 
+#define SENSOR_LIST_MAGIC 0xCAFE5E25
+
+/*
+ * Layout of SENSOR_LIST_PATH, the sensor list every client is allowed to
+ * see, published read-only by the server. hidden_cnt counts the sensors
+ * left out of it because they need more than SENSOR_PERMISSION_STANDARD;
+ * a client must then ask for its list with CMD_GET_SENSOR_LIST
+ */
+typedef struct {
+	unsigned int magic;
+	int hidden_cnt;
+	size_t size;
+	char list[0];
+} sensor_list_file_t;
+
 typedef struct {
 } cmd_start_t;
 
@@ -146,6 +167,26 @@ typedef struct  {
 	char data[0];
 } cmd_send_sensorhub_data_t;
 
+/*
+ * data holds cmd_cnt packets (packet_header and payload), each padded to
+ * CMD_BATCH_ALIGN(). Only commands answered with cmd_done_t may be batched
+ */
+#define CMD_BATCH_ALIGN(size) (((size) + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1))
+
+typedef struct {
+	size_t cmd_cnt;
+	char data[0];
+} cmd_batch_t;
+
+/*
+ * The server stops at the first sub-command that fails, so cmd_cnt is the
+ * number of sub-commands applied, the last of which may have failed
+ */
+typedef struct {
+	int cmd_cnt;
+	long value[0];
+} cmd_batch_done_t;
+
 #define EVENT_CHANNEL_MAGIC 0xCAFECAFE
 
 typedef struct {
@@ -182,6 +223,23 @@ typedef struct sensorhub_event_t {
 	sensorhub_data_t data;
 } sensorhub_event_t;
 
+/*
+ * Variable-length form of sensorhub_event_t used by the event queue and the
+ * event channel. Only hub_data_size bytes of hub_data follow the header,
+ * so check compact_sensorhub_event()/expand_sensorhub_event() when modifying it
+ */
+typedef struct compact_sensorhub_event_t {
+	unsigned int event_type;
+	sensor_id_t sensor_id;
+	int version;
+	int sensorhub;
+	int type;
+	int hub_data_size;
+	unsigned long long timestamp;
+	float data[16];
+	char hub_data[0];
+} compact_sensorhub_event_t;
+
 typedef struct sensor_module{
 	std::vector<void*> sensors;
 } sensor_module;
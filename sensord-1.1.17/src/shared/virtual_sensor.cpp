@@ -19,9 +19,47 @@
 
 #include <virtual_sensor.h>
 #include <csensor_event_dispatcher.h>
+#include <sensor_plugin_loader.h>
+#include <sensor_fusion.h>
+#include <cvirtual_sensor_config.h>
+#include <sensor_internal.h>
 
+#define ELEMENT_INPUT "INPUT"
+
+#define MAX_GRAPH_DEPTH 8
+
+typedef struct {
+	const char *name;
+	sensor_type_t type;
+	unsigned int event_type;
+} input_sensor_info_t;
+
+static const input_sensor_info_t input_sensor_infos[] = {
+	{"ACCELEROMETER", ACCELEROMETER_SENSOR, ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME},
+	{"GYROSCOPE", GYROSCOPE_SENSOR, GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME},
+	{"GEOMAGNETIC", GEOMAGNETIC_SENSOR, GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME},
+	{"PROXIMITY", PROXIMITY_SENSOR, PROXIMITY_EVENT_CHANGE_STATE},
+	{"BIO", BIO_SENSOR, BIO_EVENT_RAW_DATA_REPORT_ON_TIME},
+	{"ORIENTATION", ORIENTATION_SENSOR, ORIENTATION_EVENT_RAW_DATA_REPORT_ON_TIME},
+	{"GRAVITY", GRAVITY_SENSOR, GRAVITY_EVENT_RAW_DATA_REPORT_ON_TIME},
+	{"ROTATION_VECTOR", ROTATION_VECTOR_SENSOR, ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME},
+	{"FUSION", FUSION_SENSOR, FUSION_EVENT_AGM},
+	{"GAME_ROTATION_VECTOR", GAME_ROTATION_VECTOR_SENSOR, GAME_ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME},
+};
+
+static const input_sensor_info_t* find_input_sensor_info(const string &name)
+{
+	for (unsigned int i = 0; i < sizeof(input_sensor_infos) / sizeof(input_sensor_infos[0]); ++i) {
+		if (name == input_sensor_infos[i].name)
+			return &input_sensor_infos[i];
+	}
+
+	return NULL;
+}
 
 virtual_sensor::virtual_sensor()
+: m_input_sensors_started(false)
+, m_input_interval(0)
 {
 
 }
@@ -36,6 +74,210 @@ bool virtual_sensor::is_virtual(void)
 	return true;
 }
 
+/*
+ * Input events are the event types synthesize() consumes. The dispatcher
+ * hands a seed event only to the active virtual sensors that registered its
+ * type; a sensor that registers none is offered every event.
+ */
+void virtual_sensor::register_input_event(unsigned int event_type)
+{
+	m_input_events.push_back(event_type);
+}
+
+void virtual_sensor::get_input_events(event_type_vector &events)
+{
+	events = m_input_events;
+}
+
+/*
+ * Input sensors are listed per virtual sensor in virtual_sensors.xml, e.g.
+ * <INPUT value1="ACCELEROMETER" value2="GRAVITY" />, and together form the
+ * virtual sensor dependency graph. Upstream sensors are reference counted
+ * through add_client()/start(), so they only run while some downstream
+ * virtual sensor is started, and they are asked for this sensor's minimum
+ * interval rather than for every downstream client's interval.
+ */
+bool virtual_sensor::load_input_sensors(const string &sensor_type)
+{
+	cvirtual_sensor_config &config = cvirtual_sensor_config::get_instance();
+	vector<string> input_names;
+
+	if (!config.get(sensor_type, ELEMENT_INPUT, input_names) || input_names.empty()) {
+		ERR("[INPUT] of %s is empty", sensor_type.c_str());
+		return false;
+	}
+
+	auto it_name = input_names.begin();
+
+	while (it_name != input_names.end()) {
+		const input_sensor_info_t *info;
+		input_sensor_t input;
+
+		info = find_input_sensor_info(*it_name);
+
+		if (!info) {
+			ERR("Unknown input sensor [%s] of %s", it_name->c_str(), sensor_type.c_str());
+			return false;
+		}
+
+		if (info->type == FUSION_SENSOR)
+			input.sensor = sensor_plugin_loader::get_instance().get_fusion();
+		else
+			input.sensor = sensor_plugin_loader::get_instance().get_sensor(info->type);
+
+		input.event_type = info->event_type;
+
+		if (!input.sensor) {
+			ERR("Failed to load input sensor [%s] of %s", it_name->c_str(), sensor_type.c_str());
+			return false;
+		}
+
+		if ((input.sensor == this) || (input.sensor->is_virtual() &&
+			static_cast<virtual_sensor *>(input.sensor)->depends_on(this, 0))) {
+			ERR("Input sensor [%s] of %s makes a dependency cycle", it_name->c_str(), sensor_type.c_str());
+			return false;
+		}
+
+		m_input_sensors.push_back(input);
+		register_input_event(input.event_type);
+
+		++it_name;
+	}
+
+	return true;
+}
+
+sensor_base* virtual_sensor::get_input_sensor(sensor_type_t type)
+{
+	auto it_input = m_input_sensors.begin();
+
+	while (it_input != m_input_sensors.end()) {
+		if (it_input->sensor->get_type() == type)
+			return it_input->sensor;
+
+		++it_input;
+	}
+
+	return NULL;
+}
+
+bool virtual_sensor::start_input_sensors(void)
+{
+	AUTOLOCK(m_input_sensors_mutex);
+
+	auto it_input = m_input_sensors.begin();
+
+	while (it_input != m_input_sensors.end()) {
+		it_input->sensor->add_client(it_input->event_type);
+
+		if (m_input_interval)
+			it_input->sensor->add_interval(get_id(), m_input_interval, true);
+
+		it_input->sensor->start();
+		++it_input;
+	}
+
+	m_input_sensors_started = true;
+	return true;
+}
+
+bool virtual_sensor::stop_input_sensors(void)
+{
+	AUTOLOCK(m_input_sensors_mutex);
+
+	auto it_input = m_input_sensors.begin();
+
+	while (it_input != m_input_sensors.end()) {
+		it_input->sensor->delete_client(it_input->event_type);
+		it_input->sensor->delete_interval(get_id(), true);
+		it_input->sensor->stop();
+		++it_input;
+	}
+
+	m_input_sensors_started = false;
+	return true;
+}
+
+/*
+ * Called by sensor_base whenever the minimum interval of this sensor changes,
+ * so the change propagates up the graph one node at a time.
+ */
+bool virtual_sensor::set_interval(unsigned long val)
+{
+	AUTOLOCK(m_input_sensors_mutex);
+
+	m_input_interval = val;
+
+	if (!m_input_sensors_started)
+		return true;
+
+	auto it_input = m_input_sensors.begin();
+
+	while (it_input != m_input_sensors.end()) {
+		it_input->sensor->add_interval(get_id(), val, true);
+		++it_input;
+	}
+
+	return true;
+}
+
+/*
+ * The interval this sensor's own clients asked for, in microseconds, so
+ * synthesize() can pace its output to it. default_interval is used until
+ * one has been set.
+ */
+unsigned long long virtual_sensor::get_output_interval(const unsigned long long default_interval)
+{
+	const unsigned long long MS_TO_US = 1000;
+
+	AUTOLOCK(m_input_sensors_mutex);
+
+	if (!m_input_interval)
+		return default_interval;
+
+	return m_input_interval * MS_TO_US;
+}
+
+unsigned int virtual_sensor::get_graph_depth(void)
+{
+	unsigned int depth = 0;
+
+	auto it_input = m_input_sensors.begin();
+
+	while (it_input != m_input_sensors.end()) {
+		if (it_input->sensor->is_virtual()) {
+			unsigned int input_depth = static_cast<virtual_sensor *>(it_input->sensor)->get_graph_depth() + 1;
+
+			if (input_depth > depth)
+				depth = input_depth;
+		}
+
+		++it_input;
+	}
+
+	return depth;
+}
+
+bool virtual_sensor::depends_on(virtual_sensor *sensor, unsigned int depth)
+{
+	if (depth > MAX_GRAPH_DEPTH)
+		return true;
+
+	auto it_input = m_input_sensors.begin();
+
+	while (it_input != m_input_sensors.end()) {
+		if (it_input->sensor == sensor)
+			return true;
+
+		if (it_input->sensor->is_virtual() &&
+			static_cast<virtual_sensor *>(it_input->sensor)->depends_on(sensor, depth + 1))
+			return true;
+
+		++it_input;
+	}
+
+	return false;
+}
 
 bool virtual_sensor::activate(void)
 {
@@ -31,14 +31,39 @@ public:
 	virtual void synthesize(const sensor_event_t &event, vector<sensor_event_t> &outs) = 0;
 	virtual int get_sensor_data(const unsigned int event_type, sensor_data_t &data) = 0;
 	bool is_virtual(void);
+	void get_input_events(event_type_vector &events);
+	unsigned int get_graph_depth(void);
 
 protected:
 	cmutex m_fusion_mutex;
 
+	void register_input_event(unsigned int event_type);
+
+	bool load_input_sensors(const string &sensor_type);
+	sensor_base* get_input_sensor(sensor_type_t type);
+	bool start_input_sensors(void);
+	bool stop_input_sensors(void);
+	virtual bool set_interval(unsigned long val);
+	unsigned long long get_output_interval(const unsigned long long default_interval);
+
 	bool activate(void);
 	bool deactivate(void);
 
 	bool push(sensor_event_t const &event);
+
+private:
+	typedef struct {
+		sensor_base *sensor;
+		unsigned int event_type;
+	} input_sensor_t;
+
+	event_type_vector m_input_events;
+	vector<input_sensor_t> m_input_sensors;
+	cmutex m_input_sensors_mutex;
+	bool m_input_sensors_started;
+	unsigned long m_input_interval;
+
+	bool depends_on(virtual_sensor *sensor, unsigned int depth);
 };
 
 #endif
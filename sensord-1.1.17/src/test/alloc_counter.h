@@ -0,0 +1,103 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if !defined(_ALLOC_COUNTER_H_)
+#define _ALLOC_COUNTER_H_
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+
+/*
+ * Replaces the global operator new/delete to count heap allocations.
+ * Include it from exactly one translation unit of a test executable.
+ */
+static std::atomic<unsigned long long> alloc_cnt(0);
+
+static inline unsigned long long get_alloc_cnt(void)
+{
+	return alloc_cnt.load(std::memory_order_relaxed);
+}
+
+/*
+ * Every replacement operator allocates and frees through this pair. They
+ * are kept out of line, so the compiler never sees a new expression paired
+ * directly with free().
+ */
+static __attribute__((noinline)) void* counted_alloc(size_t size)
+{
+	alloc_cnt.fetch_add(1, std::memory_order_relaxed);
+	return malloc(size ? size : 1);
+}
+
+static __attribute__((noinline)) void counted_free(void *ptr)
+{
+	free(ptr);
+}
+
+void* operator new(size_t size)
+{
+	void *ptr = counted_alloc(size);
+
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	void *ptr = counted_alloc(size);
+
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t &) throw()
+{
+	return counted_alloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t &) throw()
+{
+	return counted_alloc(size);
+}
+
+void operator delete(void *ptr) throw()
+{
+	counted_free(ptr);
+}
+
+void operator delete[](void *ptr) throw()
+{
+	counted_free(ptr);
+}
+
+void operator delete(void *ptr, size_t) throw()
+{
+	counted_free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) throw()
+{
+	counted_free(ptr);
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if !defined(_BENCH_UTIL_H_)
+#define _BENCH_UTIL_H_
+#include <time.h>
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+
+/*
+ * Helpers shared by the test and benchmark executables.
+ * Every executable prints its measurements and returns non-zero when any
+ * CHECK() failed, so ctest only fails on correctness and regression budgets,
+ * never on raw timings of the build host.
+ */
+static int check_failures = 0;
+
+#define CHECK(cond, fmt, arg...) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL %s:%d: " fmt "\n", __FILE__, __LINE__, ##arg); \
+			++check_failures; \
+		} \
+	} while (0)
+
+static inline unsigned long long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline unsigned long long percentile(std::vector<unsigned long long> &samples, double ratio)
+{
+	if (samples.empty())
+		return 0;
+
+	size_t index = (size_t)(ratio * (samples.size() - 1));
+
+	std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+	return samples[index];
+}
+
+static inline int test_result(const char *name)
+{
+	if (check_failures) {
+		printf("%s: %d check(s) failed\n", name, check_failures);
+		return 1;
+	}
+
+	printf("%s: passed\n", name);
+	return 0;
+}
+
+#endif
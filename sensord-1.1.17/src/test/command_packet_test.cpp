@@ -0,0 +1,395 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <command_worker.h>
+#include <sensor_plugin_loader.h>
+#include <csensor_event_queue.h>
+#include <sensor_accel.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string.h>
+#include <thread>
+#include <alloc_counter.h>
+#include <bench_util.h>
+
+/*
+ * Serves one client connection with the real command_worker on a reactor
+ * set up like the daemon's, over a socketpair, and drives it with raw
+ * packets. After a warm-up that greets the replay accelerometer, every
+ * round sends the commands a running client keeps sending: fixed-size
+ * ones, a batch, one payload too big for cpacket's inline storage and a
+ * CMD_GET_DATA, which goes through a reactor worker. Neither the client
+ * side cpackets nor the server's receive, dispatch and reply path may
+ * allocate in those rounds.
+ *
+ * Then CMD_GET_DATA waits for a sample the accelerometer doesn't have yet
+ * on more connections than there are workers, which must neither hold a
+ * thread nor slow down the rounds of another connection. It is answered
+ * by the next event the dispatcher records, or without data after
+ * GET_DATA_WAIT_TIME.
+ */
+
+static const int WARMUP_ROUNDS = 10;
+static const int ROUNDS = 1000;
+static const int SENSORHUB_DATA_SIZE = 512;
+static const int REACTOR_THREAD_CNT = 2;
+static const int REACTOR_WORKER_CNT = 2;
+static const int WAITING_CLIENT_CNT = REACTOR_WORKER_CNT + 1;
+static const unsigned long long GET_DATA_WAIT_TIME_NS = 220000000ULL;
+static const unsigned long long EVENT_DELAY_US = 20000;
+
+static bool recv_all(int fd, void *buffer, size_t size)
+{
+	char *ptr = (char *)buffer;
+	ssize_t len;
+
+	while (size) {
+		len = recv(fd, ptr, size, 0);
+
+		if (len <= 0)
+			return false;
+
+		ptr += len;
+		size -= len;
+	}
+
+	return true;
+}
+
+static bool recv_reply(int fd, int reply_cmd, void *reply, size_t reply_size)
+{
+	packet_header header;
+	char payload[sizeof(cmd_get_data_done_t)];
+
+	if (!recv_all(fd, &header, sizeof(header)) || header.cmd != reply_cmd ||
+		header.size != reply_size || reply_size > sizeof(payload))
+		return false;
+
+	if (!recv_all(fd, payload, reply_size))
+		return false;
+
+	if (reply)
+		memcpy(reply, payload, reply_size);
+
+	return true;
+}
+
+/*
+ * Sends the packet and reads back a reply of reply_size payload bytes,
+ * which is copied to reply when it is not NULL
+ */
+static bool transact(int fd, cpacket &packet, int reply_cmd, void *reply, size_t reply_size)
+{
+	if (send(fd, packet.packet(), packet.size(), MSG_NOSIGNAL) != (ssize_t)packet.size())
+		return false;
+
+	return recv_reply(fd, reply_cmd, reply, reply_size);
+}
+
+static bool send_cmd(int fd, int cmd, const void *payload, size_t size)
+{
+	cpacket packet(size);
+	cmd_done_t done;
+
+	packet.set_cmd(cmd);
+	packet.set_sensor(ACCELEROMETER_SENSOR);
+	memcpy(packet.data(), payload, size);
+
+	return transact(fd, packet, CMD_DONE, &done, sizeof(done));
+}
+
+static bool greet(int fd)
+{
+	cpacket get_id(sizeof(cmd_get_id_t));
+	cmd_get_id_done_t id_done;
+	cmd_hello_t hello;
+
+	get_id.set_cmd(CMD_GET_ID);
+	((cmd_get_id_t *)get_id.data())->pid = getpid();
+
+	if (!transact(fd, get_id, CMD_GET_ID, &id_done, sizeof(id_done)))
+		return false;
+
+	hello.client_id = id_done.client_id;
+	hello.sensor = ACCELEROMETER_SENSOR;
+
+	return send_cmd(fd, CMD_HELLO, &hello, sizeof(hello));
+}
+
+/*
+ * A packet laid out by hand the way a client built before multiplexing
+ * sends it: no sensor in cmd, so the greeted sensor is used
+ */
+static bool send_legacy_cmd(int fd)
+{
+	char buffer[sizeof(packet_header) + sizeof(cmd_set_option_t)];
+	packet_header *header = (packet_header *)buffer;
+	cmd_done_t done;
+
+	header->cmd = CMD_SET_OPTION;
+	header->size = sizeof(cmd_set_option_t);
+	((cmd_set_option_t *)header->data)->option = 0;
+
+	if (send(fd, buffer, sizeof(buffer), MSG_NOSIGNAL) != (ssize_t)sizeof(buffer))
+		return false;
+
+	return recv_reply(fd, CMD_DONE, &done, sizeof(done)) && done.value == 0;
+}
+
+static bool send_batch(int fd)
+{
+	const size_t sub_size = CMD_BATCH_ALIGN(sizeof(packet_header) + sizeof(cmd_set_option_t));
+	cpacket packet(sizeof(cmd_batch_t) + 2 * sub_size);
+	cmd_batch_t *batch;
+	packet_header *sub;
+	char done[sizeof(cmd_batch_done_t) + 2 * sizeof(long)];
+
+	packet.set_cmd(CMD_BATCH);
+	packet.set_sensor(ACCELEROMETER_SENSOR);
+	batch = (cmd_batch_t *)packet.data();
+	batch->cmd_cnt = 2;
+
+	for (int i = 0; i < 2; ++i) {
+		sub = (packet_header *)(batch->data + i * sub_size);
+		sub->cmd = (ACCELEROMETER_SENSOR << PACKET_SENSOR_SHIFT) | CMD_SET_OPTION;
+		sub->size = sizeof(cmd_set_option_t);
+		((cmd_set_option_t *)sub->data)->option = i;
+	}
+
+	return transact(fd, packet, CMD_BATCH, done, sizeof(done));
+}
+
+/*
+ * The caller's packet is reused, so only the first round sizes its
+ * storage
+ */
+static bool send_sensorhub_data(int fd, cpacket &packet)
+{
+	cmd_send_sensorhub_data_t *cmd;
+	cmd_done_t done;
+
+	packet.set_payload_size(sizeof(cmd_send_sensorhub_data_t) + SENSORHUB_DATA_SIZE);
+	packet.set_cmd(CMD_SEND_SENSORHUB_DATA);
+	packet.set_sensor(ACCELEROMETER_SENSOR);
+	cmd = (cmd_send_sensorhub_data_t *)packet.data();
+	cmd->data_len = SENSORHUB_DATA_SIZE;
+	memset(cmd->data, 0, SENSORHUB_DATA_SIZE);
+
+	return transact(fd, packet, CMD_DONE, &done, sizeof(done));
+}
+
+static bool send_get_data(int fd, unsigned int type)
+{
+	cpacket packet(sizeof(cmd_get_data_t));
+
+	packet.set_cmd(CMD_GET_DATA);
+	packet.set_sensor(ACCELEROMETER_SENSOR);
+	((cmd_get_data_t *)packet.data())->type = type;
+
+	return send(fd, packet.packet(), packet.size(), MSG_NOSIGNAL) == (ssize_t)packet.size();
+}
+
+// A type the accelerometer doesn't report, answered with an error at once
+static bool get_data(int fd)
+{
+	cmd_get_data_done_t done;
+
+	return send_get_data(fd, ACCELEROMETER_BASE_DATA_SET + 1) &&
+		recv_reply(fd, CMD_GET_DATA, &done, sizeof(done));
+}
+
+static bool run_round(int fd, cpacket &sensorhub_packet, int round)
+{
+	cmd_set_option_t option;
+	cmd_set_command_t command;
+
+	option.option = round & 1;
+	command.cmd = 0;
+	command.value = round;
+
+	return send_cmd(fd, CMD_SET_OPTION, &option, sizeof(option)) &&
+		send_cmd(fd, CMD_SET_COMMAND, &command, sizeof(command)) &&
+		send_batch(fd) &&
+		send_sensorhub_data(fd, sensorhub_packet) &&
+		get_data(fd);
+}
+
+static int connect_client(creactor *reactor)
+{
+	command_worker *worker;
+	int fds[2];
+
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds))
+		return -1;
+
+	worker = new command_worker(csocket(fds[0]));
+
+	if (!worker->start(*reactor)) {
+		delete worker;
+		close(fds[1]);
+		return -1;
+	}
+
+	if (!greet(fds[1])) {
+		close(fds[1]);
+		return -1;
+	}
+
+	return fds[1];
+}
+
+/*
+ * Issues CMD_GET_DATA for the accelerometer's own type on every waiting
+ * connection, runs rounds on fd meanwhile, and returns the replies. With
+ * event_time, an event with that timestamp is pushed to the dispatcher
+ * once the requests are pending.
+ */
+static bool get_data_later(int fd, int *waiting_fds, unsigned long long event_time,
+	cmd_get_data_done_t *replies, unsigned long long &round_ns, unsigned long long &reply_ns)
+{
+	cpacket sensorhub_packet;
+	unsigned long long start;
+	bool ok = true;
+
+	start = now_ns();
+
+	for (int i = 0; i < WAITING_CLIENT_CNT; ++i)
+		ok = ok && send_get_data(waiting_fds[i], ACCELEROMETER_BASE_DATA_SET);
+
+	ok = ok && run_round(fd, sensorhub_packet, 0);
+	round_ns = now_ns() - start;
+
+	if (event_time) {
+		sensor_event_t event;
+
+		usleep(EVENT_DELAY_US);
+
+		memset(&event, 0, sizeof(event));
+		event.event_type = ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME;
+		event.sensor_id = sensor_plugin_loader::get_instance().get_sensor(ACCELEROMETER_SENSOR)->get_id();
+		event.data.timestamp = event_time;
+		event.data.value_count = 3;
+		event.data.values[2] = 9.8f;
+		csensor_event_queue::get_instance().push(event);
+	}
+
+	for (int i = 0; i < WAITING_CLIENT_CNT; ++i)
+		ok = ok && recv_reply(waiting_fds[i], CMD_GET_DATA, &replies[i], sizeof(replies[i]));
+
+	reply_ns = now_ns() - start;
+	return ok;
+}
+
+int main(int argc, char *argv[])
+{
+	creactor *reactor;
+	cpacket sensorhub_packet;
+	cmd_get_data_done_t replies[WAITING_CLIENT_CNT];
+	int waiting_fds[WAITING_CLIENT_CNT];
+	unsigned long long start, start_alloc_cnt;
+	unsigned long long elapsed, allocs;
+	unsigned long long round_ns, reply_ns;
+	const unsigned long long EVENT_TIME = 123456789ULL;
+	int fd;
+	bool ok = true;
+
+	sensor_plugin_loader::get_instance().load_plugins();
+	CHECK(sensor_plugin_loader::get_instance().get_sensor(ACCELEROMETER_SENSOR), "replay accelerometer is not loaded");
+
+	command_worker::init();
+
+	// Leaked on purpose: its detached threads wait on it until exit
+	reactor = new creactor;
+
+	CHECK(reactor->start(REACTOR_THREAD_CNT, REACTOR_WORKER_CNT), "reactor failed to start");
+	CHECK(csensor_event_dispatcher::get_instance().run(*reactor), "event dispatcher failed to start");
+
+	if (check_failures)
+		return test_result("command_packet_test");
+
+	fd = connect_client(reactor);
+	CHECK(fd >= 0, "failed to greet the replay accelerometer");
+
+	for (int i = 0; i < WAITING_CLIENT_CNT; ++i) {
+		waiting_fds[i] = connect_client(reactor);
+		CHECK(waiting_fds[i] >= 0, "failed to greet the replay accelerometer");
+	}
+
+	if (check_failures)
+		return test_result("command_packet_test");
+
+	CHECK(send_legacy_cmd(fd), "a packet without a sensor in cmd was not served");
+
+	for (int i = 0; ok && i < WARMUP_ROUNDS; ++i)
+		ok = run_round(fd, sensorhub_packet, i);
+
+	start_alloc_cnt = get_alloc_cnt();
+	start = now_ns();
+
+	for (int i = 0; ok && i < ROUNDS; ++i)
+		ok = run_round(fd, sensorhub_packet, i);
+
+	elapsed = now_ns() - start;
+	allocs = get_alloc_cnt() - start_alloc_cnt;
+
+	CHECK(ok, "a command failed");
+
+	printf("%d rounds of 5 commands: %.1f us/command, %llu allocations\n", ROUNDS,
+		(double)elapsed / (ROUNDS * 5) / 1000, allocs);
+
+	CHECK(!allocs, "%llu allocations on the steady command path", allocs);
+
+	// No sample arrives: answered without data once the wait is over
+	CHECK(get_data_later(fd, waiting_fds, 0, replies, round_ns, reply_ns),
+		"CMD_GET_DATA failed to time out");
+
+	printf("%d CMD_GET_DATA timed out after %llu ms, a round beside them took %llu us\n",
+		WAITING_CLIENT_CNT, reply_ns / 1000000, round_ns / 1000);
+
+	for (int i = 0; i < WAITING_CLIENT_CNT; ++i)
+		CHECK(replies[i].state == -1, "CMD_GET_DATA #%d got state %d without a sample", i, replies[i].state);
+
+	CHECK(reply_ns >= GET_DATA_WAIT_TIME_NS, "CMD_GET_DATA gave up after %llu ms", reply_ns / 1000000);
+	CHECK(reply_ns < 2 * GET_DATA_WAIT_TIME_NS, "CMD_GET_DATA timed out after %llu ms", reply_ns / 1000000);
+	CHECK(round_ns < GET_DATA_WAIT_TIME_NS / 2, "a round waited %llu ms behind CMD_GET_DATA", round_ns / 1000000);
+
+	// The next event recorded answers all of them
+	CHECK(get_data_later(fd, waiting_fds, EVENT_TIME, replies, round_ns, reply_ns),
+		"CMD_GET_DATA failed to get the next event");
+
+	printf("%d CMD_GET_DATA answered by an event after %llu ms, a round beside them took %llu us\n",
+		WAITING_CLIENT_CNT, reply_ns / 1000000, round_ns / 1000);
+
+	for (int i = 0; i < WAITING_CLIENT_CNT; ++i) {
+		CHECK(!replies[i].state && replies[i].base_data.timestamp == EVENT_TIME,
+			"CMD_GET_DATA #%d got state %d, timestamp %llu instead of the event", i,
+			replies[i].state, replies[i].base_data.timestamp);
+	}
+
+	CHECK(reply_ns < GET_DATA_WAIT_TIME_NS, "CMD_GET_DATA took %llu ms to get the event", reply_ns / 1000000);
+	CHECK(round_ns < GET_DATA_WAIT_TIME_NS / 2, "a round waited %llu ms behind CMD_GET_DATA", round_ns / 1000000);
+
+	// The workers delete themselves once the reactor sees the hang-ups
+	close(fd);
+
+	for (int i = 0; i < WAITING_CLIENT_CNT; ++i)
+		close(waiting_fds[i]);
+
+	return test_result("command_packet_test");
+}
@@ -0,0 +1,105 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <csensor_event_queue.h>
+#include <sensor_accel.h>
+#include <sensor_context.h>
+#include <string.h>
+#include <bench_util.h>
+#include <alloc_counter.h>
+
+/*
+ * Checks that queued events are served from the queue's pools without
+ * touching the heap once the pools exist, and that the pool stats report
+ * occupancy, high-water marks and heap fallbacks.
+ */
+
+static const int ROUNDS = 10000;
+static const int BURST = 32;
+static const int LARGE_HUB_POOL_SIZE = 4;
+
+static void make_hub_event(sensorhub_event_t &event, int hub_data_size)
+{
+	memset(&event, 0, sizeof(event));
+	event.event_type = CONTEXT_EVENT_REPORT;
+	event.data.hub_data_size = hub_data_size;
+}
+
+int main(void)
+{
+	csensor_event_queue &event_queue = csensor_event_queue::get_instance();
+	static sensorhub_event_t small_hub_event, large_hub_event;
+	sensor_event_t event;
+	event_pool_stats_t sensor_stats, small_stats, large_stats;
+
+	memset(&event, 0, sizeof(event));
+	event.event_type = ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME;
+	make_hub_event(small_hub_event, 40);
+	make_hub_event(large_hub_event, SENSOR_HUB_DATA_SIZE);
+
+	unsigned long long start_alloc_cnt = get_alloc_cnt();
+	unsigned long long start = now_ns();
+
+	for (int i = 0; i < ROUNDS; ++i) {
+		for (int j = 0; j < BURST; ++j)
+			event_queue.push(event);
+
+		event_queue.push(small_hub_event);
+		event_queue.push(large_hub_event);
+
+		for (int j = 0; j < BURST + 2; ++j)
+			event_queue.release(event_queue.pop());
+	}
+
+	unsigned long long elapsed = now_ns() - start;
+	unsigned long long steady_alloc_cnt = get_alloc_cnt() - start_alloc_cnt;
+
+	printf("%d events through the queue, %.1f ns per push+pop, %llu heap allocations\n",
+		ROUNDS * (BURST + 2), (double)elapsed / (ROUNDS * (BURST + 2)), steady_alloc_cnt);
+	CHECK(steady_alloc_cnt == 0, "steady state allocated %llu times", steady_alloc_cnt);
+
+	event_queue.get_pool_stats(sensor_stats, small_stats, large_stats);
+	CHECK(sensor_stats.in_use == 0 && small_stats.in_use == 0 && large_stats.in_use == 0,
+		"events still in use: %d/%d/%d", sensor_stats.in_use, small_stats.in_use, large_stats.in_use);
+	CHECK(sensor_stats.high_water == BURST, "sensor pool high water %d, expected %d", sensor_stats.high_water, BURST);
+	CHECK(small_stats.high_water == 1 && large_stats.high_water == 1,
+		"sensorhub pool high water %d/%d, expected 1/1", small_stats.high_water, large_stats.high_water);
+	CHECK(sensor_stats.fallback_cnt == 0 && small_stats.fallback_cnt == 0 && large_stats.fallback_cnt == 0,
+		"unexpected heap fallback %d/%d/%d", sensor_stats.fallback_cnt, small_stats.fallback_cnt, large_stats.fallback_cnt);
+	CHECK(small_stats.event_size < large_stats.event_size, "small sensorhub events are not trimmed (%d >= %d)",
+		(int)small_stats.event_size, (int)large_stats.event_size);
+
+	/* Overflowing a pool falls back to the heap and shows up in the stats */
+	for (int i = 0; i < LARGE_HUB_POOL_SIZE + 2; ++i)
+		event_queue.push(large_hub_event);
+
+	event_queue.get_pool_stats(sensor_stats, small_stats, large_stats);
+	CHECK(large_stats.in_use == LARGE_HUB_POOL_SIZE + 2, "large sensorhub pool in use %d", large_stats.in_use);
+	CHECK(large_stats.high_water == LARGE_HUB_POOL_SIZE + 2, "large sensorhub pool high water %d", large_stats.high_water);
+	CHECK(large_stats.fallback_cnt == 2, "large sensorhub pool fallback %d, expected 2", large_stats.fallback_cnt);
+
+	for (int i = 0; i < LARGE_HUB_POOL_SIZE + 2; ++i)
+		event_queue.release(event_queue.pop());
+
+	event_queue.print_pool_stats();
+	event_queue.get_pool_stats(sensor_stats, small_stats, large_stats);
+	CHECK(large_stats.in_use == 0, "large sensorhub pool in use %d after release", large_stats.in_use);
+
+	return test_result("event_pool_test");
+}
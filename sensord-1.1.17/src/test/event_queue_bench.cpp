@@ -0,0 +1,224 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <csensor_event_queue.h>
+#include <sensor_accel.h>
+#include <sched.h>
+#include <string.h>
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <bench_util.h>
+
+using std::queue;
+using std::mutex;
+using std::thread;
+using std::vector;
+
+/*
+ * Pushes events from several producer threads into one consumer, the way
+ * the pollers and virtual sensors feed the dispatcher, and reports push and
+ * pop cost plus push-to-pop latency for the MPSC ring and for the locked
+ * std::queue it replaced. The cost of a push/pop pair on one thread is
+ * reported too, since on a loaded single core the threaded numbers are
+ * mostly scheduling. Per-producer FIFO order and the event count are
+ * checked for both.
+ */
+
+static const int PRODUCER_CNT = 4;
+static const int EVENTS_PER_PRODUCER = 50000;
+static const int MAX_IN_FLIGHT = 64;
+static const int UNCONTENDED_EVENTS = 200000;
+
+/* The previous csensor_event_queue: one mutex, a condition variable and a heap event per push */
+class locked_event_queue
+{
+public:
+	void push(sensor_event_t const &event)
+	{
+		sensor_event_t *new_event = new(std::nothrow) sensor_event_t;
+		*new_event = event;
+
+		std::lock_guard<mutex> l(m_mutex);
+		bool wake = m_queue.empty();
+
+		if (m_queue.size() >= QUEUE_FULL_SIZE)
+			delete new_event;
+		else
+			m_queue.push(new_event);
+
+		if (wake)
+			m_cond_var.notify_one();
+	}
+
+	void* pop(void)
+	{
+		std::unique_lock<mutex> u(m_mutex);
+
+		while (m_queue.empty())
+			m_cond_var.wait(u);
+
+		void *event = m_queue.front();
+		m_queue.pop();
+		return event;
+	}
+
+	void release(void *event)
+	{
+		delete (sensor_event_t *)event;
+	}
+private:
+	static const unsigned int QUEUE_FULL_SIZE = 1000;
+
+	queue<void *> m_queue;
+	mutex m_mutex;
+	std::condition_variable m_cond_var;
+};
+
+struct bench_result {
+	double push_mean_ns;
+	unsigned long long push_p99_ns;
+	double pop_mean_ns;
+	unsigned long long latency_p50_ns;
+	unsigned long long latency_p99_ns;
+	unsigned long long latency_p999_ns;
+	unsigned long long latency_max_ns;
+};
+
+template <typename QUEUE>
+static void produce(QUEUE &event_queue, int producer_id, atomic<int> &in_flight, vector<unsigned long long> &push_cost)
+{
+	sensor_event_t event;
+
+	memset(&event, 0, sizeof(event));
+	event.event_type = ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME;
+	event.sensor_id = producer_id;
+
+	for (int i = 0; i < EVENTS_PER_PRODUCER; ++i) {
+		while (in_flight.load(std::memory_order_relaxed) >= MAX_IN_FLIGHT)
+			sched_yield();
+
+		in_flight.fetch_add(1, std::memory_order_relaxed);
+		event.data.accuracy = i;
+
+		unsigned long long start = now_ns();
+		event.data.timestamp = start;
+		event_queue.push(event);
+		push_cost[i] = now_ns() - start;
+	}
+}
+
+template <typename QUEUE>
+static bench_result run(QUEUE &event_queue, const char *name)
+{
+	const int total = PRODUCER_CNT * EVENTS_PER_PRODUCER;
+	atomic<int> in_flight(0);
+	vector<vector<unsigned long long> > push_cost(PRODUCER_CNT, vector<unsigned long long>(EVENTS_PER_PRODUCER));
+	vector<unsigned long long> latency(total);
+	vector<unsigned long long> all_push_cost;
+	int next_seq[PRODUCER_CNT] = {0, };
+	unsigned long long pop_total = 0;
+	vector<thread> producers;
+	bench_result result;
+
+	for (int i = 0; i < PRODUCER_CNT; ++i)
+		producers.push_back(thread(produce<QUEUE>, std::ref(event_queue), i, std::ref(in_flight), std::ref(push_cost[i])));
+
+	for (int i = 0; i < total; ++i) {
+		unsigned long long start = now_ns();
+		sensor_event_t *event = (sensor_event_t *)event_queue.pop();
+		unsigned long long end = now_ns();
+
+		pop_total += end - start;
+		latency[i] = end - event->data.timestamp;
+
+		CHECK(event->sensor_id < PRODUCER_CNT, "%s: unknown producer %d", name, (int)event->sensor_id);
+		if (event->sensor_id < PRODUCER_CNT) {
+			CHECK(event->data.accuracy == next_seq[event->sensor_id], "%s: producer %d out of order, got %d expected %d",
+				name, (int)event->sensor_id, event->data.accuracy, next_seq[event->sensor_id]);
+			next_seq[event->sensor_id] = event->data.accuracy + 1;
+		}
+
+		event_queue.release(event);
+		in_flight.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	for (int i = 0; i < PRODUCER_CNT; ++i) {
+		producers[i].join();
+		CHECK(next_seq[i] == EVENTS_PER_PRODUCER, "%s: producer %d delivered %d of %d events",
+			name, i, next_seq[i], EVENTS_PER_PRODUCER);
+		all_push_cost.insert(all_push_cost.end(), push_cost[i].begin(), push_cost[i].end());
+	}
+
+	unsigned long long push_total = 0;
+
+	for (size_t i = 0; i < all_push_cost.size(); ++i)
+		push_total += all_push_cost[i];
+
+	result.push_mean_ns = (double)push_total / total;
+	result.push_p99_ns = percentile(all_push_cost, 0.99);
+	result.pop_mean_ns = (double)pop_total / total;
+	result.latency_p50_ns = percentile(latency, 0.5);
+	result.latency_p99_ns = percentile(latency, 0.99);
+	result.latency_p999_ns = percentile(latency, 0.999);
+	result.latency_max_ns = percentile(latency, 1.0);
+
+	return result;
+}
+
+template <typename QUEUE>
+static double run_uncontended(QUEUE &event_queue)
+{
+	sensor_event_t event;
+
+	memset(&event, 0, sizeof(event));
+	event.event_type = ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME;
+
+	unsigned long long start = now_ns();
+
+	for (int i = 0; i < UNCONTENDED_EVENTS; ++i) {
+		event_queue.push(event);
+		event_queue.release(event_queue.pop());
+	}
+
+	return (double)(now_ns() - start) / UNCONTENDED_EVENTS;
+}
+
+static void print_result(const char *name, const bench_result &result)
+{
+	printf("%-14s push %7.1f ns (p99 %6llu) | pop %7.1f ns | latency p50 %7llu p99 %8llu p99.9 %8llu max %9llu ns\n",
+		name, result.push_mean_ns, result.push_p99_ns, result.pop_mean_ns,
+		result.latency_p50_ns, result.latency_p99_ns, result.latency_p999_ns, result.latency_max_ns);
+}
+
+int main(void)
+{
+	locked_event_queue locked_queue;
+
+	printf("%d producers x %d events, at most %d in flight\n", PRODUCER_CNT, EVENTS_PER_PRODUCER, MAX_IN_FLIGHT);
+
+	print_result("locked queue", run(locked_queue, "locked queue"));
+	print_result("mpsc ring", run(csensor_event_queue::get_instance(), "mpsc ring"));
+
+	printf("uncontended push+pop: locked queue %.1f ns, mpsc ring %.1f ns\n",
+		run_uncontended(locked_queue), run_uncontended(csensor_event_queue::get_instance()));
+
+	return test_result("event_queue_bench");
+}
@@ -0,0 +1,219 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <euler_angles.h>
+#include <rotation_matrix.h>
+#include <quaternion.h>
+#include <fast_math.h>
+#include <bench_util.h>
+
+/*
+ * Checks the fast-math approximations against double-precision libm over
+ * their documented input ranges, holding each to the worst-case error
+ * documented in fast_math.h, and the conversions built on them against
+ * libm references on random attitudes. Reports ns per call of each
+ * approximation next to the float libm call it replaces.
+ */
+
+static const int SWEEP_POINTS = 200000;
+static const int ATTITUDE_CNT = 20000;
+static const int BENCH_SIZE = 4096;
+static const int BENCH_ROUNDS = 200;
+
+static const double RSQRT_BOUND = 2.5e-7;
+static const double ATAN2_BOUND = 1.2e-5;
+static const double ASIN_BOUND = 6.8e-5;
+static const double SIN_COS_BOUND = 3.7e-6;
+
+/* On top of an approximation's own bound, float rounding of the surrounding arithmetic */
+static const double CONVERSION_SLACK = 2e-6;
+
+/* Evaluated by the compiler; checked against the same calls at run time */
+static constexpr float CONST_SIN = fast_sin(2.5f);
+static constexpr float CONST_COS = fast_cos(-1.0f);
+static constexpr float CONST_ATAN = fast_atan(0.75f);
+
+static void check_bound(const char *name, double max_error, double bound)
+{
+	printf("%-12s max error %.3g (bound %.3g)\n", name, max_error, bound);
+	CHECK(max_error <= bound, "%s error %.3g over documented bound %.3g", name, max_error, bound);
+}
+
+static void check_functions(void)
+{
+	double rsqrt_err = 0, atan2_err = 0, asin_err = 0, sin_err = 0, cos_err = 0;
+
+	for (int i = 0; i <= SWEEP_POINTS; ++i) {
+		double t = (double)i / SWEEP_POINTS;
+
+		float x = (float)pow(10.0, -4 + 8 * t);
+		rsqrt_err = std::max(rsqrt_err, fabs(fast_rsqrt(x) * sqrt((double)x) - 1));
+
+		float angle = (float)(-M_PI + 2 * M_PI * t);
+		float radius = (float)(0.01 + 100 * t * t);
+		float y = radius * sin(angle), xx = radius * cos(angle);
+		atan2_err = std::max(atan2_err, fabs(fast_atan2(y, xx) - atan2((double)y, (double)xx)));
+
+		float s = (float)(-1 + 2 * t);
+		asin_err = std::max(asin_err, fabs(fast_asin(s) - asin((double)s)));
+
+		float a = (float)(-2 * M_PI + 4 * M_PI * t);
+		sin_err = std::max(sin_err, fabs(fast_sin(a) - sin((double)a)));
+		cos_err = std::max(cos_err, fabs(fast_cos(a) - cos((double)a)));
+	}
+
+	check_bound("fast_rsqrt", rsqrt_err, RSQRT_BOUND);
+	check_bound("fast_atan2", atan2_err, ATAN2_BOUND);
+	check_bound("fast_asin", asin_err, ASIN_BOUND);
+	check_bound("fast_sin", sin_err, SIN_COS_BOUND);
+	check_bound("fast_cos", cos_err, SIN_COS_BOUND);
+
+	volatile float sin_in = 2.5f, cos_in = -1.0f, atan_in = 0.75f;
+
+	CHECK(CONST_SIN == fast_sin((float)sin_in) && CONST_COS == fast_cos((float)cos_in) &&
+		CONST_ATAN == fast_atan((float)atan_in), "compile-time evaluation differs from the run-time one");
+}
+
+static quaternion<float> random_attitude(unsigned int &seed)
+{
+	double v[4], norm = 0;
+
+	for (int i = 0; i < 4; ++i) {
+		seed = seed * 1103515245 + 12345;
+		v[i] = ((seed >> 8) & 0xFFFF) / 32767.5 - 1.0;
+		norm += v[i] * v[i];
+	}
+
+	norm = sqrt(norm);
+
+	return quaternion<float>(v[0] / norm, v[1] / norm, v[2] / norm, v[3] / norm);
+}
+
+static void check_conversions(void)
+{
+	const float G = 9.80665f;
+	unsigned int seed = 5;
+	double euler_err = 0, norm_err = 0, round_trip_err = 0, gravity_err = 0;
+
+	for (int i = 0; i < ATTITUDE_CNT; ++i) {
+		quaternion<float> q = random_attitude(seed);
+		double w = q.m_quat.m_vec[0], x = q.m_quat.m_vec[1], y = q.m_quat.m_vec[2], z = q.m_quat.m_vec[3];
+
+		/* Same rotation matrix terms as quat2euler, in double with libm */
+		double r11 = 2 * (w * w) - 1 + 2 * (x * x);
+		double r21 = 2 * ((x * y) - (w * z));
+		double r31 = 2 * ((x * z) + (w * y));
+		double r32 = 2 * ((y * z) - (w * x));
+		double r33 = 2 * (w * w) - 1 + 2 * (z * z);
+		double phi = atan2(r32, r33);
+		double theta = atan2(-r31, sqrt(r32 * r32 + r33 * r33));
+		double psi = atan2(r21, r11);
+
+		euler_angles<float> e = quat2euler(q);
+		euler_err = std::max(euler_err, fabs(e.m_ang.m_vec[0] - phi));
+		euler_err = std::max(euler_err, fabs(e.m_ang.m_vec[1] - theta));
+		euler_err = std::max(euler_err, fabs(e.m_ang.m_vec[2] - psi));
+
+		/* The direct gravity path against gravity rebuilt from the libm Euler angles */
+		vect<float, 3> gravity = quat2gravity(q, G);
+		double ref_gravity[3] = {-G * sin(theta), G * cos(theta) * sin(phi), G * cos(theta) * cos(phi)};
+
+		for (int j = 0; j < 3; ++j)
+			gravity_err = std::max(gravity_err, fabs(gravity.m_vec[j] - ref_gravity[j]) / G);
+
+		quaternion<float> scaled = q * 3.5f;
+		scaled.quat_normalize();
+
+		double norm = 0;
+
+		for (int j = 0; j < 4; ++j)
+			norm += (double)scaled.m_quat.m_vec[j] * scaled.m_quat.m_vec[j];
+
+		norm_err = std::max(norm_err, fabs(sqrt(norm) - 1));
+
+		/*
+		 * quat2rot_mat() builds the transpose of the matrix rot_mat2quat()
+		 * reads, so the round trip yields the conjugate attitude
+		 */
+		quaternion<float> back = rot_mat2quat(quat2rot_mat(q));
+		double sign = (back.m_quat.m_vec[0] * w < 0) ? -1 : 1;
+		double conj[4] = {w, -x, -y, -z};
+
+		for (int j = 0; j < 4; ++j)
+			round_trip_err = std::max(round_trip_err, fabs(sign * back.m_quat.m_vec[j] - conj[j]));
+	}
+
+	check_bound("quat2euler", euler_err, ATAN2_BOUND + CONVERSION_SLACK);
+	check_bound("quat2gravity", gravity_err, CONVERSION_SLACK);
+	check_bound("normalize", norm_err, RSQRT_BOUND + CONVERSION_SLACK);
+	check_bound("rot round trip", round_trip_err, RSQRT_BOUND + 4 * CONVERSION_SLACK);
+}
+
+static float bench_in[BENCH_SIZE], bench_in2[BENCH_SIZE];
+static volatile float bench_sink;
+
+#define BENCH(name, expr) \
+	do { \
+		float sum = 0; \
+		unsigned long long start = now_ns(); \
+		for (int r = 0; r < BENCH_ROUNDS; ++r) \
+			for (int i = 0; i < BENCH_SIZE; ++i) { \
+				float a = bench_in[i], b = bench_in2[i]; \
+				sum += (expr); \
+				(void)a; \
+				(void)b; \
+			} \
+		bench_sink = sum; \
+		name = (double)(now_ns() - start) / (BENCH_ROUNDS * BENCH_SIZE); \
+	} while (0)
+
+static void bench_functions(void)
+{
+	double fast_ns, libm_ns;
+
+	for (int i = 0; i < BENCH_SIZE; ++i) {
+		bench_in[i] = (float)((i + 0.5) / BENCH_SIZE * 2 - 1);
+		bench_in2[i] = (float)(0.1 + (i % 97) / 10.0);
+	}
+
+	BENCH(fast_ns, fast_atan2(a, b));
+	BENCH(libm_ns, atan2f(a, b));
+	printf("atan2  fast %5.2f ns, libm %5.2f ns\n", fast_ns, libm_ns);
+
+	BENCH(fast_ns, fast_asin(a));
+	BENCH(libm_ns, asinf(a));
+	printf("asin   fast %5.2f ns, libm %5.2f ns\n", fast_ns, libm_ns);
+
+	BENCH(fast_ns, fast_sin(a * 6));
+	BENCH(libm_ns, sinf(a * 6));
+	printf("sin    fast %5.2f ns, libm %5.2f ns\n", fast_ns, libm_ns);
+
+	BENCH(fast_ns, fast_rsqrt(b));
+	BENCH(libm_ns, 1.0f / sqrtf(b));
+	printf("rsqrt  fast %5.2f ns, libm %5.2f ns\n", fast_ns, libm_ns);
+}
+
+int main(void)
+{
+	check_functions();
+	check_conversions();
+	bench_functions();
+
+	return test_result("fast_math_test");
+}
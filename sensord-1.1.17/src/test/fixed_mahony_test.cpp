@@ -0,0 +1,140 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <mahony_filter.h>
+#include <fixed_point.h>
+#include <bench_util.h>
+#include <motion_trace.h>
+
+/*
+ * Runs mahony_filter<fixed_q16_t> next to mahony_filter<float> on the same
+ * trace, converting the inputs the way fusion_sensor does, and holds the
+ * angle between the two to the error budget documented in fixed_point.h,
+ * at 100 Hz and over an hour at 10 Hz. Reports the CPU cost per sample of
+ * both instantiations; on a core with a hardware FPU the float one is
+ * expected to win, so the cost is printed but not checked.
+ */
+
+static const int SETTLE_SAMPLES = 50;
+static const int TIMING_REPEAT = 5;
+static const double FIXED_MEAN_ERROR_BUDGET = 0.04;
+static const double FIXED_MAX_ERROR_BUDGET = 0.7;
+
+static sensor_data<fixed_q16_t> to_fixed(const sensor_data<float> &data)
+{
+	sensor_data<fixed_q16_t> fixed(data.m_data.m_vec[0], data.m_data.m_vec[1],
+			data.m_data.m_vec[2], data.m_time_stamp);
+
+	return fixed;
+}
+
+static quaternion<float> to_float(const quaternion<fixed_q16_t> &quat)
+{
+	return quaternion<float>(quat.m_quat.m_vec[0].to_float(), quat.m_quat.m_vec[1].to_float(),
+			quat.m_quat.m_vec[2].to_float(), quat.m_quat.m_vec[3].to_float());
+}
+
+static double run_float(const std::vector<motion_sample_t> &trace, std::vector<quaternion<float> > &quats)
+{
+	sensor_data<float> accel, gyro, magnetic;
+	unsigned long long best = ~0ULL;
+
+	for (int r = 0; r < TIMING_REPEAT; ++r) {
+		mahony_filter<float> filter;
+		unsigned long long start = now_ns();
+
+		for (size_t i = 0; i < trace.size(); ++i) {
+			get_motion_data(trace[i], accel, gyro, magnetic);
+			quats[i] = filter.get_quaternion(accel, gyro, magnetic);
+		}
+
+		best = std::min(best, now_ns() - start);
+	}
+
+	return (double)best / trace.size();
+}
+
+static double run_fixed(const std::vector<motion_sample_t> &trace, std::vector<quaternion<float> > &quats)
+{
+	sensor_data<float> accel, gyro, magnetic;
+	unsigned long long best = ~0ULL;
+
+	for (int r = 0; r < TIMING_REPEAT; ++r) {
+		mahony_filter<fixed_q16_t> filter;
+		unsigned long long start = now_ns();
+
+		for (size_t i = 0; i < trace.size(); ++i) {
+			get_motion_data(trace[i], accel, gyro, magnetic);
+			quats[i] = to_float(filter.get_quaternion(to_fixed(accel), to_fixed(gyro), to_fixed(magnetic)));
+		}
+
+		best = std::min(best, now_ns() - start);
+	}
+
+	return (double)best / trace.size();
+}
+
+static void check_rate(const char *name, const std::vector<motion_sample_t> &trace)
+{
+	std::vector<quaternion<float> > float_quats(trace.size()), fixed_quats(trace.size()), truth;
+
+	for (size_t i = 0; i < trace.size(); ++i)
+		truth.push_back(get_motion_truth(trace[i]));
+
+	double float_ns = run_float(trace, float_quats);
+	double fixed_ns = run_fixed(trace, fixed_quats);
+
+	attitude_error_t diff = get_attitude_error(fixed_quats, float_quats, SETTLE_SAMPLES);
+	attitude_error_t float_error = get_attitude_error(float_quats, truth, SETTLE_SAMPLES);
+
+	/* Error growth: the last tenth of the run against the whole run */
+	std::vector<quaternion<float> > fixed_tail(fixed_quats.end() - trace.size() / 10, fixed_quats.end());
+	std::vector<quaternion<float> > float_tail(float_quats.end() - trace.size() / 10, float_quats.end());
+	attitude_error_t tail_diff = get_attitude_error(fixed_tail, float_tail, 0);
+
+	printf("%s, %zu samples: float %.1f ns/sample, q16.16 %.1f ns/sample\n", name, trace.size(), float_ns, fixed_ns);
+	printf("  q16.16 vs float mean %.4f, p95 %.4f, max %.4f deg (last tenth mean %.4f)\n",
+		diff.mean, diff.p95, diff.max, tail_diff.mean);
+	printf("  float vs truth  mean %.3f, max %.3f deg\n", float_error.mean, float_error.max);
+
+	CHECK(diff.mean <= FIXED_MEAN_ERROR_BUDGET, "%s: q16.16 mean error %.4f deg over budget %.2f",
+		name, diff.mean, FIXED_MEAN_ERROR_BUDGET);
+	CHECK(tail_diff.mean <= FIXED_MEAN_ERROR_BUDGET, "%s: q16.16 mean error %.4f deg over budget %.2f at the end of the run",
+		name, tail_diff.mean, FIXED_MEAN_ERROR_BUDGET);
+	CHECK(diff.max <= FIXED_MAX_ERROR_BUDGET, "%s: q16.16 worst error %.4f deg over budget %.1f",
+		name, diff.max, FIXED_MAX_ERROR_BUDGET);
+}
+
+int main(void)
+{
+	std::vector<motion_sample_t> trace, slow_trace;
+
+	make_motion_trace(trace, 6000, 2);
+	check_rate("100 Hz", trace);
+
+	/* An hour at 10 Hz: every tenth sample of a 100 Hz trace */
+	make_motion_trace(trace, 360000, 3);
+
+	for (size_t i = 0; i < trace.size(); i += 10)
+		slow_trace.push_back(trace[i]);
+
+	check_rate("10 Hz", slow_trace);
+
+	return test_result("fixed_mahony_test");
+}
@@ -0,0 +1,147 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <orientation_filter.h>
+#include <mahony_filter.h>
+#include <string.h>
+#include <bench_util.h>
+#include <motion_trace.h>
+
+/*
+ * Feeds the same trace through the per-sample get_quaternion() and
+ * get_orientation() calls and through get_orientation_batch() in FIFO-sized
+ * bursts, for both fusion engines. The batch results must be bit-identical
+ * to the per-sample ones. Reports the throughput of each in samples/s,
+ * and of batches that only ask for quaternions.
+ * Accel is held for two gyro samples and magnetic for five, as with
+ * sensors running below the gyro rate.
+ */
+
+static const int TRACE_SAMPLES = 60000;
+static const int BURST = 32;
+static const int ACCEL_DIVIDER = 2;
+static const int MAGNETIC_DIVIDER = 5;
+static const int TIMING_REPEAT = 3;
+
+struct sample_arrays {
+	std::vector<sensor_data<float> > accel;
+	std::vector<sensor_data<float> > gyro;
+	std::vector<sensor_data<float> > magnetic;
+};
+
+static void make_arrays(const std::vector<motion_sample_t> &trace, sample_arrays &arrays)
+{
+	for (size_t i = 0; i < trace.size(); ++i) {
+		sensor_data<float> accel, gyro, magnetic;
+
+		get_motion_data(trace[i], accel, gyro, magnetic);
+
+		if (i % ACCEL_DIVIDER)
+			accel = arrays.accel.back();
+		if (i % MAGNETIC_DIVIDER)
+			magnetic = arrays.magnetic.back();
+
+		arrays.accel.push_back(accel);
+		arrays.gyro.push_back(gyro);
+		arrays.magnetic.push_back(magnetic);
+	}
+}
+
+template <typename FILTER>
+static double run_single(const sample_arrays &arrays, std::vector<quaternion<float> > &quats,
+	std::vector<euler_angles<float> > &orientations)
+{
+	unsigned long long best = ~0ULL;
+
+	for (int r = 0; r < TIMING_REPEAT; ++r) {
+		FILTER filter;
+		unsigned long long start = now_ns();
+
+		for (size_t i = 0; i < arrays.gyro.size(); ++i) {
+			orientations[i] = filter.get_orientation(arrays.accel[i], arrays.gyro[i], arrays.magnetic[i]);
+			quats[i] = filter.m_quaternion;
+		}
+
+		best = std::min(best, now_ns() - start);
+	}
+
+	return arrays.gyro.size() * 1000000000.0 / best;
+}
+
+template <typename FILTER>
+static double run_batch(const sample_arrays &arrays, std::vector<quaternion<float> > &quats,
+	euler_angles<float> *orientations)
+{
+	unsigned long long best = ~0ULL;
+	int count = arrays.gyro.size();
+
+	for (int r = 0; r < TIMING_REPEAT; ++r) {
+		FILTER filter;
+		unsigned long long start = now_ns();
+
+		for (int i = 0; i < count; i += BURST) {
+			filter.get_orientation_batch(&arrays.accel[i], &arrays.gyro[i], &arrays.magnetic[i],
+				std::min(BURST, count - i), &quats[i], orientations ? &orientations[i] : NULL);
+		}
+
+		best = std::min(best, now_ns() - start);
+	}
+
+	return count * 1000000000.0 / best;
+}
+
+template <typename FILTER>
+static void check_engine(const char *name, const sample_arrays &arrays)
+{
+	int count = arrays.gyro.size();
+	std::vector<quaternion<float> > single_quats(count), batch_quats(count);
+	std::vector<euler_angles<float> > single_orientations(count), batch_orientations(count);
+	int mismatch_cnt = 0;
+
+	double single_rate = run_single<FILTER>(arrays, single_quats, single_orientations);
+	double quat_rate = run_batch<FILTER>(arrays, batch_quats, NULL);
+	double batch_rate = run_batch<FILTER>(arrays, batch_quats, &batch_orientations[0]);
+
+	for (int i = 0; i < count; ++i) {
+		if (memcmp(single_quats[i].m_quat.m_vec, batch_quats[i].m_quat.m_vec, sizeof(single_quats[i].m_quat.m_vec)) ||
+				memcmp(single_orientations[i].m_ang.m_vec, batch_orientations[i].m_ang.m_vec,
+				sizeof(single_orientations[i].m_ang.m_vec)))
+			++mismatch_cnt;
+	}
+
+	printf("%-7s per sample %6.2f M samples/s, batches of %d %6.2f M samples/s (%.2fx), quaternions only %6.2f M samples/s (%.2fx)\n",
+		name, single_rate / 1000000, BURST, batch_rate / 1000000, batch_rate / single_rate,
+		quat_rate / 1000000, quat_rate / single_rate);
+	CHECK(mismatch_cnt == 0, "%s batch output differs from per-sample output on %d of %d samples",
+		name, mismatch_cnt, count);
+}
+
+int main(void)
+{
+	std::vector<motion_sample_t> trace;
+	sample_arrays arrays;
+
+	make_motion_trace(trace, TRACE_SAMPLES, 2);
+	make_arrays(trace, arrays);
+
+	check_engine<orientation_filter<float> >("kalman", arrays);
+	check_engine<mahony_filter<float> >("mahony", arrays);
+
+	return test_result("fusion_batch_bench");
+}
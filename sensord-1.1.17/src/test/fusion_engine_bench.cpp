@@ -0,0 +1,96 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <orientation_filter.h>
+#include <mahony_filter.h>
+#include <bench_util.h>
+#include <motion_trace.h>
+
+/*
+ * Runs the Kalman orientation_filter and the Mahony filter on the same
+ * accel/gyro/magnetic trace. Reports the CPU cost per sample of each, the
+ * error of each against the true attitude of the trace, and the angle
+ * between the two engines once both have settled. Fails if Mahony is not
+ * cheaper or its error goes over budget.
+ */
+
+static const int TRACE_SAMPLES = 12000;
+static const int SETTLE_SAMPLES = 300;
+static const int TIMING_REPEAT = 5;
+static const double MAHONY_MEAN_ERROR_BUDGET = 3.0;
+static const double MAHONY_MAX_ERROR_BUDGET = 8.0;
+
+template <typename FILTER>
+static double run_filter(const std::vector<motion_sample_t> &trace, std::vector<quaternion<float> > &quats)
+{
+	sensor_data<float> accel, gyro, magnetic;
+	unsigned long long best = ~0ULL;
+
+	/* Best of several fresh runs, to keep scheduling noise out of the per-sample cost */
+	for (int r = 0; r < TIMING_REPEAT; ++r) {
+		FILTER filter;
+		unsigned long long start = now_ns();
+
+		for (size_t i = 0; i < trace.size(); ++i) {
+			get_motion_data(trace[i], accel, gyro, magnetic);
+			quats[i] = filter.get_quaternion(accel, gyro, magnetic);
+		}
+
+		best = std::min(best, now_ns() - start);
+	}
+
+	return (double)best / trace.size();
+}
+
+static void print_error(const char *name, const attitude_error_t &error)
+{
+	printf("%-20s mean %7.3f, p95 %7.3f, max %7.3f deg\n", name, error.mean, error.p95, error.max);
+}
+
+int main(void)
+{
+	std::vector<motion_sample_t> trace;
+	std::vector<quaternion<float> > kalman_quats(TRACE_SAMPLES), mahony_quats(TRACE_SAMPLES), truth;
+
+	make_motion_trace(trace, TRACE_SAMPLES, 1);
+
+	for (int i = 0; i < TRACE_SAMPLES; ++i)
+		truth.push_back(get_motion_truth(trace[i]));
+
+	double kalman_ns = run_filter<orientation_filter<float> >(trace, kalman_quats);
+	double mahony_ns = run_filter<mahony_filter<float> >(trace, mahony_quats);
+
+	attitude_error_t kalman_error = get_attitude_error(kalman_quats, truth, SETTLE_SAMPLES);
+	attitude_error_t mahony_error = get_attitude_error(mahony_quats, truth, SETTLE_SAMPLES);
+	attitude_error_t engine_diff = get_attitude_error(mahony_quats, kalman_quats, SETTLE_SAMPLES);
+
+	printf("%d samples at 100 Hz: kalman %.1f ns/sample, mahony %.1f ns/sample (%.1fx cheaper)\n",
+		TRACE_SAMPLES, kalman_ns, mahony_ns, kalman_ns / mahony_ns);
+	print_error("kalman vs truth", kalman_error);
+	print_error("mahony vs truth", mahony_error);
+	print_error("mahony vs kalman", engine_diff);
+
+	CHECK(mahony_ns < kalman_ns, "mahony costs %.1f ns/sample, kalman %.1f", mahony_ns, kalman_ns);
+	CHECK(mahony_error.mean <= MAHONY_MEAN_ERROR_BUDGET, "mahony mean error %.3f deg over budget %.1f",
+		mahony_error.mean, MAHONY_MEAN_ERROR_BUDGET);
+	CHECK(mahony_error.max <= MAHONY_MAX_ERROR_BUDGET, "mahony max error %.3f deg over budget %.1f",
+		mahony_error.max, MAHONY_MAX_ERROR_BUDGET);
+
+	return test_result("fusion_engine_bench");
+}
@@ -0,0 +1,412 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <sensor_plugin_loader.h>
+#include <csensor_event_dispatcher.h>
+#include <sensor_internal.h>
+#include <string.h>
+#include <string>
+#include <bench_util.h>
+#include <alloc_counter.h>
+#include <motion_trace.h>
+
+/*
+ * Replays an accel/gyro/magnetic trace through the fusion, orientation,
+ * rotation vector, gravity and linear acceleration plugins (and the 6-axis
+ * game rotation vector when built with GAME_RV), loaded and wired the way
+ * sensord does it from the configs under replay/, and
+ * compares every output event against the golden output checked in next
+ * to the trace. Reports the CPU cost and heap allocations of the dispatch
+ * path per trace sample. Fails when an output drifts from its golden
+ * file by more than its budget, or when the cost or allocation budgets
+ * are exceeded.
+ *
+ *   fusion_replay_test --make-trace   regenerates replay/motion.trace
+ *   fusion_replay_test --record       rewrites the golden files from this build
+ */
+
+static const int REPLAY_SAMPLES = 1000;
+static const int REPLAY_CLIENT_ID = 1;
+static const unsigned int REPLAY_INTERVAL_MS = 10;
+static const unsigned int MAX_REPLAY_EVENT = 64;
+static const double NS_PER_SAMPLE_BUDGET = 50000;
+static const double ALLOCS_PER_SAMPLE_BUDGET = 0;
+
+enum replay_metric_t {
+	METRIC_EULER_ANGLE = 0,
+	METRIC_QUAT_ANGLE,
+	METRIC_VECTOR_ANGLE,
+	METRIC_DISTANCE,
+};
+
+typedef struct {
+	unsigned long long timestamp;
+	float values[4];
+} replay_record_t;
+
+typedef struct {
+	const char *name;
+	sensor_type_t type;
+	unsigned int event_type;
+	int value_cnt;
+	replay_metric_t metric;
+	double mean_budget;
+	double max_budget;
+	const char *unit;
+	sensor_base *sensor;
+	std::vector<replay_record_t> records;
+} replay_output_t;
+
+static replay_output_t replay_outputs[] = {
+	{"orientation", ORIENTATION_SENSOR, ORIENTATION_EVENT_RAW_DATA_REPORT_ON_TIME, 3,
+		METRIC_EULER_ANGLE, 0.002, 0.02, "deg"},
+	{"rv", ROTATION_VECTOR_SENSOR, ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME, 4,
+		METRIC_QUAT_ANGLE, 0.002, 0.02, "deg"},
+	{"gravity", GRAVITY_SENSOR, GRAVITY_EVENT_RAW_DATA_REPORT_ON_TIME, 3,
+		METRIC_VECTOR_ANGLE, 0.002, 0.02, "deg"},
+	{"linear_accel", LINEAR_ACCEL_SENSOR, LINEAR_ACCEL_EVENT_RAW_DATA_REPORT_ON_TIME, 3,
+		METRIC_DISTANCE, 0.001, 0.01, "m/s^2"},
+#ifdef REPLAY_GAME_RV
+	{"game_rv", GAME_ROTATION_VECTOR_SENSOR, GAME_ROTATION_VECTOR_EVENT_RAW_DATA_REPORT_ON_TIME, 4,
+		METRIC_QUAT_ANGLE, 0.002, 0.02, "deg"},
+#endif
+};
+
+static const int REPLAY_OUTPUT_CNT = sizeof(replay_outputs) / sizeof(replay_outputs[0]);
+
+static std::string data_path(const char *name, const char *ext)
+{
+	return std::string(REPLAY_DATA_DIR) + "/" + name + ext;
+}
+
+static bool save_trace(const std::vector<motion_sample_t> &trace)
+{
+	std::string path = data_path("motion", ".trace");
+	FILE *fp = fopen(path.c_str(), "w");
+
+	if (!fp)
+		return false;
+
+	fprintf(fp, "# timestamp(us) accel(m/s^2) gyro(rad/s / PI^2) magnetic(uT) true attitude(w x y z)\n");
+
+	for (size_t i = 0; i < trace.size(); ++i) {
+		const motion_sample_t &s = trace[i];
+
+		fprintf(fp, "%llu %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n", s.timestamp,
+			s.accel[0], s.accel[1], s.accel[2], s.gyro[0], s.gyro[1], s.gyro[2],
+			s.magnetic[0], s.magnetic[1], s.magnetic[2], s.truth[0], s.truth[1], s.truth[2], s.truth[3]);
+	}
+
+	fclose(fp);
+	return true;
+}
+
+static bool load_trace(std::vector<motion_sample_t> &trace)
+{
+	return load_motion_trace(data_path("motion", ".trace").c_str(), trace);
+}
+
+static bool save_golden(const replay_output_t &output)
+{
+	std::string path = data_path(output.name, ".golden");
+	FILE *fp = fopen(path.c_str(), "w");
+
+	if (!fp)
+		return false;
+
+	fprintf(fp, "# timestamp(us) values of %s\n", output.name);
+
+	for (size_t i = 0; i < output.records.size(); ++i) {
+		fprintf(fp, "%llu", output.records[i].timestamp);
+
+		for (int j = 0; j < output.value_cnt; ++j)
+			fprintf(fp, " %.9g", output.records[i].values[j]);
+
+		fprintf(fp, "\n");
+	}
+
+	fclose(fp);
+	return true;
+}
+
+static bool load_golden(const replay_output_t &output, std::vector<replay_record_t> &records)
+{
+	std::string path = data_path(output.name, ".golden");
+	FILE *fp = fopen(path.c_str(), "r");
+	char line[256];
+
+	if (!fp)
+		return false;
+
+	while (fgets(line, sizeof(line), fp)) {
+		replay_record_t record;
+
+		if (line[0] == '#')
+			continue;
+
+		memset(&record, 0, sizeof(record));
+
+		if (sscanf(line, "%llu %f %f %f %f", &record.timestamp, &record.values[0], &record.values[1],
+				&record.values[2], &record.values[3]) != 1 + output.value_cnt)
+			break;
+
+		records.push_back(record);
+	}
+
+	fclose(fp);
+	return true;
+}
+
+static double wrap_degrees(double angle)
+{
+	angle = fmod(angle, 360.0);
+
+	if (angle > 180.0)
+		angle -= 360.0;
+	else if (angle < -180.0)
+		angle += 360.0;
+
+	return fabs(angle);
+}
+
+static double get_error(replay_metric_t metric, const float *v1, const float *v2)
+{
+	double dot = 0, norm1 = 0, norm2 = 0, error = 0;
+
+	switch (metric) {
+	case METRIC_EULER_ANGLE:
+		for (int i = 0; i < 3; ++i)
+			error = std::max(error, wrap_degrees(v1[i] - v2[i]));
+		return error;
+	case METRIC_QUAT_ANGLE:
+		/* From the chord between the quaternions, which keeps its precision near zero unlike acos() */
+		for (int i = 0; i < 4; ++i) {
+			dot += (double)v1[i] * v2[i];
+			norm1 += ((double)v1[i] - v2[i]) * ((double)v1[i] - v2[i]);
+			norm2 += ((double)v1[i] + v2[i]) * ((double)v1[i] + v2[i]);
+		}
+
+		error = sqrt(dot >= 0 ? norm1 : norm2);
+		return 4.0 * asin(std::min(1.0, error / 2.0)) * 180.0 / M_PI;
+	case METRIC_VECTOR_ANGLE:
+		for (int i = 0; i < 3; ++i) {
+			dot += (double)v1[i] * v2[i];
+			norm1 += (double)v1[i] * v1[i];
+			norm2 += (double)v2[i] * v2[i];
+		}
+
+		dot /= sqrt(norm1 * norm2);
+		return acos(std::max(-1.0, std::min(1.0, dot))) * 180.0 / M_PI;
+	default:
+		for (int i = 0; i < 3; ++i)
+			error += ((double)v1[i] - v2[i]) * ((double)v1[i] - v2[i]);
+		return sqrt(error);
+	}
+}
+
+static void compare_golden(const replay_output_t &output)
+{
+	std::vector<replay_record_t> golden;
+	double sum = 0, max = 0;
+
+	if (!load_golden(output, golden)) {
+		CHECK(false, "no golden output for %s", output.name);
+		return;
+	}
+
+	CHECK(output.records.size() == golden.size(), "%s: %zu events, golden has %zu",
+		output.name, output.records.size(), golden.size());
+
+	size_t cnt = std::min(output.records.size(), golden.size());
+
+	for (size_t i = 0; i < cnt; ++i) {
+		if (output.records[i].timestamp != golden[i].timestamp) {
+			CHECK(false, "%s: event %zu at %llu us, golden at %llu us", output.name, i,
+				output.records[i].timestamp, golden[i].timestamp);
+			return;
+		}
+
+		double error = get_error(output.metric, output.records[i].values, golden[i].values);
+
+		sum += error;
+		max = std::max(max, error);
+	}
+
+	double mean = cnt ? sum / cnt : 0;
+
+	printf("%-14s %5zu events, vs golden mean %.5f, max %.5f %s\n", output.name, output.records.size(),
+		mean, max, output.unit);
+
+	CHECK(mean <= output.mean_budget, "%s: mean error %.5f %s over budget %.4f", output.name, mean,
+		output.unit, output.mean_budget);
+	CHECK(max <= output.max_budget, "%s: max error %.5f %s over budget %.4f", output.name, max,
+		output.unit, output.max_budget);
+}
+
+static void make_input_event(sensor_event_t &event, sensor_base *sensor, unsigned int event_type,
+	unsigned long long timestamp, const float *values)
+{
+	memset(&event, 0, sizeof(event));
+	event.sensor_id = sensor->get_id();
+	event.event_type = event_type;
+	event.data.accuracy = SENSOR_ACCURACY_GOOD;
+	event.data.timestamp = timestamp;
+	event.data.value_count = 3;
+	event.data.values[0] = values[0];
+	event.data.values[1] = values[1];
+	event.data.values[2] = values[2];
+}
+
+static void collect_output(const sensor_event_t &event)
+{
+	for (int i = 0; i < REPLAY_OUTPUT_CNT; ++i) {
+		replay_output_t &output = replay_outputs[i];
+
+		if (event.sensor_id != output.sensor->get_id() || event.event_type != output.event_type)
+			continue;
+
+		replay_record_t record;
+
+		memset(&record, 0, sizeof(record));
+		record.timestamp = event.data.timestamp;
+		memcpy(record.values, event.data.values, output.value_cnt * sizeof(float));
+		output.records.push_back(record);
+	}
+}
+
+/* For reference only: the golden files pin the output, not its accuracy */
+static void print_truth_error(const replay_output_t &rv, const std::vector<motion_sample_t> &trace)
+{
+	const size_t SETTLE_SAMPLES = 100;
+	std::vector<quaternion<float> > quats, truth;
+
+	for (size_t i = 0; i < rv.records.size(); ++i) {
+		const replay_record_t &record = rv.records[i];
+		size_t index = (record.timestamp - trace[0].timestamp) / MOTION_SAMPLE_INTERVAL_US;
+
+		if (index >= trace.size())
+			continue;
+
+		quats.push_back(quaternion<float>(record.values[3], record.values[0], record.values[1], record.values[2]));
+		truth.push_back(get_motion_truth(trace[index]));
+	}
+
+	attitude_error_t error = get_attitude_error(quats, truth, SETTLE_SAMPLES);
+
+	printf("rv vs true attitude: mean %.3f, p95 %.3f, max %.3f deg\n", error.mean, error.p95, error.max);
+}
+
+int main(int argc, char *argv[])
+{
+	sensor_plugin_loader &loader = sensor_plugin_loader::get_instance();
+	std::vector<motion_sample_t> trace;
+	bool record = (argc > 1 && !strcmp(argv[1], "--record"));
+
+	if (argc > 1 && !strcmp(argv[1], "--make-trace")) {
+		make_motion_trace(trace, REPLAY_SAMPLES, 4);
+		CHECK(save_trace(trace), "failed to write the trace");
+		return test_result("fusion_replay_test");
+	}
+
+	if (!load_trace(trace)) {
+		CHECK(false, "failed to read %s", data_path("motion", ".trace").c_str());
+		return test_result("fusion_replay_test");
+	}
+
+	loader.load_plugins();
+
+	sensor_base *accel = loader.get_sensor(ACCELEROMETER_SENSOR);
+	sensor_base *gyro = loader.get_sensor(GYROSCOPE_SENSOR);
+	sensor_base *magnetic = loader.get_sensor(GEOMAGNETIC_SENSOR);
+
+	CHECK(accel && gyro && magnetic, "replay input sensors are not loaded");
+
+	for (int i = 0; i < REPLAY_OUTPUT_CNT; ++i) {
+		replay_output_t &output = replay_outputs[i];
+
+		output.sensor = loader.get_sensor(output.type);
+		CHECK(output.sensor, "%s plugin is not loaded", output.name);
+	}
+
+	if (check_failures)
+		return test_result("fusion_replay_test");
+
+	/* Subscribe the way a client does: register the event, set the interval, start */
+	for (int i = 0; i < REPLAY_OUTPUT_CNT; ++i) {
+		replay_output_t &output = replay_outputs[i];
+
+		output.sensor->add_client(output.event_type);
+		output.sensor->add_interval(REPLAY_CLIENT_ID, REPLAY_INTERVAL_MS, false);
+		output.sensor->start();
+		output.records.reserve(trace.size() * 2);
+	}
+
+	csensor_event_dispatcher &dispatcher = csensor_event_dispatcher::get_instance();
+	sensor_event_t events[MAX_REPLAY_EVENT];
+	vector<sensor_event_t> outs(5);
+	unsigned long long elapsed = 0, alloc_total = 0;
+
+	for (size_t i = 0; i < trace.size(); ++i) {
+		const motion_sample_t &sample = trace[i];
+		sensor_event_t inputs[3];
+
+		make_input_event(inputs[0], accel, ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME, sample.timestamp, sample.accel);
+		make_input_event(inputs[1], gyro, GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME, sample.timestamp, sample.gyro);
+		make_input_event(inputs[2], magnetic, GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME, sample.timestamp, sample.magnetic);
+
+		for (int j = 0; j < 3; ++j) {
+			unsigned long long start_alloc_cnt = get_alloc_cnt();
+			unsigned long long start = now_ns();
+			unsigned int event_cnt = dispatcher.process_event(inputs[j], events, MAX_REPLAY_EVENT, outs);
+
+			elapsed += now_ns() - start;
+			alloc_total += get_alloc_cnt() - start_alloc_cnt;
+
+			for (unsigned int k = 0; k < event_cnt; ++k)
+				collect_output(events[k]);
+		}
+	}
+
+	for (int i = 0; i < REPLAY_OUTPUT_CNT; ++i)
+		replay_outputs[i].sensor->stop();
+
+	double ns_per_sample = (double)elapsed / trace.size();
+	double allocs_per_sample = (double)alloc_total / trace.size();
+
+	printf("%zu samples replayed: %.1f ns/sample, %.3f allocations/sample\n", trace.size(),
+		ns_per_sample, allocs_per_sample);
+
+	print_truth_error(replay_outputs[1], trace);
+
+	if (record) {
+		for (int i = 0; i < REPLAY_OUTPUT_CNT; ++i)
+			CHECK(save_golden(replay_outputs[i]), "failed to write the golden output of %s", replay_outputs[i].name);
+
+		return test_result("fusion_replay_test");
+	}
+
+	for (int i = 0; i < REPLAY_OUTPUT_CNT; ++i)
+		compare_golden(replay_outputs[i]);
+
+	CHECK(ns_per_sample <= NS_PER_SAMPLE_BUDGET, "%.1f ns/sample over budget %.0f", ns_per_sample, NS_PER_SAMPLE_BUDGET);
+	CHECK(allocs_per_sample <= ALLOCS_PER_SAMPLE_BUDGET, "%.3f allocations/sample over budget %.3f",
+		allocs_per_sample, ALLOCS_PER_SAMPLE_BUDGET);
+
+	return test_result("fusion_replay_test");
+}
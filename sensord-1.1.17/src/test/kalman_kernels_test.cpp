@@ -0,0 +1,243 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <kalman_kernels.h>
+#include <string.h>
+#include <math.h>
+#include <kalman_ref.h>
+#include <bench_util.h>
+
+/*
+ * Runs the 6x6 covariance kernels this build selects (NEON, SSE or scalar)
+ * and, on non-ARM hosts, the NEON kernels over an emulated <arm_neon.h>,
+ * against the scalar templates on the same inputs. Single steps on random
+ * filter-like inputs and a long chained run must agree within tolerance;
+ * on x86, where nothing is fused, they must be bit-identical. Also
+ * reports the cost of one predict + update step of each.
+ */
+
+static const int TRIALS = 2000;
+static const int CHAIN_STEPS = 5000;
+static const int BENCH_ROUNDS = 200000;
+static const float NEGLIGIBLE = 0.0000001f;
+static const double STEP_TOLERANCE = 1e-5;
+static const double CHAIN_TOLERANCE = 1e-3;
+
+#if defined(KALMAN_KERNELS_NEON)
+#define NATIVE_KERNEL_NAME "neon"
+#elif defined(KALMAN_KERNELS_SSE)
+#define NATIVE_KERNEL_NAME "sse"
+#else
+#define NATIVE_KERNEL_NAME "scalar"
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+#define EXPECT_BIT_IDENTICAL 1
+#else
+#define EXPECT_BIT_IDENTICAL 0
+#endif
+
+static void native_predict(float (*pred_cov)[6], const float (*tran_mat)[6], const float (*driv_cov)[6])
+{
+	matrix<float, 6, 6> pred(&pred_cov[0][0]), tran_m(&tran_mat[0][0]), driv(&driv_cov[0][0]);
+
+	predict_covariance(pred, tran_m, driv);
+	memcpy(pred_cov, pred.m_mat, sizeof(pred.m_mat));
+}
+
+static void native_update(float (*pred_cov)[6], float *state, const float *state_error,
+	const float (*aid_cov)[6], const float (*measure_mat)[6], float negligible)
+{
+	matrix<float, 6, 6> pred(&pred_cov[0][0]), aid(&aid_cov[0][0]), measure(&measure_mat[0][0]);
+	vect<float, 6> state_v(state), error_v(state_error);
+
+	update_covariance(pred, state_v, error_v, aid, measure, negligible);
+	memcpy(pred_cov, pred.m_mat, sizeof(pred.m_mat));
+	memcpy(state, state_v.m_vec, sizeof(state_v.m_vec));
+}
+
+static const kalman_kernel_ops_t native_ops = {NATIVE_KERNEL_NAME, native_predict, native_update};
+
+typedef struct {
+	float pred_cov[6][6];
+	float tran_mat[6][6];
+	float driv_cov[6][6];
+	float aid_cov[6][6];
+	float measure_mat[6][6];
+	float state[6];
+	float state_error[6];
+} kalman_step_t;
+
+static float uniform(unsigned int &seed, float lo, float hi)
+{
+	seed = seed * 1103515245 + 12345;
+	return lo + (hi - lo) * (((seed >> 8) & 0xFFFF) / 65535.0f);
+}
+
+/* Inputs shaped like orientation_filter's: gyro skew terms in F, diagonal Q and R, H = [I 0] */
+static void make_step(kalman_step_t &step, unsigned int &seed)
+{
+	memset(&step, 0, sizeof(step));
+
+	for (int i = 0; i < 6; i++) {
+		for (int j = 0; j < 6; j++) {
+			float val = uniform(seed, -0.01f, 0.01f);
+
+			step.pred_cov[i][j] = (i == j) ? uniform(seed, 0.0001f, 1.0f) : val;
+
+			/* Leave some entries below the clamp so the floor is exercised */
+			if (uniform(seed, 0, 1) < 0.1f)
+				step.pred_cov[i][j] = uniform(seed, -NEGLIGIBLE, NEGLIGIBLE);
+		}
+
+		step.driv_cov[i][i] = uniform(seed, 0.00001f, 0.01f);
+		step.aid_cov[i][i] = uniform(seed, 0.0001f, 0.1f);
+		step.state[i] = uniform(seed, -0.1f, 0.1f);
+		step.state_error[i] = uniform(seed, -0.1f, 0.1f);
+	}
+
+	float gx = uniform(seed, -0.05f, 0.05f);
+	float gy = uniform(seed, -0.05f, 0.05f);
+	float gz = uniform(seed, -0.05f, 0.05f);
+
+	step.tran_mat[0][1] = gz;
+	step.tran_mat[0][2] = -gy;
+	step.tran_mat[1][0] = -gz;
+	step.tran_mat[1][2] = gx;
+	step.tran_mat[2][0] = gy;
+	step.tran_mat[2][1] = -gx;
+	step.tran_mat[3][3] = step.tran_mat[4][4] = step.tran_mat[5][5] = -1.0f / 3600;
+
+	for (int i = 0; i < 3; i++)
+		step.measure_mat[i][i] = 1;
+}
+
+static void run_step(const kalman_kernel_ops_t &ops, kalman_step_t &step)
+{
+	ops.predict(step.pred_cov, step.tran_mat, step.driv_cov);
+	ops.update(step.pred_cov, step.state, step.state_error, step.aid_cov, step.measure_mat, NEGLIGIBLE);
+}
+
+static double rel_diff(float a, float b)
+{
+	return fabs((double)a - b) / (1e-6 + fabs((double)b));
+}
+
+/* Largest relative difference over the covariance and state, and whether all bits match */
+static double compare(const kalman_step_t &step, const kalman_step_t &ref, bool &identical)
+{
+	double max_diff = 0;
+
+	identical = !memcmp(step.pred_cov, ref.pred_cov, sizeof(step.pred_cov)) &&
+		!memcmp(step.state, ref.state, sizeof(step.state));
+
+	for (int i = 0; i < 6; i++) {
+		for (int j = 0; j < 6; j++)
+			max_diff = std::max(max_diff, rel_diff(step.pred_cov[i][j], ref.pred_cov[i][j]));
+
+		max_diff = std::max(max_diff, rel_diff(step.state[i], ref.state[i]));
+	}
+
+	return max_diff;
+}
+
+static void check_kernels(const kalman_kernel_ops_t &ops, bool expect_identical)
+{
+	unsigned int seed = 7;
+	int identical_cnt = 0;
+	double max_diff = 0;
+	bool identical;
+
+	for (int t = 0; t < TRIALS; t++) {
+		kalman_step_t step, ref;
+
+		make_step(step, seed);
+		ref = step;
+
+		run_step(ops, step);
+		run_step(kalman_scalar_ops, ref);
+
+		max_diff = std::max(max_diff, compare(step, ref, identical));
+		identical_cnt += identical;
+	}
+
+	printf("%-16s single step: %d/%d bit-identical to scalar, max relative difference %.3g\n",
+		ops.name, identical_cnt, TRIALS, max_diff);
+	CHECK(max_diff <= STEP_TOLERANCE, "%s kernels differ from scalar by %.3g", ops.name, max_diff);
+
+	if (expect_identical)
+		CHECK(identical_cnt == TRIALS, "%s kernels are not bit-identical to scalar", ops.name);
+
+	/* Feed each implementation its own output, as the filter does */
+	kalman_step_t chain, ref_chain, next;
+
+	seed = 11;
+	make_step(chain, seed);
+	ref_chain = chain;
+
+	for (int s = 0; s < CHAIN_STEPS; s++) {
+		make_step(next, seed);
+		memcpy(chain.tran_mat, next.tran_mat, sizeof(next.tran_mat));
+		memcpy(chain.state_error, next.state_error, sizeof(next.state_error));
+		memcpy(ref_chain.tran_mat, next.tran_mat, sizeof(next.tran_mat));
+		memcpy(ref_chain.state_error, next.state_error, sizeof(next.state_error));
+
+		run_step(ops, chain);
+		run_step(kalman_scalar_ops, ref_chain);
+	}
+
+	max_diff = compare(chain, ref_chain, identical);
+	printf("%-16s %d chained steps: %s, max relative difference %.3g\n", ops.name, CHAIN_STEPS,
+		identical ? "bit-identical" : "not bit-identical", max_diff);
+	CHECK(max_diff <= CHAIN_TOLERANCE, "%s kernels drift from scalar by %.3g", ops.name, max_diff);
+
+	if (expect_identical)
+		CHECK(identical, "%s kernels drift from scalar", ops.name);
+}
+
+static double bench_kernels(const kalman_kernel_ops_t &ops)
+{
+	unsigned int seed = 3;
+	kalman_step_t step;
+
+	make_step(step, seed);
+
+	unsigned long long start = now_ns();
+
+	for (int i = 0; i < BENCH_ROUNDS; i++)
+		run_step(ops, step);
+
+	return (double)(now_ns() - start) / BENCH_ROUNDS;
+}
+
+int main(void)
+{
+	check_kernels(native_ops, EXPECT_BIT_IDENTICAL);
+#if defined(KALMAN_TEST_NEON_EMU)
+	check_kernels(kalman_neon_emu_ops, true);
+#endif
+
+	double scalar_ns = bench_kernels(kalman_scalar_ops);
+	double native_ns = bench_kernels(native_ops);
+
+	printf("predict + update per step: scalar %.1f ns, %s %.1f ns (%.2fx)\n",
+		scalar_ns, native_ops.name, native_ns, scalar_ns / native_ns);
+
+	return test_result("kalman_kernels_test");
+}
@@ -0,0 +1,28 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Built with -D__ARM_NEON and neon_emu/ on the include path, see CMakeLists.txt */
+#define KALMAN_REF_NS kalman_neon_emu
+#define KALMAN_REF_OPS kalman_neon_emu_ops
+#define KALMAN_REF_NAME "neon (emulated)"
+#include <kalman_ref_impl.h>
+
+#if !defined(KALMAN_KERNELS_NEON)
+#error "kalman_neon_emu_ref.cpp must be built with the NEON kernels selected"
+#endif
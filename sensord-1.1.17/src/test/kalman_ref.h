@@ -0,0 +1,38 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if !defined(_KALMAN_REF_H_)
+#define _KALMAN_REF_H_
+
+/*
+ * The float 6x6 Kalman kernels of kalman_kernels.h, built in their own
+ * translation unit with a different kernel selection and wrapped in a
+ * namespace, so several selections can be linked into one test.
+ */
+typedef struct {
+	const char *name;
+	void (*predict)(float (*pred_cov)[6], const float (*tran_mat)[6], const float (*driv_cov)[6]);
+	void (*update)(float (*pred_cov)[6], float *state, const float *state_error,
+		const float (*aid_cov)[6], const float (*measure_mat)[6], float negligible);
+} kalman_kernel_ops_t;
+
+extern const kalman_kernel_ops_t kalman_scalar_ops;
+extern const kalman_kernel_ops_t kalman_neon_emu_ops;
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Included once per kernel selection, with KALMAN_REF_NS, KALMAN_REF_OPS
+ * and KALMAN_REF_NAME defined. System headers are pulled in before the
+ * namespace is opened so that only the sensor_fusion code lands in it.
+ */
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+#include <kalman_ref.h>
+
+namespace KALMAN_REF_NS {
+#include <kalman_kernels.h>
+
+static void predict(float (*pred_cov)[6], const float (*tran_mat)[6], const float (*driv_cov)[6])
+{
+	matrix<float, 6, 6> pred(&pred_cov[0][0]), tran_m(&tran_mat[0][0]), driv(&driv_cov[0][0]);
+
+	predict_covariance(pred, tran_m, driv);
+	memcpy(pred_cov, pred.m_mat, sizeof(pred.m_mat));
+}
+
+static void update(float (*pred_cov)[6], float *state, const float *state_error,
+	const float (*aid_cov)[6], const float (*measure_mat)[6], float negligible)
+{
+	matrix<float, 6, 6> pred(&pred_cov[0][0]), aid(&aid_cov[0][0]), measure(&measure_mat[0][0]);
+	vect<float, 6> state_v(state), error_v(state_error);
+
+	update_covariance(pred, state_v, error_v, aid, measure, negligible);
+	memcpy(pred_cov, pred.m_mat, sizeof(pred.m_mat));
+	memcpy(state, state_v.m_vec, sizeof(state_v.m_vec));
+}
+}
+
+extern const kalman_kernel_ops_t KALMAN_REF_OPS = {KALMAN_REF_NAME, KALMAN_REF_NS::predict, KALMAN_REF_NS::update};
@@ -0,0 +1,195 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cclient_info_manager.h>
+#include <csocket.h>
+#include <set>
+#include <bench_util.h>
+
+using std::set;
+
+/*
+ * Builds 64 clients subscribed to a mix of 20 (sensor, event type) pairs
+ * and compares the dispatcher's lock-free listener index against the
+ * walk over every client record it replaced. Both must agree on the
+ * listeners of every event, also after unsubscribing and disconnecting.
+ */
+
+static const int CLIENT_CNT = 64;
+static const int SENSOR_CNT = 5;
+static const int EVENT_PER_SENSOR = 4;
+static const int LOOKUP_ROUNDS = 2000;
+
+static sensor_id_t get_sensor_id(int event_index)
+{
+	return (sensor_id_t)(event_index / EVENT_PER_SENSOR + 1);
+}
+
+static unsigned int get_event_type(int event_index)
+{
+	return (get_sensor_id(event_index) << 16) | (event_index % EVENT_PER_SENSOR + 1);
+}
+
+static bool is_subscribed(int client, int event_index)
+{
+	return ((client + event_index) % 3) != 0;
+}
+
+static set<int> get_index_listeners(cclient_info_manager &manager, int event_index)
+{
+	set<int> ids;
+	const event_listener_vec *listeners = cclient_info_manager::find_listeners(manager.get_listener_index(),
+		get_sensor_id(event_index), get_event_type(event_index));
+
+	if (!listeners)
+		return ids;
+
+	auto it_listener = listeners->begin();
+
+	while (it_listener != listeners->end()) {
+		ids.insert(it_listener->client_id);
+		++it_listener;
+	}
+
+	return ids;
+}
+
+static set<int> get_walk_listeners(cclient_info_manager &manager, int event_index)
+{
+	client_id_vec id_vec;
+
+	manager.get_listener_ids(get_sensor_id(event_index), get_event_type(event_index), id_vec);
+	return set<int>(id_vec.begin(), id_vec.end());
+}
+
+static void check_index(cclient_info_manager &manager, const char *phase)
+{
+	for (int e = 0; e < SENSOR_CNT * EVENT_PER_SENSOR; ++e) {
+		set<int> index_ids = get_index_listeners(manager, e);
+		set<int> walk_ids = get_walk_listeners(manager, e);
+
+		CHECK(index_ids == walk_ids, "%s: event 0x%x has %d indexed listeners, %d by walking the records",
+			phase, get_event_type(e), (int)index_ids.size(), (int)walk_ids.size());
+	}
+}
+
+int main(void)
+{
+	cclient_info_manager &manager = cclient_info_manager::get_instance();
+	int client_ids[CLIENT_CNT];
+	csocket sockets[CLIENT_CNT];
+	const int event_cnt = SENSOR_CNT * EVENT_PER_SENSOR;
+	int reg_cnt = 0;
+
+	unsigned long long start = now_ns();
+
+	for (int c = 0; c < CLIENT_CNT; ++c) {
+		client_ids[c] = manager.create_client_record();
+		sockets[c].create(SOCK_SEQPACKET);
+
+		for (int s = 1; s <= SENSOR_CNT; ++s)
+			manager.create_sensor_record(client_ids[c], s);
+
+		for (int e = 0; e < event_cnt; ++e) {
+			if (is_subscribed(c, e)) {
+				manager.register_event(client_ids[c], get_sensor_id(e), get_event_type(e));
+				++reg_cnt;
+			}
+		}
+
+		manager.set_event_socket(client_ids[c], sockets[c]);
+	}
+
+	unsigned long long setup_ns = now_ns() - start;
+
+	printf("%d clients x %d event types, %d registrations, setup %.1f us\n",
+		CLIENT_CNT, event_cnt, reg_cnt, setup_ns / 1000.0);
+
+	check_index(manager, "subscribed");
+
+	unsigned long long fd_sum = 0;
+
+	/* The lookup the dispatcher did before: walk every record, then fetch each socket under the lock */
+	start = now_ns();
+
+	for (int r = 0; r < LOOKUP_ROUNDS; ++r) {
+		for (int e = 0; e < event_cnt; ++e) {
+			client_id_vec id_vec;
+
+			manager.get_listener_ids(get_sensor_id(e), get_event_type(e), id_vec);
+
+			auto it_id = id_vec.begin();
+
+			while (it_id != id_vec.end()) {
+				csocket sock;
+
+				if (manager.get_event_socket(*it_id, sock))
+					fd_sum += sock.get_socket_fd();
+
+				++it_id;
+			}
+		}
+	}
+
+	double walk_ns = (double)(now_ns() - start) / (LOOKUP_ROUNDS * event_cnt);
+
+	start = now_ns();
+
+	for (int r = 0; r < LOOKUP_ROUNDS; ++r) {
+		for (int e = 0; e < event_cnt; ++e) {
+			const event_listener_vec *listeners = cclient_info_manager::find_listeners(manager.get_listener_index(),
+				get_sensor_id(e), get_event_type(e));
+
+			if (!listeners)
+				continue;
+
+			auto it_listener = listeners->begin();
+
+			while (it_listener != listeners->end()) {
+				fd_sum -= it_listener->event_socket.get_socket_fd();
+				++it_listener;
+			}
+		}
+	}
+
+	double index_ns = (double)(now_ns() - start) / (LOOKUP_ROUNDS * event_cnt);
+
+	printf("listener lookup per event: record walk %.1f ns, index %.1f ns (%.1fx)\n",
+		walk_ns, index_ns, walk_ns / index_ns);
+	CHECK(fd_sum == 0, "record walk and index returned different sockets");
+
+	for (int c = 0; c < CLIENT_CNT; c += 2)
+		manager.unregister_event(client_ids[c], get_sensor_id(1), get_event_type(1));
+
+	check_index(manager, "unregistered");
+
+	start = now_ns();
+
+	for (int c = 0; c < CLIENT_CNT; c += 4)
+		manager.remove_client_record(client_ids[c]);
+
+	printf("client disconnect with index rebuild: %.1f us\n", (now_ns() - start) / 1000.0 / (CLIENT_CNT / 4));
+
+	check_index(manager, "disconnected");
+
+	for (int c = 0; c < CLIENT_CNT; ++c)
+		sockets[c].close();
+
+	return test_result("listener_index_bench");
+}
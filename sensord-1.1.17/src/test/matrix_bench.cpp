@@ -0,0 +1,193 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <orientation_filter.h>
+#include <bench_util.h>
+#include <alloc_counter.h>
+#include <motion_trace.h>
+
+/*
+ * The 6x6 covariance prediction F * P * F' + Q written against a copy of
+ * the heap-backed matrix the filter used to have, and against the inline
+ * matrix<T, R, C> it uses now. Reports allocations and time per step, then
+ * the allocations and per-sample cost of the whole get_orientation() call.
+ */
+
+static const int KERNEL_ROUNDS = 100000;
+static const int TRACE_SAMPLES = 20000;
+
+/* Row-pointer matrix with by-value operators, as sensor_fusion had before */
+class heap_matrix
+{
+public:
+	int m_rows;
+	int m_cols;
+	float **m_mat;
+
+	heap_matrix(int rows, int cols)
+	: m_rows(rows)
+	, m_cols(cols)
+	{
+		m_mat = new float *[m_rows];
+
+		for (int i = 0; i < m_rows; i++)
+			m_mat[i] = new float[m_cols]();
+	}
+
+	heap_matrix(const heap_matrix &m)
+	: m_rows(m.m_rows)
+	, m_cols(m.m_cols)
+	{
+		m_mat = new float *[m_rows];
+
+		for (int i = 0; i < m_rows; i++) {
+			m_mat[i] = new float[m_cols];
+
+			for (int j = 0; j < m_cols; j++)
+				m_mat[i][j] = m.m_mat[i][j];
+		}
+	}
+
+	~heap_matrix()
+	{
+		for (int i = 0; i < m_rows; i++)
+			delete[] m_mat[i];
+
+		delete[] m_mat;
+	}
+
+	heap_matrix operator =(const heap_matrix &m)
+	{
+		for (int i = 0; i < m_rows; i++)
+			for (int j = 0; j < m_cols; j++)
+				m_mat[i][j] = m.m_mat[i][j];
+
+		return *this;
+	}
+};
+
+static heap_matrix operator *(const heap_matrix m1, const heap_matrix m2)
+{
+	heap_matrix m(m1.m_rows, m2.m_cols);
+
+	for (int i = 0; i < m1.m_rows; i++)
+		for (int j = 0; j < m2.m_cols; j++)
+			for (int k = 0; k < m1.m_cols; k++)
+				m.m_mat[i][j] += m1.m_mat[i][k] * m2.m_mat[k][j];
+
+	return m;
+}
+
+static heap_matrix operator +(const heap_matrix m1, const heap_matrix m2)
+{
+	heap_matrix m(m1.m_rows, m1.m_cols);
+
+	for (int i = 0; i < m1.m_rows; i++)
+		for (int j = 0; j < m1.m_cols; j++)
+			m.m_mat[i][j] = m1.m_mat[i][j] + m2.m_mat[i][j];
+
+	return m;
+}
+
+static heap_matrix tran(const heap_matrix m)
+{
+	heap_matrix t(m.m_cols, m.m_rows);
+
+	for (int i = 0; i < m.m_rows; i++)
+		for (int j = 0; j < m.m_cols; j++)
+			t.m_mat[j][i] = m.m_mat[i][j];
+
+	return t;
+}
+
+template <typename MATRIX>
+static void fill(MATRIX &tran_mat, MATRIX &pred_cov, MATRIX &driv_cov)
+{
+	for (int i = 0; i < M6X6R; i++) {
+		for (int j = 0; j < M6X6C; j++) {
+			tran_mat.m_mat[i][j] = (i == j) ? 0.99f : 0.01f * (i - j);
+			pred_cov.m_mat[i][j] = (i == j) ? 1.0f : 0.001f * (i + j);
+			driv_cov.m_mat[i][j] = (i == j) ? 0.0001f : 0.0f;
+		}
+	}
+}
+
+int main(void)
+{
+	heap_matrix heap_tran(M6X6R, M6X6C), heap_cov(M6X6R, M6X6C), heap_driv(M6X6R, M6X6C);
+	matrix<float, M6X6R, M6X6C> tran_mat, pred_cov, driv_cov;
+	unsigned long long allocs, start;
+
+	fill(heap_tran, heap_cov, heap_driv);
+	fill(tran_mat, pred_cov, driv_cov);
+
+	allocs = get_alloc_cnt();
+	start = now_ns();
+
+	for (int i = 0; i < KERNEL_ROUNDS; ++i)
+		heap_cov = heap_tran * heap_cov * tran(heap_tran) + heap_driv;
+
+	double heap_ns = (double)(now_ns() - start) / KERNEL_ROUNDS;
+	double heap_allocs = (double)(get_alloc_cnt() - allocs) / KERNEL_ROUNDS;
+
+	allocs = get_alloc_cnt();
+	start = now_ns();
+
+	for (int i = 0; i < KERNEL_ROUNDS; ++i)
+		pred_cov = tran_mat * pred_cov * tran(tran_mat) + driv_cov;
+
+	double inline_ns = (double)(now_ns() - start) / KERNEL_ROUNDS;
+	double inline_allocs = (double)(get_alloc_cnt() - allocs) / KERNEL_ROUNDS;
+
+	printf("F * P * F' + Q: heap matrix %.1f ns, %.0f allocations | inline matrix %.1f ns, %.0f allocations\n",
+		heap_ns, heap_allocs, inline_ns, inline_allocs);
+	CHECK(inline_allocs == 0, "inline matrix allocated %.1f times per step", inline_allocs);
+
+	for (int i = 0; i < M6X6R; i++) {
+		for (int j = 0; j < M6X6C; j++) {
+			CHECK(fabs(heap_cov.m_mat[i][j] - pred_cov.m_mat[i][j]) <= 1e-4 * (1 + fabs(heap_cov.m_mat[i][j])),
+				"P[%d][%d] is %g, heap matrix gives %g", i, j, pred_cov.m_mat[i][j], heap_cov.m_mat[i][j]);
+		}
+	}
+
+	std::vector<motion_sample_t> trace;
+	orientation_filter<float> filter;
+	sensor_data<float> accel, gyro, magnetic;
+	euler_angles<float> orientation;
+
+	make_motion_trace(trace, TRACE_SAMPLES, 1);
+
+	allocs = get_alloc_cnt();
+	start = now_ns();
+
+	for (int i = 0; i < TRACE_SAMPLES; ++i) {
+		get_motion_data(trace[i], accel, gyro, magnetic);
+		orientation = filter.get_orientation(accel, gyro, magnetic);
+	}
+
+	double sample_ns = (double)(now_ns() - start) / TRACE_SAMPLES;
+	double sample_allocs = (double)(get_alloc_cnt() - allocs) / TRACE_SAMPLES;
+
+	printf("orientation_filter<float>::get_orientation: %.1f ns, %.2f allocations per sample\n",
+		sample_ns, sample_allocs);
+	CHECK(sample_allocs == 0, "get_orientation allocated %.2f times per sample", sample_allocs);
+	CHECK(!isnan(orientation.m_ang.m_vec[0]), "orientation is not a number");
+
+	return test_result("matrix_bench");
+}
@@ -0,0 +1,211 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if !defined(_MOTION_TRACE_H_)
+#define _MOTION_TRACE_H_
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include <sensor_data.h>
+#include <quaternion.h>
+#include <bench_util.h>
+
+/*
+ * Deterministic accel/gyro/magnetic trace of a hand-held device slowly
+ * tumbling about all three axes, sampled at 100 Hz. The true attitude is
+ * integrated from a known body rate, gravity and the earth field are
+ * rotated into the body frame, and small pseudo-random noise and a gyro
+ * bias are added. Values are in the units the fusion filters take after
+ * the per-device scale and sign compensation: m/s^2, rad/s / PI^2 and uT.
+ * truth is the body-to-earth attitude (w, x, y, z) in the filters' east,
+ * north, up frame.
+ */
+typedef struct {
+	unsigned long long timestamp;
+	float accel[3];
+	float gyro[3];
+	float magnetic[3];
+	float truth[4];
+} motion_sample_t;
+
+static const unsigned long long MOTION_SAMPLE_INTERVAL_US = 10000;
+
+static inline double motion_noise(unsigned int &state)
+{
+	state = state * 1103515245 + 12345;
+	return ((state >> 8) & 0xFFFF) / 32767.5 - 1.0;
+}
+
+static inline void motion_quat_mul(const double *a, const double *b, double *r)
+{
+	r[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+	r[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+	r[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+	r[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+}
+
+static inline void motion_to_body(const double *q, const double *v, double *out)
+{
+	double conj[4] = {q[0], -q[1], -q[2], -q[3]};
+	double vq[4] = {0, v[0], v[1], v[2]};
+	double tmp[4], res[4];
+
+	motion_quat_mul(conj, vq, tmp);
+	motion_quat_mul(tmp, q, res);
+
+	for (int i = 0; i < 3; ++i)
+		out[i] = res[i + 1];
+}
+
+static inline void make_motion_trace(std::vector<motion_sample_t> &trace, int count, unsigned int seed)
+{
+	const double EARTH_GRAVITY[3] = {0, 0, 9.80665};
+	const double EARTH_FIELD[3] = {0, 22, -40};
+	const double GYRO_BIAS[3] = {0.01, -0.006, 0.004};
+	const double dt = MOTION_SAMPLE_INTERVAL_US / 1000000.0;
+	const double GYRO_UNIT = 1.0 / (M_PI * M_PI);
+	double q[4] = {1, 0, 0, 0};
+	unsigned int noise = seed;
+
+	trace.resize(count);
+
+	for (int i = 0; i < count; ++i) {
+		double t = i * dt;
+		double rate[4] = {0, 0.6 * sin(0.7 * t), 0.4 * cos(0.5 * t), 0.3 * sin(0.23 * t + seed)};
+		double dq[4], accel[3], magnetic[3];
+
+		motion_quat_mul(q, rate, dq);
+
+		double norm = 0;
+
+		for (int j = 0; j < 4; ++j) {
+			q[j] += 0.5 * dt * dq[j];
+			norm += q[j] * q[j];
+		}
+
+		for (int j = 0; j < 4; ++j)
+			q[j] /= sqrt(norm);
+
+		motion_to_body(q, EARTH_GRAVITY, accel);
+		motion_to_body(q, EARTH_FIELD, magnetic);
+
+		motion_sample_t &sample = trace[i];
+		sample.timestamp = 1000000ULL + (i + 1) * MOTION_SAMPLE_INTERVAL_US;
+
+		for (int j = 0; j < 4; ++j)
+			sample.truth[j] = q[j];
+
+		for (int j = 0; j < 3; ++j) {
+			sample.accel[j] = accel[j] + 0.05 * motion_noise(noise);
+			sample.gyro[j] = (rate[j + 1] + GYRO_BIAS[j] + 0.002 * motion_noise(noise)) * GYRO_UNIT;
+			sample.magnetic[j] = magnetic[j] + 0.5 * motion_noise(noise);
+		}
+	}
+}
+
+/* Reads a trace written by fusion_replay_test --make-trace */
+static inline bool load_motion_trace(const char *path, std::vector<motion_sample_t> &trace)
+{
+	FILE *fp = fopen(path, "r");
+	char line[512];
+
+	if (!fp)
+		return false;
+
+	while (fgets(line, sizeof(line), fp)) {
+		motion_sample_t s;
+
+		if (line[0] == '#')
+			continue;
+
+		if (sscanf(line, "%llu %f %f %f %f %f %f %f %f %f %f %f %f %f", &s.timestamp,
+				&s.accel[0], &s.accel[1], &s.accel[2], &s.gyro[0], &s.gyro[1], &s.gyro[2],
+				&s.magnetic[0], &s.magnetic[1], &s.magnetic[2],
+				&s.truth[0], &s.truth[1], &s.truth[2], &s.truth[3]) != 14)
+			break;
+
+		trace.push_back(s);
+	}
+
+	fclose(fp);
+	return !trace.empty();
+}
+
+template <typename TYPE>
+static inline void get_motion_data(const motion_sample_t &sample, sensor_data<TYPE> &accel,
+		sensor_data<TYPE> &gyro, sensor_data<TYPE> &magnetic)
+{
+	accel = sensor_data<TYPE>(sample.accel[0], sample.accel[1], sample.accel[2], sample.timestamp);
+	gyro = sensor_data<TYPE>(sample.gyro[0], sample.gyro[1], sample.gyro[2], sample.timestamp);
+	magnetic = sensor_data<TYPE>(sample.magnetic[0], sample.magnetic[1], sample.magnetic[2], sample.timestamp);
+}
+
+static inline quaternion<float> get_motion_truth(const motion_sample_t &sample)
+{
+	return quaternion<float>(sample.truth[0], sample.truth[1], sample.truth[2], sample.truth[3]);
+}
+
+/* Angle in degrees of the rotation between two attitudes */
+static inline double quat_angle(const quaternion<float> &q1, const quaternion<float> &q2)
+{
+	double dot = 0;
+
+	for (int i = 0; i < 4; ++i)
+		dot += (double)q1.m_quat.m_vec[i] * q2.m_quat.m_vec[i];
+
+	dot = fabs(dot);
+
+	if (dot > 1.0)
+		dot = 1.0;
+
+	return 2.0 * acos(dot) * 180.0 / M_PI;
+}
+
+typedef struct {
+	double mean;
+	double p95;
+	double max;
+} attitude_error_t;
+
+/* Angles in degrees between two attitude sequences, skipping the first samples while filters settle */
+static inline attitude_error_t get_attitude_error(const std::vector<quaternion<float> > &quats,
+		const std::vector<quaternion<float> > &refs, size_t skip)
+{
+	std::vector<unsigned long long> errors;
+	attitude_error_t result = {0, 0, 0};
+	double sum = 0;
+
+	for (size_t i = skip; i < quats.size(); ++i) {
+		double error = quat_angle(quats[i], refs[i]);
+
+		sum += error;
+		errors.push_back((unsigned long long)(error * 1000000));
+	}
+
+	if (errors.empty())
+		return result;
+
+	result.mean = sum / errors.size();
+	result.p95 = percentile(errors, 0.95) / 1000000.0;
+	result.max = percentile(errors, 1.0) / 1000000.0;
+
+	return result;
+}
+
+#endif
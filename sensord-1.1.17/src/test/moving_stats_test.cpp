@@ -0,0 +1,150 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#include <orientation_filter.h>
+#include <euler_angles.h>
+#include <bench_util.h>
+#include <motion_trace.h>
+
+/*
+ * Feeds replay/motion.trace through moving_stats and through the
+ * insert_end() + var() window that orientation_filter used before, for
+ * the six channels compute_covariance() tracks, and requires the two
+ * variances to agree within VAR_TOLERANCE relative to the variance. The
+ * reference var() works in float, so variances below VAR_FLOOR, which are
+ * down at the rounding of the samples themselves, are held to
+ * VAR_TOLERANCE * VAR_FLOOR instead.
+ *
+ * Also checks the once-per-trip resync: right after it the running sums
+ * must equal an exact recomputation, and just before it they must not
+ * have drifted past DRIFT_TOLERANCE. Changing the window length mid-run
+ * restarts the window at the new length, clamped to [2, CAPACITY].
+ */
+
+typedef moving_stats<float, MOVING_AVERAGE_WINDOW_MAX> window_stats;
+
+static const double VAR_TOLERANCE = 1e-5;
+static const double VAR_FLOOR = 1e-6;
+static const double DRIFT_TOLERANCE = 1e-9;
+
+static const int CHANNEL_CNT = 6;
+static const char *channel_names[CHANNEL_CNT] = {"gyro x", "gyro y", "gyro z", "roll", "pitch", "azimuth"};
+
+typedef struct {
+	double max_error;
+	double max_drift;
+	int trips;
+} window_result_t;
+
+static void get_channels(const std::vector<motion_sample_t> &trace, std::vector<float> *channels)
+{
+	for (size_t i = 0; i < trace.size(); ++i) {
+		euler_angles<float> orientation = quat2euler(get_motion_truth(trace[i]));
+
+		for (int j = 0; j < 3; ++j) {
+			channels[j].push_back(trace[i].gyro[j]);
+			channels[3 + j].push_back(orientation.m_ang.m_vec[j]);
+		}
+	}
+}
+
+/*
+ * Restarts stats at length, which must clamp to LENGTH, and runs the
+ * samples [begin, end) through it and through a LENGTH-sample vect
+ */
+template <int LENGTH>
+static void run_window(window_stats &stats, int length, const std::vector<float> &values,
+		size_t begin, size_t end, const char *name, window_result_t &result)
+{
+	vect<float, LENGTH> window;
+
+	stats.reset(length, (float) NON_ZERO_VAL);
+	CHECK(stats.m_length == LENGTH, "%s: window length %d set to %d, expected %d",
+		name, length, stats.m_length, LENGTH);
+
+	for (int i = 0; i < LENGTH; ++i)
+		window.m_vec[i] = (float) NON_ZERO_VAL;
+
+	for (size_t i = begin; i < end; ++i) {
+		window_stats exact;
+
+		if (stats.m_head == stats.m_length - 1) {
+			exact = stats;
+			exact.resync();
+			result.max_drift = std::max(result.max_drift,
+				fabs(exact.m_m2 - stats.m_m2) / std::max(exact.m_m2, VAR_FLOOR));
+		}
+
+		insert_end(window, values[i]);
+		stats.insert(values[i]);
+
+		if (stats.m_head == 0) {
+			exact = stats;
+			exact.resync();
+			CHECK(exact.m_mean == stats.m_mean && exact.m_m2 == stats.m_m2,
+				"%s: sums not resynced at the end of a trip (sample %d)", name, (int)i);
+			result.trips++;
+		}
+
+		double ref = var(window);
+		double error = fabs(stats.get_var() - ref) / std::max(fabs(ref), VAR_FLOOR);
+
+		result.max_error = std::max(result.max_error, error);
+	}
+}
+
+int main(void)
+{
+	std::vector<motion_sample_t> trace;
+	std::vector<float> channels[CHANNEL_CNT];
+
+	CHECK(load_motion_trace(REPLAY_DATA_DIR "/motion.trace", trace), "failed to load the motion trace");
+
+	if (check_failures)
+		return test_result("moving_stats_test");
+
+	get_channels(trace, channels);
+
+	size_t quarter = trace.size() / 4;
+
+	for (int c = 0; c < CHANNEL_CNT; ++c) {
+		window_stats stats;
+		window_result_t result = {0, 0, 0};
+		const char *name = channel_names[c];
+		const std::vector<float> &values = channels[c];
+
+		/* The default length, then a shorter, an over-long and a too short one */
+		run_window<MOVING_AVERAGE_WINDOW_LENGTH>(stats, MOVING_AVERAGE_WINDOW_LENGTH, values, 0, quarter, name, result);
+		run_window<7>(stats, 7, values, quarter, 2 * quarter, name, result);
+		run_window<MOVING_AVERAGE_WINDOW_MAX>(stats, MOVING_AVERAGE_WINDOW_MAX + 36, values, 2 * quarter, 3 * quarter, name, result);
+		run_window<2>(stats, 1, values, 3 * quarter, values.size(), name, result);
+
+		printf("%-8s %d samples, %d resyncs, max relative variance error %.2e, max drift before resync %.2e\n",
+			name, (int)values.size(), result.trips, result.max_error, result.max_drift);
+
+		CHECK(result.max_error <= VAR_TOLERANCE, "%s: variance differs from vect::var() by %.2e (budget %.0e)",
+			name, result.max_error, VAR_TOLERANCE);
+		CHECK(result.max_drift <= DRIFT_TOLERANCE, "%s: running sums drifted by %.2e before a resync (budget %.0e)",
+			name, result.max_drift, DRIFT_TOLERANCE);
+		CHECK(result.trips > 0, "%s: no resync ran", name);
+	}
+
+	return test_result("moving_stats_test");
+}
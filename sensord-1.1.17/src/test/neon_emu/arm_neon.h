@@ -0,0 +1,139 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#if !defined(_NEON_EMU_ARM_NEON_H_)
+#define _NEON_EMU_ARM_NEON_H_
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Scalar stand-in for the few <arm_neon.h> intrinsics kalman_kernels.cpp
+ * uses, so the NEON lane logic can be built and checked on x86 hosts.
+ * Each intrinsic is the plain per-lane float operation, so results are
+ * those of an ARM core without fused multiply-add. It is only ever on the
+ * include path of kalman_neon_emu_ref.cpp, never of a real ARM build.
+ */
+typedef struct { float val[2]; } float32x2_t;
+typedef struct { float val[4]; } float32x4_t;
+typedef struct { uint32_t val[4]; } uint32x4_t;
+
+static inline float32x4_t vld1q_f32(const float *p)
+{
+	float32x4_t r;
+
+	memcpy(r.val, p, sizeof(r.val));
+	return r;
+}
+
+static inline float32x2_t vld1_f32(const float *p)
+{
+	float32x2_t r;
+
+	memcpy(r.val, p, sizeof(r.val));
+	return r;
+}
+
+static inline void vst1q_f32(float *p, float32x4_t v)
+{
+	memcpy(p, v.val, sizeof(v.val));
+}
+
+static inline void vst1_f32(float *p, float32x2_t v)
+{
+	memcpy(p, v.val, sizeof(v.val));
+}
+
+static inline float32x2_t vdup_n_f32(float val)
+{
+	float32x2_t r = {{val, val}};
+	return r;
+}
+
+static inline float32x4_t vdupq_n_f32(float val)
+{
+	float32x4_t r = {{val, val, val, val}};
+	return r;
+}
+
+static inline float32x4_t vcombine_f32(float32x2_t lo, float32x2_t hi)
+{
+	float32x4_t r = {{lo.val[0], lo.val[1], hi.val[0], hi.val[1]}};
+	return r;
+}
+
+static inline float32x2_t vget_low_f32(float32x4_t v)
+{
+	float32x2_t r = {{v.val[0], v.val[1]}};
+	return r;
+}
+
+#define NEON_EMU_BINARY(name, op) \
+	static inline float32x4_t name(float32x4_t a, float32x4_t b) \
+	{ \
+		float32x4_t r; \
+		for (int i = 0; i < 4; i++) \
+			r.val[i] = a.val[i] op b.val[i]; \
+		return r; \
+	}
+
+NEON_EMU_BINARY(vaddq_f32, +)
+NEON_EMU_BINARY(vsubq_f32, -)
+NEON_EMU_BINARY(vmulq_f32, *)
+NEON_EMU_BINARY(vdivq_f32, /)
+
+#define NEON_EMU_COMPARE(name, op) \
+	static inline uint32x4_t name(float32x4_t a, float32x4_t b) \
+	{ \
+		uint32x4_t r; \
+		for (int i = 0; i < 4; i++) \
+			r.val[i] = (a.val[i] op b.val[i]) ? 0xFFFFFFFFu : 0; \
+		return r; \
+	}
+
+NEON_EMU_COMPARE(vceqq_f32, ==)
+NEON_EMU_COMPARE(vcleq_f32, <=)
+NEON_EMU_COMPARE(vcltq_f32, <)
+
+static inline float32x4_t vabsq_f32(float32x4_t v)
+{
+	float32x4_t r;
+
+	for (int i = 0; i < 4; i++)
+		r.val[i] = (v.val[i] < 0) ? -v.val[i] : v.val[i];
+
+	return r;
+}
+
+static inline float32x4_t vbslq_f32(uint32x4_t mask, float32x4_t a, float32x4_t b)
+{
+	float32x4_t r;
+
+	for (int i = 0; i < 4; i++) {
+		uint32_t bits_a, bits_b, bits_r;
+
+		memcpy(&bits_a, &a.val[i], sizeof(bits_a));
+		memcpy(&bits_b, &b.val[i], sizeof(bits_b));
+		bits_r = (mask.val[i] & bits_a) | (~mask.val[i] & bits_b);
+		memcpy(&r.val[i], &bits_r, sizeof(bits_r));
+	}
+
+	return r;
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <creactor.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <new>
+#include <thread>
+#include <bench_util.h>
+
+using std::vector;
+using std::thread;
+
+/*
+ * Serves 64 clients from a reactor set up like the daemon's, two reactor
+ * threads and two workers, and reports the time for a client to connect
+ * and get its first reply, the round trips per second across all of them,
+ * and the RSS each connection costs. Then a few clients issue commands
+ * that sleep like a slow sensor HAL, more of them than there are reactor
+ * threads, and the others' round trips must not wait behind them.
+ */
+
+static const int CLIENT_CNT = 64;
+static const int REACTOR_THREAD_CNT = 2;
+static const int REACTOR_WORKER_CNT = 2;
+static const int ROUNDS = 2000;
+static const int BLOCKING_CLIENT_CNT = 4;
+static const int BLOCKING_TIME_US = 100000;
+static const int STALL_ROUNDS = 200;
+
+static const char CMD_ECHO = 'e';
+static const char CMD_BLOCK = 'b';
+
+static creactor *reactor;
+
+struct connection {
+	int fd;
+};
+
+static bool blocking_done(void *ctx)
+{
+	connection *conn = (connection *)ctx;
+	char reply = CMD_BLOCK;
+
+	usleep(BLOCKING_TIME_US);
+	return send(conn->fd, &reply, 1, MSG_NOSIGNAL) == 1;
+}
+
+static bool readable(void *ctx)
+{
+	connection *conn = (connection *)ctx;
+	char cmd;
+	ssize_t len;
+
+	while (true) {
+		len = recv(conn->fd, &cmd, 1, MSG_DONTWAIT);
+
+		if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return true;
+
+		if (len <= 0)
+			return false;
+
+		if (cmd == CMD_BLOCK) {
+			if (reactor->defer(blocking_done))
+				return true;
+
+			if (!blocking_done(ctx))
+				return false;
+
+			continue;
+		}
+
+		if (send(conn->fd, &cmd, 1, MSG_NOSIGNAL) != 1)
+			return false;
+	}
+}
+
+static bool removed(void *ctx)
+{
+	connection *conn = (connection *)ctx;
+
+	close(conn->fd);
+	delete conn;
+	return true;
+}
+
+static bool accept_clients(void *ctx)
+{
+	int listen_fd = (int)(long)ctx;
+	connection *conn;
+	int fd;
+
+	while (true) {
+		fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+		if (fd < 0)
+			return (errno == EAGAIN || errno == EWOULDBLOCK);
+
+		conn = new(std::nothrow) connection;
+
+		if (conn)
+			conn->fd = fd;
+
+		if (!conn || !reactor->add(fd, readable, removed, conn)) {
+			delete conn;
+			close(fd);
+		}
+	}
+}
+
+static long get_rss_kb(void)
+{
+	char line[128];
+	long rss = -1;
+	FILE *fp;
+
+	fp = fopen("/proc/self/status", "r");
+
+	if (!fp)
+		return -1;
+
+	while (fgets(line, sizeof(line), fp)) {
+		if (!strncmp(line, "VmRSS:", 6)) {
+			rss = atol(line + 6);
+			break;
+		}
+	}
+
+	fclose(fp);
+	return rss;
+}
+
+static bool round_trip(int fd, char cmd)
+{
+	char reply;
+
+	if (send(fd, &cmd, 1, MSG_NOSIGNAL) != 1)
+		return false;
+
+	return recv(fd, &reply, 1, 0) == 1 && reply == cmd;
+}
+
+int main(int argc, char **argv)
+{
+	struct sockaddr_un addr;
+	int listen_fd;
+	int clients[CLIENT_CNT];
+	vector<unsigned long long> connect_ns;
+	vector<unsigned long long> stall_ns;
+	vector<thread> blockers;
+	unsigned long long start;
+	long rss_before, rss_after;
+	bool ok = true;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1, "sensord_reactor_bench_%d", getpid());
+
+	listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	CHECK(listen_fd >= 0, "socket failed, errno %d", errno);
+	CHECK(!bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)), "bind failed, errno %d", errno);
+	CHECK(!listen(listen_fd, CLIENT_CNT), "listen failed, errno %d", errno);
+
+	if (check_failures)
+		return test_result("reactor_bench");
+
+	// Leaked on purpose: its detached threads wait on it until exit
+	reactor = new creactor;
+	CHECK(reactor->start(REACTOR_THREAD_CNT, REACTOR_WORKER_CNT), "reactor failed to start");
+	CHECK(reactor->add(listen_fd, accept_clients, NULL, (void *)(long)listen_fd), "failed to watch the listening socket");
+
+	rss_before = get_rss_kb();
+
+	for (int i = 0; i < CLIENT_CNT; ++i) {
+		start = now_ns();
+		clients[i] = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+		if (clients[i] < 0 || connect(clients[i], (struct sockaddr *)&addr, sizeof(addr)) ||
+			!round_trip(clients[i], CMD_ECHO)) {
+			CHECK(false, "client #%d failed to connect, errno %d", i, errno);
+			return test_result("reactor_bench");
+		}
+
+		connect_ns.push_back(now_ns() - start);
+	}
+
+	rss_after = get_rss_kb();
+
+	printf("connect + first reply, %d clients: p50 %llu us, p99 %llu us\n", CLIENT_CNT,
+		percentile(connect_ns, 0.5) / 1000, percentile(connect_ns, 0.99) / 1000);
+	printf("RSS: %ld kB before, %ld kB with %d clients, %.1f kB per connection\n",
+		rss_before, rss_after, CLIENT_CNT, (double)(rss_after - rss_before) / CLIENT_CNT);
+
+	start = now_ns();
+
+	for (int round = 0; ok && round < ROUNDS; ++round) {
+		char cmd = CMD_ECHO;
+		char reply;
+
+		for (int i = 0; i < CLIENT_CNT; ++i)
+			ok = ok && (send(clients[i], &cmd, 1, MSG_NOSIGNAL) == 1);
+
+		for (int i = 0; i < CLIENT_CNT; ++i)
+			ok = ok && (recv(clients[i], &reply, 1, 0) == 1);
+	}
+
+	CHECK(ok, "round trips failed");
+	printf("throughput: %.0f round trips/s over %d clients\n",
+		(double)ROUNDS * CLIENT_CNT * 1000000000ULL / (now_ns() - start), CLIENT_CNT);
+
+	// Blocking commands on the first clients while the last one echoes
+	for (int i = 0; i < BLOCKING_CLIENT_CNT; ++i) {
+		blockers.push_back(thread([&clients, i]() {
+			round_trip(clients[i], CMD_BLOCK);
+		}));
+	}
+
+	usleep(BLOCKING_TIME_US / 10);
+
+	for (int round = 0; round < STALL_ROUNDS; ++round) {
+		start = now_ns();
+		CHECK(round_trip(clients[CLIENT_CNT - 1], CMD_ECHO), "echo failed behind blocking commands");
+		stall_ns.push_back(now_ns() - start);
+	}
+
+	for (auto it = blockers.begin(); it != blockers.end(); ++it)
+		it->join();
+
+	printf("round trip beside %d blocking commands: p50 %llu us, max %llu us\n", BLOCKING_CLIENT_CNT,
+		percentile(stall_ns, 0.5) / 1000, percentile(stall_ns, 1.0) / 1000);
+
+	// Any round trip queued behind a blocking command takes a whole one
+	CHECK(percentile(stall_ns, 1.0) < BLOCKING_TIME_US * 1000ULL / 2,
+		"a round trip waited behind a blocking command");
+
+	for (int i = 0; i < CLIENT_CNT; ++i)
+		close(clients[i]);
+
+	return test_result("reactor_bench");
+}
@@ -0,0 +1,88 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <common.h>
+#include <sf_common.h>
+#include <sensor_base.h>
+#include <sensor_internal.h>
+
+/*
+ * Accelerometer, gyroscope and geomagnetic sensors with no HAL behind
+ * them, loaded by fusion_replay_test in place of the device plugins. They
+ * only give the virtual sensor graph its inputs; the test feeds the
+ * recorded samples to the dispatcher under their ids. Polled, they answer
+ * like a HAL that has no sample yet.
+ */
+class replay_sensor : public sensor_base {
+public:
+	replay_sensor(sensor_type_t type, unsigned int event_type, const char *name)
+	: m_type(type)
+	, m_event_type(event_type)
+	{
+		m_name = string(name);
+		register_supported_event(event_type);
+	}
+
+	sensor_type_t get_type(void)
+	{
+		return m_type;
+	}
+
+	bool get_properties(sensor_properties_t &properties)
+	{
+		properties.vendor = "REPLAY";
+		properties.name = m_name;
+		properties.min_range = -1000;
+		properties.max_range = 1000;
+		properties.resolution = 0.000001;
+		properties.fifo_count = 0;
+		properties.max_batch_count = 0;
+		properties.min_interval = 1;
+
+		return true;
+	}
+
+	int get_sensor_data(unsigned int type, sensor_data_t &data)
+	{
+		if (type != m_event_type)
+			return -1;
+
+		memset(&data, 0, sizeof(data));
+		return 0;
+	}
+
+private:
+	sensor_type_t m_type;
+	unsigned int m_event_type;
+};
+
+extern "C" sensor_module* create(void)
+{
+	sensor_module *module = new(std::nothrow) sensor_module;
+	retvm_if(!module, NULL, "Failed to allocate memory");
+
+	module->sensors.push_back(new replay_sensor(ACCELEROMETER_SENSOR,
+		ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME, "REPLAY_ACCEL"));
+	module->sensors.push_back(new replay_sensor(GYROSCOPE_SENSOR,
+		GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME, "REPLAY_GYRO"));
+	module->sensors.push_back(new replay_sensor(GEOMAGNETIC_SENSOR,
+		GEOMAGNETIC_EVENT_RAW_DATA_REPORT_ON_TIME, "REPLAY_GEOMAGNETIC"));
+
+	return module;
+}
@@ -0,0 +1,240 @@
+/*
+ * sensord
+ *
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <resampler.h>
+#include <bench_util.h>
+
+/*
+ * Checks resampler<> on a hand-built input sequence: passthrough of the
+ * first input and of one after a gap, the output grid between inputs,
+ * the RESAMPLER_MAX_OUTPUTS bound, and linear interpolation of the vector
+ * outputs used by gravity and linear acceleration. Checks slerp() on
+ * both sides of its nlerp threshold and across the quaternion sign flip.
+ */
+
+static const unsigned long long START_TIME = 1000000;
+static const unsigned long long INTERVAL = 10000;
+
+/* Radians; float rounding of a normalized quaternion */
+static const double ANGLE_TOLERANCE = 1e-5;
+static const float LERP_TOLERANCE = 1e-6;
+
+static quaternion<float> z_rotation(double angle)
+{
+	return quaternion<float>(cos(angle / 2), 0, 0, sin(angle / 2));
+}
+
+/* Rotation angle between two attitudes, the same for q and -q */
+static double angle_between(const quaternion<float> &q1, const quaternion<float> &q2)
+{
+	double dot = 0, diff = 0, sum = 0;
+
+	for (int i = 0; i < QUAT_SIZE; ++i) {
+		dot += (double)q1.m_quat.m_vec[i] * q2.m_quat.m_vec[i];
+		diff += ((double)q1.m_quat.m_vec[i] - q2.m_quat.m_vec[i]) * ((double)q1.m_quat.m_vec[i] - q2.m_quat.m_vec[i]);
+		sum += ((double)q1.m_quat.m_vec[i] + q2.m_quat.m_vec[i]) * ((double)q1.m_quat.m_vec[i] + q2.m_quat.m_vec[i]);
+	}
+
+	return 4.0 * asin(std::min(1.0, sqrt(dot >= 0 ? diff : sum) / 2.0));
+}
+
+static vect<float, 3> make_vect(float x, float y, float z)
+{
+	float data[3] = {x, y, z};
+
+	return vect<float, 3>(data);
+}
+
+static void check_slerp(void)
+{
+	const float ts[] = {0, 0.1f, 0.25f, 0.5f, 0.9f, 1};
+	const int T_CNT = sizeof(ts) / sizeof(ts[0]);
+
+	/* Far from the threshold: constant angular rate along the arc */
+	quaternion<float> q1 = z_rotation(0.3), q2 = z_rotation(1.5);
+
+	for (int i = 0; i < T_CNT; ++i) {
+		quaternion<float> q = slerp(q1, q2, ts[i]);
+
+		CHECK(fabs(angle_between(q1, q) - ts[i] * 1.2) <= ANGLE_TOLERANCE,
+			"slerp at t %.2f is %.6f rad from q1, expected %.6f", ts[i], angle_between(q1, q), ts[i] * 1.2);
+		CHECK(fabs(angle_between(q, q2) - (1 - ts[i]) * 1.2) <= ANGLE_TOLERANCE,
+			"slerp at t %.2f is %.6f rad from q2", ts[i], angle_between(q, q2));
+	}
+
+	/* Dot above 0.9995: the normalized linear blend, bit for bit */
+	q2 = z_rotation(0.32);
+
+	for (int i = 0; i < T_CNT; ++i) {
+		quaternion<float> q = slerp(q1, q2, ts[i]);
+		quaternion<float> nlerp(q1.m_quat * (1 - ts[i]) + q2.m_quat * ts[i]);
+
+		nlerp.quat_normalize();
+
+		CHECK(q.m_quat == nlerp.m_quat, "slerp at t %.2f and dot above the threshold is not nlerp", ts[i]);
+		CHECK(fabs(angle_between(q1, q) - ts[i] * 0.02) <= ANGLE_TOLERANCE,
+			"nlerp at t %.2f is %.6f rad from q1, expected %.6f", ts[i], angle_between(q1, q), ts[i] * 0.02);
+	}
+
+	/* -q2 is the same attitude; the blend must take the short way to it */
+	q2 = z_rotation(2.5);
+	quaternion<float> neg_q2(q2.m_quat * -1.0f);
+
+	for (int i = 0; i < T_CNT; ++i) {
+		quaternion<float> q = slerp(q1, neg_q2, ts[i]);
+
+		CHECK(fabs(angle_between(q1, q) - ts[i] * 2.2) <= ANGLE_TOLERANCE,
+			"slerp to -q2 at t %.2f is %.6f rad from q1, expected %.6f", ts[i], angle_between(q1, q), ts[i] * 2.2);
+		CHECK(angle_between(q, slerp(q1, q2, ts[i])) <= ANGLE_TOLERANCE,
+			"slerp to -q2 at t %.2f differs from slerp to q2", ts[i]);
+	}
+
+	/* Same, under the nlerp threshold, where skipping the flip would cancel the blend out */
+	q2 = z_rotation(0.32);
+	neg_q2 = quaternion<float>(q2.m_quat * -1.0f);
+
+	quaternion<float> q = slerp(q1, neg_q2, 0.5f);
+
+	CHECK(fabs(angle_between(q1, q) - 0.01) <= ANGLE_TOLERANCE,
+		"nlerp to -q2 at t 0.5 is %.6f rad from q1, expected 0.01", angle_between(q1, q));
+}
+
+static void check_quaternion_resampler(void)
+{
+	resampler<float, quaternion<float> > rs;
+	quaternion<float> outs[RESAMPLER_MAX_OUTPUTS + 1];
+	unsigned long long out_times[RESAMPLER_MAX_OUTPUTS + 1];
+	quaternion<float> q0 = z_rotation(0), q1 = z_rotation(0.4);
+	unsigned long long time = START_TIME;
+	int cnt;
+
+	/* The first input is passed through and starts the grid */
+	cnt = rs.resample(q0, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 1 && out_times[0] == time && outs[0].m_quat == q0.m_quat,
+		"first input: %d outputs, expected it passed through", cnt);
+
+	/* Two intervals later: one output halfway along the arc, one on the input */
+	time += 2 * INTERVAL;
+	cnt = rs.resample(q1, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 2, "two intervals: %d outputs, expected 2", cnt);
+
+	if (cnt == 2) {
+		CHECK(out_times[0] == START_TIME + INTERVAL && out_times[1] == time,
+			"two intervals: outputs at %llu, %llu us", out_times[0], out_times[1]);
+		CHECK(fabs(angle_between(q0, outs[0]) - 0.2) <= ANGLE_TOLERANCE,
+			"two intervals: first output %.6f rad from q0, expected 0.2", angle_between(q0, outs[0]));
+		CHECK(angle_between(q1, outs[1]) <= ANGLE_TOLERANCE,
+			"two intervals: last output %.6f rad from the input", angle_between(q1, outs[1]));
+	}
+
+	/* A repeated or older timestamp produces nothing */
+	cnt = rs.resample(q0, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 0, "repeated timestamp: %d outputs", cnt);
+	cnt = rs.resample(q0, time - 1, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 0, "older timestamp: %d outputs", cnt);
+
+	/* Exactly RESAMPLER_MAX_OUTPUTS intervals: the full grid, nothing written past it */
+	unsigned long long last_out = time;
+
+	out_times[RESAMPLER_MAX_OUTPUTS] = 0;
+	time += RESAMPLER_MAX_OUTPUTS * INTERVAL;
+	cnt = rs.resample(q0, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == RESAMPLER_MAX_OUTPUTS, "%d intervals: %d outputs", RESAMPLER_MAX_OUTPUTS, cnt);
+	CHECK(out_times[RESAMPLER_MAX_OUTPUTS] == 0, "output written past max_outs");
+
+	for (int i = 0; i < cnt; ++i) {
+		CHECK(out_times[i] == last_out + (i + 1) * INTERVAL, "%d intervals: output %d at %llu us",
+			RESAMPLER_MAX_OUTPUTS, i, out_times[i]);
+	}
+
+	/* A caller's smaller bound is honored the same way */
+	last_out = time;
+	time += 2 * INTERVAL;
+	cnt = rs.resample(q1, time, INTERVAL, outs, out_times, 2);
+	CHECK(cnt == 2 && out_times[0] == last_out + INTERVAL && out_times[1] == time,
+		"two intervals with max_outs 2: %d outputs", cnt);
+
+	/* One microsecond more than the bound is a gap: passed through, grid restarted on it */
+	time += RESAMPLER_MAX_OUTPUTS * INTERVAL + 1;
+	cnt = rs.resample(q1, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 1 && out_times[0] == time && outs[0].m_quat == q1.m_quat,
+		"gap: %d outputs, expected the input passed through", cnt);
+
+	time += INTERVAL;
+	cnt = rs.resample(q0, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 1 && out_times[0] == time, "after a gap: %d outputs, first at %llu us, expected %llu",
+		cnt, out_times[0], time);
+
+	/* After reset() the next input is a first input again */
+	rs.reset();
+	cnt = rs.resample(q1, time + INTERVAL / 2, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 1 && out_times[0] == time + INTERVAL / 2, "after reset: %d outputs", cnt);
+
+	/* Between inputs slower than the grid, every output lies on the arc at its own time */
+	rs.reset();
+	time = START_TIME;
+	rs.resample(q0, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	time += 3 * INTERVAL;
+	cnt = rs.resample(q1, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 3, "three intervals: %d outputs", cnt);
+
+	for (int i = 0; i < cnt; ++i) {
+		CHECK(fabs(angle_between(q0, outs[i]) - 0.4 * (i + 1) / 3) <= ANGLE_TOLERANCE,
+			"three intervals: output %d %.6f rad from q0, expected %.6f", i, angle_between(q0, outs[i]),
+			0.4 * (i + 1) / 3);
+	}
+}
+
+static void check_vector_resampler(void)
+{
+	resampler<float, vect<float, 3> > rs;
+	vect<float, 3> outs[RESAMPLER_MAX_OUTPUTS];
+	unsigned long long out_times[RESAMPLER_MAX_OUTPUTS];
+	vect<float, 3> v0 = make_vect(0, 0, 9.80665f), v1 = make_vect(1.5f, -3, -9.80665f);
+	unsigned long long time = START_TIME;
+	int cnt;
+
+	cnt = rs.resample(v0, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 1 && outs[0] == v0, "first vector: %d outputs, expected it passed through", cnt);
+
+	/* Plain lerp, not renormalized: a gravity vector passing near zero stays on the segment */
+	time += 4 * INTERVAL;
+	cnt = rs.resample(v1, time, INTERVAL, outs, out_times, RESAMPLER_MAX_OUTPUTS);
+	CHECK(cnt == 4, "four intervals: %d vector outputs", cnt);
+
+	for (int i = 0; i < cnt; ++i) {
+		float t = (float)(i + 1) / 4;
+
+		for (int j = 0; j < 3; ++j) {
+			float expected = v0.m_vec[j] * (1 - t) + v1.m_vec[j] * t;
+
+			CHECK(fabs(outs[i].m_vec[j] - expected) <= LERP_TOLERANCE * (1 + fabs(expected)),
+				"vector output %d axis %d is %.7f, expected %.7f", i, j, outs[i].m_vec[j], expected);
+		}
+	}
+}
+
+int main(void)
+{
+	check_slerp();
+	check_quaternion_resampler();
+	check_vector_resampler();
+
+	return test_result("resampler_test");
+}